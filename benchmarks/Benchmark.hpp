@@ -0,0 +1,358 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#ifndef APPLEDORE_REVISION
+#define APPLEDORE_REVISION "unknown"
+#endif
+#ifndef APPLEDORE_BUILD_TYPE
+#define APPLEDORE_BUILD_TYPE "unknown"
+#endif
+
+// Small self-contained benchmark harness. Besides timing it replaces the global
+// allocation functions to count heap traffic, so it must be included by exactly one
+// translation unit of an executable.
+namespace Appledore::bench
+{
+    namespace detail
+    {
+        // Every block carries its size in front so that unsized delete can keep the live
+        // byte count. The header is max_align_t wide to keep the returned pointer aligned.
+        struct alignas(std::max_align_t) BlockHeader
+        {
+            size_t size;
+        };
+        inline constexpr size_t headerSize = sizeof(BlockHeader);
+
+        struct AllocationCounters
+        {
+            std::atomic<size_t> bytes{0};
+            std::atomic<size_t> count{0};
+            std::atomic<size_t> live{0};
+            std::atomic<size_t> peak{0};
+        };
+
+        inline AllocationCounters counters;
+
+        // The block and the user pointer are converted through uintptr_t. Once these
+        // functions are inlined into operator new/delete, pointer arithmetic back from the
+        // user pointer makes GCC report -Warray-bounds and -Wmismatched-new-delete on
+        // callers, since it cannot see that the pointer came from malloc.
+        inline void *userPointer(BlockHeader *block) noexcept
+        {
+            return reinterpret_cast<void *>(reinterpret_cast<std::uintptr_t>(block) + headerSize);
+        }
+
+        inline BlockHeader *blockOf(void *ptr) noexcept
+        {
+            return reinterpret_cast<BlockHeader *>(reinterpret_cast<std::uintptr_t>(ptr) - headerSize);
+        }
+
+        inline void *allocate(size_t size) noexcept
+        {
+            auto *block = static_cast<BlockHeader *>(std::malloc(size + headerSize));
+            if (!block)
+                return nullptr;
+            block->size = size;
+
+            counters.bytes.fetch_add(size, std::memory_order_relaxed);
+            counters.count.fetch_add(1, std::memory_order_relaxed);
+            size_t live = counters.live.fetch_add(size, std::memory_order_relaxed) + size;
+            size_t peak = counters.peak.load(std::memory_order_relaxed);
+            while (live > peak && !counters.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {
+            }
+            return userPointer(block);
+        }
+
+        inline void release(void *ptr) noexcept
+        {
+            if (!ptr)
+                return;
+            BlockHeader *block = blockOf(ptr);
+            counters.live.fetch_sub(block->size, std::memory_order_relaxed);
+            std::free(block);
+        }
+
+        inline std::string jsonEscape(const std::string &text)
+        {
+            std::string out;
+            for (char ch : text)
+            {
+                if (ch == '"' || ch == '\\')
+                {
+                    out += '\\';
+                    out += ch;
+                }
+                else if (static_cast<unsigned char>(ch) < 0x20)
+                {
+                    char code[8];
+                    std::snprintf(code, sizeof(code), "\\u%04x", ch);
+                    out += code;
+                }
+                else
+                {
+                    out += ch;
+                }
+            }
+            return out;
+        }
+    }
+
+    // Keeps the compiler from discarding a result that is otherwise unused.
+    template <typename T>
+    inline void doNotOptimize(const T &value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    // Peak resident set size of the process so far, in KiB. It only ever grows, so for a
+    // single benchmark it is an upper bound set by the largest case run before it.
+    inline size_t peakRssKiB()
+    {
+#if defined(__APPLE__)
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<size_t>(usage.ru_maxrss) / 1024;
+#elif defined(__unix__)
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return 0;
+#endif
+    }
+
+    using Params = std::vector<std::pair<std::string, std::string>>;
+
+    struct Options
+    {
+        std::string filter;   // run only benchmarks whose name contains this
+        std::string jsonPath; // write results here, "-" for stdout
+        double minTime = 0.1; // seconds of measured time per benchmark
+        bool quick = false;   // a reduced matrix of sizes, for smoke runs
+    };
+
+    // Parses --filter <text>, --json <path>, --min-time <seconds> and --quick. Throws
+    // std::invalid_argument on anything else.
+    inline Options parseOptions(int argc, char *argv[])
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string
+            {
+                if (i + 1 >= argc)
+                {
+                    throw std::invalid_argument("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--filter")
+                options.filter = value();
+            else if (arg == "--json")
+                options.jsonPath = value();
+            else if (arg == "--min-time")
+                options.minTime = std::stod(value());
+            else if (arg == "--quick")
+                options.quick = true;
+            else
+                throw std::invalid_argument("Unknown option " + arg);
+        }
+        if (options.quick && options.minTime == Options{}.minTime)
+        {
+            options.minTime = 0.01;
+        }
+        return options;
+    }
+
+    struct Result
+    {
+        std::string name;
+        Params params;
+        size_t samples = 0;
+        size_t operations = 0;
+        double nsPerOp = 0;
+        double bytesPerOp = 0;
+        double allocationsPerOp = 0;
+        size_t peakHeapBytes = 0; // largest heap growth within one sample
+        size_t peakRssKiB = 0;
+    };
+
+    class Runner
+    {
+    public:
+        explicit Runner(Options options) : options(std::move(options))
+        {
+            // Human readable table on stdout, unless stdout carries the JSON.
+            if (this->options.jsonPath != "-")
+            {
+                std::cout << std::left << std::setw(72) << "benchmark" << std::right
+                          << std::setw(12) << "ns/op" << std::setw(12) << "B/op"
+                          << std::setw(10) << "allocs/op" << std::setw(14) << "peak heap B"
+                          << std::setw(12) << "RSS KiB" << "\n";
+            }
+        }
+
+        [[nodiscard]] bool quick() const { return options.quick; }
+
+        [[nodiscard]] bool selected(const std::string &name) const
+        {
+            return name.find(options.filter) != std::string::npos;
+        }
+
+        // Calls setup() untimed for a fresh state, then times body(state), which returns
+        // the number of operations it performed. Samples repeat until minTime seconds have
+        // been measured, or five times that has passed including setup.
+        template <typename Setup, typename Body>
+        void run(const std::string &name, const Params &params, Setup &&setup, Body &&body)
+        {
+            if (!selected(name))
+                return;
+
+            using Clock = std::chrono::steady_clock;
+            const auto budget = std::chrono::duration<double>(options.minTime);
+            const auto started = Clock::now();
+            Clock::duration measured{};
+            Result result{name, params};
+            size_t bytes = 0, allocations = 0;
+
+            do
+            {
+                auto state = setup();
+                size_t bytesBefore = detail::counters.bytes.load(std::memory_order_relaxed);
+                size_t countBefore = detail::counters.count.load(std::memory_order_relaxed);
+                size_t liveBefore = detail::counters.live.load(std::memory_order_relaxed);
+                detail::counters.peak.store(liveBefore, std::memory_order_relaxed);
+
+                auto begin = Clock::now();
+                size_t operations = body(state);
+                auto end = Clock::now();
+                doNotOptimize(state);
+
+                measured += end - begin;
+                result.operations += operations;
+                bytes += detail::counters.bytes.load(std::memory_order_relaxed) - bytesBefore;
+                allocations += detail::counters.count.load(std::memory_order_relaxed) - countBefore;
+                result.peakHeapBytes = std::max(result.peakHeapBytes,
+                                                detail::counters.peak.load(std::memory_order_relaxed) - liveBefore);
+                ++result.samples;
+            } while (measured < budget && Clock::now() - started < 5 * budget);
+
+            double operations = static_cast<double>(std::max<size_t>(result.operations, 1));
+            result.nsPerOp = std::chrono::duration<double, std::nano>(measured).count() / operations;
+            result.bytesPerOp = static_cast<double>(bytes) / operations;
+            result.allocationsPerOp = static_cast<double>(allocations) / operations;
+            result.peakRssKiB = peakRssKiB();
+            report(result);
+            results.push_back(std::move(result));
+        }
+
+        // Writes the JSON report if one was requested.
+        void finish() const
+        {
+            if (options.jsonPath.empty())
+                return;
+            if (options.jsonPath == "-")
+            {
+                writeJson(std::cout);
+                return;
+            }
+            std::ofstream file(options.jsonPath);
+            if (!file)
+            {
+                throw std::runtime_error("Cannot open " + options.jsonPath);
+            }
+            writeJson(file);
+        }
+
+    private:
+        Options options;
+        std::vector<Result> results;
+
+        void report(const Result &result) const
+        {
+            if (options.jsonPath == "-")
+                return;
+            std::cout << std::left << std::setw(72) << result.name << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(12) << result.nsPerOp
+                      << std::setw(12) << result.bytesPerOp << std::setprecision(2)
+                      << std::setw(10) << result.allocationsPerOp << std::setw(14)
+                      << result.peakHeapBytes << std::setw(12) << result.peakRssKiB << "\n";
+        }
+
+        // One object per benchmark, keyed by name, so two runs can be joined on it.
+        void writeJson(std::ostream &out) const
+        {
+            std::time_t now = std::time(nullptr);
+            char date[32];
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+            out << "{\n  \"context\": {\n"
+                << "    \"revision\": \"" << detail::jsonEscape(APPLEDORE_REVISION) << "\",\n"
+                << "    \"build_type\": \"" << detail::jsonEscape(APPLEDORE_BUILD_TYPE) << "\",\n"
+                << "    \"compiler\": \"" << detail::jsonEscape(__VERSION__) << "\",\n"
+                << "    \"date\": \"" << date << "\",\n"
+                << "    \"min_time\": " << options.minTime << ",\n"
+                << "    \"quick\": " << (options.quick ? "true" : "false") << "\n  },\n"
+                << "  \"benchmarks\": [";
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                const Result &result = results[i];
+                out << (i ? ",\n" : "\n") << "    {\"name\": \"" << detail::jsonEscape(result.name) << "\", \"params\": {";
+                for (size_t p = 0; p < result.params.size(); ++p)
+                {
+                    out << (p ? ", " : "") << "\"" << detail::jsonEscape(result.params[p].first) << "\": \""
+                        << detail::jsonEscape(result.params[p].second) << "\"";
+                }
+                out << "}, \"samples\": " << result.samples
+                    << ", \"operations\": " << result.operations
+                    << std::setprecision(6) << std::defaultfloat
+                    << ", \"ns_per_op\": " << result.nsPerOp
+                    << ", \"bytes_per_op\": " << result.bytesPerOp
+                    << ", \"allocations_per_op\": " << result.allocationsPerOp
+                    << ", \"peak_heap_bytes\": " << result.peakHeapBytes
+                    << ", \"peak_rss_kib\": " << result.peakRssKiB << "}";
+            }
+            out << "\n  ]\n}\n";
+        }
+    };
+}
+
+// Replaceable global allocation functions, counting into detail::counters. The aligned
+// overloads are left alone, nothing in the library allocates over-aligned types.
+void *operator new(std::size_t size)
+{
+    if (void *ptr = Appledore::bench::detail::allocate(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t size) { return ::operator new(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return Appledore::bench::detail::allocate(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return Appledore::bench::detail::allocate(size); }
+void operator delete(void *ptr) noexcept { Appledore::bench::detail::release(ptr); }
+void operator delete[](void *ptr) noexcept { Appledore::bench::detail::release(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { Appledore::bench::detail::release(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { Appledore::bench::detail::release(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { Appledore::bench::detail::release(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { Appledore::bench::detail::release(ptr); }
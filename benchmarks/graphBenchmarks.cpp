@@ -0,0 +1,690 @@
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Benchmark.hpp"
+#include "../include/GraphGenerators.hpp"
+#include "../include/GraphMatrix.hpp"
+#include "../include/MixedGraph.hpp"
+#include "../include/MixedGraphSearch.hpp"
+
+// Measures the public API of GraphMatrix and MixedGraphMatrix across vertex counts,
+// densities, edge types and directions. Every workload is generated from a fixed seed,
+// so two builds see identical graphs and their JSON reports can be compared by name.
+//
+//   graphBenchmarks --quick
+//   graphBenchmarks --filter "GraphMatrix<int,double,DirectedG>" --json before.json
+
+using namespace Appledore;
+using bench::Params;
+using bench::Runner;
+
+namespace
+{
+    // Vertex with a payload that is expensive to copy, ordered by its GraphVertex id.
+    struct HeavyVertex : GraphVertex
+    {
+        std::array<double, 16> features{};
+        std::string label;
+
+        explicit HeavyVertex(size_t i) : label("benchmark-vertex-" + std::to_string(i))
+        {
+            features.fill(static_cast<double>(i));
+        }
+    };
+
+    template <typename T>
+    constexpr const char *typeName()
+    {
+        if constexpr (std::is_same_v<T, int>)
+            return "int";
+        else if constexpr (std::is_same_v<T, double>)
+            return "double";
+        else if constexpr (std::is_same_v<T, bool>)
+            return "bool";
+        else if constexpr (std::is_same_v<T, UnweightedG>)
+            return "UnweightedG";
+        else if constexpr (std::is_same_v<T, HeavyVertex>)
+            return "HeavyVertex";
+        else if constexpr (std::is_same_v<T, DirectedG>)
+            return "DirectedG";
+        else
+            return "UndirectedG";
+    }
+
+    std::string format(double value)
+    {
+        std::ostringstream out;
+        out << value;
+        return out.str();
+    }
+
+    template <typename VertexType>
+    std::vector<VertexType> makeVertices(size_t count)
+    {
+        std::vector<VertexType> vertices;
+        vertices.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if constexpr (std::is_same_v<VertexType, HeavyVertex>)
+                vertices.emplace_back(i);
+            else
+                vertices.push_back(static_cast<VertexType>(i));
+        }
+        return vertices;
+    }
+
+    template <typename EdgeType>
+    EdgeType makeValue(std::mt19937_64 &rng)
+    {
+        if constexpr (std::is_same_v<EdgeType, int>)
+            return std::uniform_int_distribution<int>(1, 100)(rng);
+        else if constexpr (std::is_same_v<EdgeType, double>)
+            return std::uniform_real_distribution<double>(0.1, 10.0)(rng);
+        else if constexpr (std::is_same_v<EdgeType, bool>)
+            return true;
+        else
+            return EdgeType{};
+    }
+
+    // G(n, p) edges from erdosRenyiGraph, undirected graphs only get pairs with src < dest.
+    // probes mixes existing edges with uniformly random pairs.
+    struct Workload
+    {
+        std::vector<std::pair<size_t, size_t>> edges;
+        std::vector<std::pair<size_t, size_t>> probes;
+        std::vector<bool> directed; // per edge, for mixed graphs
+        std::vector<size_t> victims; // every eighth vertex, for removal
+    };
+
+    constexpr size_t probeCount = 4096;
+
+    Workload makeWorkload(size_t numVertices, double density, bool undirected, double directedShare, uint64_t seed)
+    {
+        Workload workload;
+        for (const auto &edge : erdosRenyiGraph(numVertices, density, !undirected, {.seed = seed}).edges)
+        {
+            workload.edges.emplace_back(edge.src, edge.dest);
+        }
+        std::mt19937_64 rng(seed);
+        std::shuffle(workload.edges.begin(), workload.edges.end(), rng);
+        std::bernoulli_distribution orient(directedShare);
+        for (size_t i = 0; i < workload.edges.size(); ++i)
+        {
+            workload.directed.push_back(orient(rng));
+        }
+
+        std::uniform_int_distribution<size_t> pick(0, numVertices - 1);
+        for (size_t i = 0; i < probeCount; ++i)
+        {
+            if (i % 2 == 0 && !workload.edges.empty())
+                workload.probes.push_back(workload.edges[pick(rng) % workload.edges.size()]);
+            else
+                workload.probes.emplace_back(pick(rng), pick(rng));
+        }
+        for (size_t v = 0; v < numVertices; v += 8)
+        {
+            workload.victims.push_back(v);
+        }
+        return workload;
+    }
+
+    uint64_t seedFor(size_t numVertices, double density)
+    {
+        return numVertices * 1000003 + static_cast<uint64_t>(density * 1000);
+    }
+
+    template <typename VertexType, typename EdgeType, typename Direction>
+    void benchGraphMatrix(Runner &runner, const std::vector<size_t> &sizes, const std::vector<double> &densities)
+    {
+        using Graph = GraphMatrix<VertexType, EdgeType, Direction>;
+        constexpr bool directed = std::is_same_v<Direction, DirectedG>;
+        constexpr bool weighted = !std::is_same_v<EdgeType, UnweightedG>;
+        const std::string type = std::string("GraphMatrix<") + typeName<VertexType>() + "," +
+                                 typeName<EdgeType>() + "," + typeName<Direction>() + ">";
+
+        for (size_t n : sizes)
+        {
+            const std::vector<VertexType> vertices = makeVertices<VertexType>(n);
+            Params base{{"graph", "GraphMatrix"},
+                        {"vertex", typeName<VertexType>()},
+                        {"edge", typeName<EdgeType>()},
+                        {"direction", typeName<Direction>()},
+                        {"vertices", std::to_string(n)}};
+            const std::string prefix = type + "/V=" + std::to_string(n);
+            Graph empty;
+            empty.addVertices(vertices);
+            // handles stay valid in the copies the benchmarks run on.
+            std::vector<VertexHandle> handles;
+            for (const VertexType &vertex : vertices)
+                handles.push_back(empty.handleOf(vertex));
+
+            runner.run(prefix + "/addVertex", base, []
+                       { return Graph(); }, [&](Graph &graph)
+                       {
+                           for (const VertexType &vertex : vertices)
+                               graph.addVertex(vertex);
+                           return n; });
+
+            for (double density : densities)
+            {
+                const Workload workload = makeWorkload(n, density, !directed, 0.0, seedFor(n, density));
+                std::mt19937_64 rng(seedFor(n, density));
+                std::vector<EdgeType> values;
+                for (size_t i = 0; i < workload.edges.size(); ++i)
+                {
+                    values.push_back(makeValue<EdgeType>(rng));
+                }
+                const size_t numEdges = workload.edges.size();
+                Params params = base;
+                params.emplace_back("density", format(density));
+                params.emplace_back("edges", std::to_string(numEdges));
+                const std::string name = prefix + "/d=" + format(density) + "/";
+
+                auto fill = [&](Graph &graph)
+                {
+                    for (size_t i = 0; i < numEdges; ++i)
+                    {
+                        const auto &[src, dest] = workload.edges[i];
+                        if constexpr (weighted)
+                            graph.addEdge(vertices[src], vertices[dest], values[i]);
+                        else
+                            graph.addEdge(vertices[src], vertices[dest]);
+                    }
+                    return numEdges;
+                };
+                // built on first use, so a filtered run only builds what it measures.
+                std::optional<Graph> built;
+                auto graph = [&]() -> Graph &
+                {
+                    if (!built)
+                    {
+                        built = empty;
+                        fill(*built);
+                    }
+                    return *built;
+                };
+                auto shared = [&]
+                { return &graph(); };
+                auto copy = [&]
+                { return graph(); };
+
+                runner.run(name + "addEdge", params, [&]
+                           { return empty; }, fill);
+
+                runner.run(name + "hasEdge", params, shared, [&](Graph *g)
+                           {
+                               size_t hits = 0;
+                               for (const auto &[src, dest] : workload.probes)
+                                   hits += g->hasEdge(vertices[src], vertices[dest]);
+                               bench::doNotOptimize(hits);
+                               return workload.probes.size(); });
+
+                runner.run(name + "hasEdge.handle", params, shared, [&](Graph *g)
+                           {
+                               size_t hits = 0;
+                               for (const auto &[src, dest] : workload.probes)
+                                   hits += g->hasEdge(handles[src], handles[dest]);
+                               bench::doNotOptimize(hits);
+                               return workload.probes.size(); });
+
+                runner.run(name + "operator()", params, shared, [&](Graph *g)
+                           {
+                               size_t hits = 0;
+                               for (const auto &[src, dest] : workload.probes)
+                                   hits += (*g)(vertices[src], vertices[dest]);
+                               bench::doNotOptimize(hits);
+                               return workload.probes.size(); });
+
+                if constexpr (weighted)
+                {
+                    runner.run(name + "getEdge", params, shared, [&](Graph *g)
+                               {
+                                   for (const auto &[src, dest] : workload.edges)
+                                       bench::doNotOptimize(g->getEdge(vertices[src], vertices[dest]));
+                                   return numEdges; });
+
+                    runner.run(name + "updateEdge", params, shared, [&](Graph *g)
+                               {
+                                   for (size_t i = 0; i < numEdges; ++i)
+                                       g->updateEdge(vertices[workload.edges[i].first], vertices[workload.edges[i].second], values[i]);
+                                   return numEdges; });
+
+                    // probing for edges that may be missing: exceptions against the try API.
+                    runner.run(name + "getEdge.probe", params, shared, [&](Graph *g)
+                               {
+                                   size_t hits = 0;
+                                   for (const auto &[src, dest] : workload.probes)
+                                   {
+                                       try
+                                       {
+                                           bench::doNotOptimize(g->getEdge(vertices[src], vertices[dest]));
+                                           ++hits;
+                                       }
+                                       catch (const std::runtime_error &)
+                                       {
+                                       }
+                                   }
+                                   bench::doNotOptimize(hits);
+                                   return workload.probes.size(); });
+
+                    runner.run(name + "findEdge.probe", params, shared, [&](Graph *g)
+                               {
+                                   size_t hits = 0;
+                                   for (const auto &[src, dest] : workload.probes)
+                                       hits += g->findEdge(vertices[src], vertices[dest]) != nullptr;
+                                   bench::doNotOptimize(hits);
+                                   return workload.probes.size(); });
+                }
+
+                runner.run(name + "removeEdge", params, copy, [&](Graph &g)
+                           {
+                               for (const auto &[src, dest] : workload.edges)
+                                   g.removeEdge(vertices[src], vertices[dest]);
+                               return numEdges; });
+
+                runner.run(name + "indegree", params, shared, [&](Graph *g)
+                           {
+                               size_t sum = 0;
+                               for (const VertexType &vertex : vertices)
+                                   sum += g->indegree(vertex);
+                               bench::doNotOptimize(sum);
+                               return n; });
+
+                runner.run(name + "outdegree", params, shared, [&](Graph *g)
+                           {
+                               size_t sum = 0;
+                               for (const VertexType &vertex : vertices)
+                                   sum += g->outdegree(vertex);
+                               bench::doNotOptimize(sum);
+                               return n; });
+
+                runner.run(name + "totalDegree", params, shared, [&](Graph *g)
+                           {
+                               size_t sum = 0;
+                               for (const VertexType &vertex : vertices)
+                                   sum += g->totalDegree(vertex);
+                               bench::doNotOptimize(sum);
+                               return n; });
+
+                runner.run(name + "getNeighbors", params, shared, [&](Graph *g)
+                           {
+                               for (const VertexType &vertex : vertices)
+                                   bench::doNotOptimize(g->getNeighbors(vertex));
+                               return n; });
+
+                runner.run(name + "density", params, shared, [&](Graph *g)
+                           {
+                               bench::doNotOptimize(g->density());
+                               return size_t{1}; });
+
+                runner.run(name + "isConnected", params, shared, [&](Graph *g)
+                           {
+                               bench::doNotOptimize(g->isConnected());
+                               return size_t{1}; });
+
+                runner.run(name + "getIsolated", params, shared, [&](Graph *g)
+                           {
+                               bench::doNotOptimize(g->getIsolated());
+                               return size_t{1}; });
+
+                runner.run(name + "removeVertex", params, copy, [&](Graph &g)
+                           {
+                               for (size_t v : workload.victims)
+                                   g.removeVertex(vertices[v]);
+                               return workload.victims.size(); });
+
+                // ns/op is per removed vertex, comparable with removeVertex above.
+                runner.run(name + "removeVertices", params, copy, [&](Graph &g)
+                           {
+                               std::vector<VertexType> victims;
+                               for (size_t v : workload.victims)
+                                   victims.push_back(vertices[v]);
+                               g.removeVertices(victims);
+                               return workload.victims.size(); });
+            }
+        }
+
+        // Path enumeration is exponential, it gets a small fixed graph of its own.
+        constexpr size_t pathVertices = 12;
+        const std::vector<VertexType> vertices = makeVertices<VertexType>(pathVertices);
+        const Workload workload = makeWorkload(pathVertices, 0.3, !directed, 0.0, 7);
+        Graph paths;
+        paths.addVertices(vertices);
+        std::mt19937_64 rng(7);
+        for (const auto &[src, dest] : workload.edges)
+        {
+            if constexpr (weighted)
+                paths.addEdge(vertices[src], vertices[dest], makeValue<EdgeType>(rng));
+            else
+                paths.addEdge(vertices[src], vertices[dest]);
+        }
+        Params params{{"graph", "GraphMatrix"},
+                      {"vertex", typeName<VertexType>()},
+                      {"edge", typeName<EdgeType>()},
+                      {"direction", typeName<Direction>()},
+                      {"vertices", std::to_string(pathVertices)},
+                      {"density", "0.3"},
+                      {"edges", std::to_string(workload.edges.size())}};
+        const std::string name = type + "/V=" + std::to_string(pathVertices) + "/d=0.3/";
+
+        runner.run(name + "findAllPaths", params, [&]
+                   { return &paths; }, [&](Graph *g)
+                   {
+                       bench::doNotOptimize(g->findAllPaths(vertices.front(), vertices.back()));
+                       return size_t{1}; });
+
+        runner.run(name + "countPathsDFS", params, [&]
+                   { return &paths; }, [&](Graph *g)
+                   {
+                       bench::doNotOptimize(g->countPathsDFS(vertices.front(), vertices.back()));
+                       return size_t{1}; });
+    }
+
+    // directedShares is the fraction of edges added as directed edges.
+    template <typename VertexType, typename EdgeType>
+    void benchMixedGraph(Runner &runner, const std::vector<size_t> &sizes, const std::vector<double> &densities,
+                         const std::vector<double> &directedShares)
+    {
+        using Graph = MixedGraphMatrix<VertexType, EdgeType>;
+        using Search = MixedGraphSearch<VertexType, EdgeType>;
+        constexpr bool weighted = !std::is_same_v<EdgeType, bool>;
+        const std::string type = std::string("MixedGraphMatrix<") + typeName<VertexType>() + "," +
+                                 typeName<EdgeType>() + ">";
+
+        for (size_t n : sizes)
+        {
+            const std::vector<VertexType> vertices = makeVertices<VertexType>(n);
+            Params base{{"graph", "MixedGraphMatrix"},
+                        {"vertex", typeName<VertexType>()},
+                        {"edge", typeName<EdgeType>()},
+                        {"vertices", std::to_string(n)}};
+            const std::string prefix = type + "/V=" + std::to_string(n);
+            Graph empty;
+            empty.addVertices(vertices);
+            // handles stay valid in the copies the benchmarks run on.
+            std::vector<VertexHandle> handles;
+            for (const VertexType &vertex : vertices)
+                handles.push_back(empty.handleOf(vertex));
+
+            runner.run(prefix + "/addVertex", base, []
+                       { return Graph(); }, [&](Graph &graph)
+                       {
+                           for (const VertexType &vertex : vertices)
+                               graph.addVertex(vertex);
+                           return n; });
+
+            for (double density : densities)
+            {
+                for (double share : directedShares)
+                {
+                    const Workload workload = makeWorkload(n, density, true, share, seedFor(n, density));
+                    std::mt19937_64 rng(seedFor(n, density));
+                    std::vector<EdgeType> values;
+                    for (size_t i = 0; i < workload.edges.size(); ++i)
+                    {
+                        values.push_back(makeValue<EdgeType>(rng));
+                    }
+                    const size_t numEdges = workload.edges.size();
+                    Params params = base;
+                    params.emplace_back("density", format(density));
+                    params.emplace_back("directed_share", format(share));
+                    params.emplace_back("edges", std::to_string(numEdges));
+                    const std::string name = prefix + "/d=" + format(density) + "/directed=" + format(share) + "/";
+
+                    auto fill = [&](Graph &graph)
+                    {
+                        for (size_t i = 0; i < numEdges; ++i)
+                        {
+                            const auto &[src, dest] = workload.edges[i];
+                            if constexpr (weighted)
+                                graph.addEdge(vertices[src], vertices[dest], values[i], workload.directed[i]);
+                            else
+                                graph.addEdge(vertices[src], vertices[dest], std::nullopt, workload.directed[i]);
+                        }
+                        return numEdges;
+                    };
+                    std::optional<Graph> built;
+                    auto graph = [&]() -> Graph &
+                    {
+                        if (!built)
+                        {
+                            built = empty;
+                            fill(*built);
+                        }
+                        return *built;
+                    };
+                    // searches keep their buffers, so the timed queries run warm.
+                    std::optional<Search> searcher;
+                    auto search = [&]
+                    {
+                        if (!searcher)
+                            searcher.emplace(graph());
+                        return &*searcher;
+                    };
+                    auto shared = [&]
+                    { return &graph(); };
+                    auto copy = [&]
+                    { return graph(); };
+
+                    runner.run(name + "addEdge", params, [&]
+                               { return empty; }, fill);
+
+                    runner.run(name + "hasEdge", params, shared, [&](Graph *g)
+                               {
+                                   size_t hits = 0;
+                                   for (const auto &[src, dest] : workload.probes)
+                                       hits += g->hasEdge(vertices[src], vertices[dest]);
+                                   bench::doNotOptimize(hits);
+                                   return workload.probes.size(); });
+
+                    runner.run(name + "hasEdge.handle", params, shared, [&](Graph *g)
+                               {
+                                   size_t hits = 0;
+                                   for (const auto &[src, dest] : workload.probes)
+                                       hits += g->hasEdge(handles[src], handles[dest]);
+                                   bench::doNotOptimize(hits);
+                                   return workload.probes.size(); });
+
+                    if constexpr (weighted)
+                    {
+                        runner.run(name + "getEdgeValue", params, shared, [&](Graph *g)
+                                   {
+                                       for (const auto &[src, dest] : workload.edges)
+                                           bench::doNotOptimize(g->getEdgeValue(vertices[src], vertices[dest]));
+                                       return numEdges; });
+
+                        runner.run(name + "updateEdge", params, shared, [&](Graph *g)
+                                   {
+                                       for (size_t i = 0; i < numEdges; ++i)
+                                           g->updateEdge(vertices[workload.edges[i].first], vertices[workload.edges[i].second], values[i]);
+                                       return numEdges; });
+
+                        runner.run(name + "findEdge.probe", params, shared, [&](Graph *g)
+                                   {
+                                       size_t hits = 0;
+                                       for (const auto &[src, dest] : workload.probes)
+                                           hits += g->findEdge(vertices[src], vertices[dest]) != nullptr;
+                                       bench::doNotOptimize(hits);
+                                       return workload.probes.size(); });
+
+                        runner.run(name + "getEdges", params, shared, [&](Graph *g)
+                                   {
+                                       bench::doNotOptimize(g->getEdges());
+                                       return size_t{1}; });
+                    }
+
+                    runner.run(name + "removeEdge", params, copy, [&](Graph &g)
+                               {
+                                   for (const auto &[src, dest] : workload.edges)
+                                       g.removeEdge(vertices[src], vertices[dest]);
+                                   return numEdges; });
+
+                    runner.run(name + "indegree", params, shared, [&](Graph *g)
+                               {
+                                   size_t sum = 0;
+                                   for (const VertexType &vertex : vertices)
+                                       sum += g->indegree(vertex);
+                                   bench::doNotOptimize(sum);
+                                   return n; });
+
+                    runner.run(name + "outdegree", params, shared, [&](Graph *g)
+                               {
+                                   size_t sum = 0;
+                                   for (const VertexType &vertex : vertices)
+                                       sum += g->outdegree(vertex);
+                                   bench::doNotOptimize(sum);
+                                   return n; });
+
+                    runner.run(name + "totalDegree", params, shared, [&](Graph *g)
+                               {
+                                   size_t sum = 0;
+                                   for (const VertexType &vertex : vertices)
+                                       sum += g->totalDegree(vertex);
+                                   bench::doNotOptimize(sum);
+                                   return n; });
+
+                    runner.run(name + "removeVertex", params, copy, [&](Graph &g)
+                               {
+                                   for (size_t v : workload.victims)
+                                       g.removeVertex(vertices[v]);
+                                   return workload.victims.size(); });
+
+                    runner.run(name + "removeVertices", params, copy, [&](Graph &g)
+                               {
+                                   std::vector<VertexType> victims;
+                                   for (size_t v : workload.victims)
+                                       victims.push_back(vertices[v]);
+                                   g.removeVertices(victims);
+                                   return workload.victims.size(); });
+
+                    runner.run(name + "isMixedAcyclic", params, shared, [&](Graph *g)
+                               {
+                                   bench::doNotOptimize(g->isMixedAcyclic());
+                                   return size_t{1}; });
+
+                    runner.run(name + "acyclicOrientation", params, shared, [&](Graph *g)
+                               {
+                                   bench::doNotOptimize(g->acyclicOrientation());
+                                   return size_t{1}; });
+
+                    runner.run(name + "strongOrientation", params, shared, [&](Graph *g)
+                               {
+                                   bench::doNotOptimize(g->strongOrientation());
+                                   return size_t{1}; });
+
+                    runner.run(name + "bridges", params, shared, [&](Graph *g)
+                               {
+                                   bench::doNotOptimize(g->bridges());
+                                   return size_t{1}; });
+
+                    runner.run(name + "search.bfs", params, search, [&](Search *s)
+                               {
+                                   size_t visited = 0;
+                                   s->bfs(0, [&visited](size_t, size_t)
+                                          { ++visited; });
+                                   bench::doNotOptimize(visited);
+                                   return size_t{1}; });
+
+                    runner.run(name + "search.shortestDistances", params, search, [&](Search *s)
+                               {
+                                   bench::doNotOptimize(s->shortestDistances(0));
+                                   return size_t{1}; });
+                }
+            }
+        }
+    }
+
+    // Generation alone, and generation followed by addEdgeList into a graph.
+    void benchGenerators(Runner &runner, bool quick)
+    {
+        const size_t n = quick ? 1024 : 8192;
+        const unsigned scale = quick ? 10 : 13;
+        const size_t side = quick ? 32 : 90;
+        auto generators = std::vector<std::pair<std::string, std::function<EdgeList<int, double>()>>>{
+            {"erdosRenyiGraph", [=]
+             { return erdosRenyiGraph<int, double>(n, 8.0 / n, false, {.maxWeight = 10.0}); }},
+            {"randomDag", [=]
+             { return randomDag<int, double>(n, 16.0 / n, {.maxWeight = 10.0}); }},
+            {"rmatGraph", [=]
+             { return rmatGraph<int, double>(scale, 8, true, {}, {.maxWeight = 10.0}); }},
+            {"barabasiAlbertGraph", [=]
+             { return barabasiAlbertGraph<int, double>(n, 4, {.maxWeight = 10.0}); }},
+            {"gridGraph", [=]
+             { return gridGraph<int, double>(side, side, 0.9, 0.1, {.maxWeight = 10.0}); }},
+        };
+
+        for (const auto &[generator, generate] : generators)
+        {
+            const auto sample = generate();
+            Params params{{"generator", generator},
+                          {"vertices", std::to_string(sample.vertices.size())},
+                          {"edges", std::to_string(sample.edges.size())}};
+            const std::string name = "Generators/" + generator + "/V=" + std::to_string(sample.vertices.size()) + "/";
+
+            // ns/op is per generated edge.
+            runner.run(name + "generate", params, []
+                       { return 0; }, [&](int)
+                       {
+                           auto list = generate();
+                           bench::doNotOptimize(list);
+                           return list.edges.size(); });
+
+            runner.run(name + "addEdgeList<GraphMatrix>", params, []
+                       { return GraphMatrix<int, double, DirectedG>(); }, [&](GraphMatrix<int, double, DirectedG> &graph)
+                       {
+                           addEdgeList(graph, sample);
+                           return sample.edges.size(); });
+
+            runner.run(name + "addEdgeList<MixedGraphMatrix>", params, []
+                       { return MixedGraphMatrix<int, double>(); }, [&](MixedGraphMatrix<int, double> &graph)
+                       {
+                           addEdgeList(graph, sample);
+                           return sample.edges.size(); });
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    bench::Options options;
+    try
+    {
+        options = bench::parseOptions(argc, argv);
+    }
+    catch (const std::exception &error)
+    {
+        std::cerr << error.what() << "\n"
+                  << "Usage: " << argv[0] << " [--quick] [--filter <text>] [--min-time <seconds>] [--json <path>|-]\n";
+        return 1;
+    }
+
+    Runner runner(options);
+    const std::vector<size_t> sizes = runner.quick() ? std::vector<size_t>{128} : std::vector<size_t>{64, 256, 1024};
+    const std::vector<double> densities = runner.quick() ? std::vector<double>{0.1} : std::vector<double>{0.01, 0.1, 0.5};
+    const std::vector<double> directedShares = runner.quick() ? std::vector<double>{0.5} : std::vector<double>{0.0, 0.5, 1.0};
+
+    benchGraphMatrix<int, UnweightedG, DirectedG>(runner, sizes, densities);
+    benchGraphMatrix<int, UnweightedG, UndirectedG>(runner, sizes, densities);
+    benchGraphMatrix<int, int, DirectedG>(runner, sizes, densities);
+    benchGraphMatrix<int, int, UndirectedG>(runner, sizes, densities);
+    benchGraphMatrix<int, double, DirectedG>(runner, sizes, densities);
+    benchGraphMatrix<int, double, UndirectedG>(runner, sizes, densities);
+    benchGraphMatrix<HeavyVertex, int, DirectedG>(runner, sizes, densities);
+    benchGraphMatrix<HeavyVertex, int, UndirectedG>(runner, sizes, densities);
+
+    benchMixedGraph<int, bool>(runner, sizes, densities, directedShares);
+    benchMixedGraph<int, double>(runner, sizes, densities, directedShares);
+    benchMixedGraph<HeavyVertex, double>(runner, sizes, densities, directedShares);
+
+    benchGenerators(runner, runner.quick());
+
+    runner.finish();
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+#include "../../include/GraphMatrix.hpp"
+
+using namespace Appledore;
+
+// Serves one request with a graph that lives in a stack buffer. Nothing is freed one by
+// one: the graph and the arena go away together when the function returns.
+static size_t countRoutes(int stops)
+{
+    std::array<std::byte, 64 * 1024> buffer;
+    // null_memory_resource as upstream: overflowing the buffer throws instead of quietly
+    // falling back to the heap.
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+    GraphMatrix<int, double, DirectedG, PmrStorage> routes(&arena);
+    std::pmr::vector<int> vertices(&arena);
+    for (int stop = 0; stop < stops; ++stop)
+        vertices.push_back(stop);
+    routes.addVertices(vertices);
+    for (int stop = 0; stop + 1 < stops; ++stop)
+    {
+        routes.addEdge(stop, stop + 1, 1.0);
+        if (stop + 2 < stops)
+            routes.addEdge(stop, stop + 2, 2.5);
+    }
+
+    // Temporaries of the path search come from a second arena, released after the query.
+    std::pmr::monotonic_buffer_resource scratch(16 * 1024);
+    return routes.countPathsDFS(0, stops - 1, &scratch);
+}
+
+int main()
+{
+    for (int stops : {4, 8, 12})
+        std::cout << "Routes across " << stops << " stops: " << countRoutes(stops) << "\n";
+    return 0;
+}
@@ -0,0 +1,36 @@
+#include <iostream>
+#include <string>
+#include "../../include/K2Tree.hpp"
+
+using namespace Appledore;
+
+int main()
+{
+    GraphMatrix<std::string, UnweightedG, DirectedG> links;
+    links.addVertices({"home", "about", "blog", "post-1", "post-2", "contact"});
+    links.addEdge("home", "about");
+    links.addEdge("home", "blog");
+    links.addEdge("blog", "post-1");
+    links.addEdge("blog", "post-2");
+    links.addEdge("post-1", "post-2");
+    links.addEdge("post-2", "home");
+    links.addEdge("about", "contact");
+
+    // Read-only compressed copy, queries run directly on the bits.
+    K2TreeGraph<std::string> compressed(links);
+    std::cout << "Edges: " << compressed.getNumEdges() << ", tree size: " << compressed.memoryUsage() << " bytes\n";
+
+    std::cout << "blog links to:";
+    for (const auto &page : compressed.getOutNeighbors("blog"))
+        std::cout << " " << page;
+    std::cout << "\n";
+
+    // In-neighbors are as cheap as out-neighbors, no column walk.
+    std::cout << "post-2 is linked from:";
+    for (const auto &page : compressed.getInNeighbors("post-2"))
+        std::cout << " " << page;
+    std::cout << "\n";
+
+    std::cout << "home -> contact? " << (compressed.hasEdge("home", "contact") ? "yes" : "no") << "\n";
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../include/GraphMatrix.hpp"
+#include "../../include/ConcurrentGraph.hpp"
+
+using namespace Appledore;
+
+int main()
+{
+    // Readers never block each other; each write() publishes a new immutable version.
+    ConcurrentGraph<GraphMatrix<std::string, int, DirectedG>, SnapshotMode> routes;
+
+    routes.write([](auto &graph)
+                 {
+                     graph.addVertex(std::string("A"), std::string("B"), std::string("C"), std::string("D"));
+                     graph.addEdge("A", "B", 5);
+                     graph.addEdge("B", "C", 3);
+                     graph.addEdge("C", "D", 7);
+                 });
+
+    // A long running analysis keeps working on the version it started with.
+    auto snapshot = routes.snapshot();
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&routes]
+                             {
+                                 for (int q = 0; q < 1000; ++q)
+                                 {
+                                     routes.hasEdge(std::string("A"), std::string("B"));
+                                     routes.findAllPaths(std::string("A"), std::string("D"));
+                                 }
+                             });
+    }
+
+    routes.addEdge(std::string("A"), std::string("D"), 20);
+
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+
+    std::cout << "Version seen by snapshot: " << snapshot.versionNumber()
+              << ", paths A -> D: " << snapshot->findAllPaths("A", "D").size() << "\n";
+    std::cout << "Current version: " << routes.versionNumber()
+              << ", paths A -> D: " << routes.findAllPaths(std::string("A"), std::string("D")).size() << "\n";
+
+    // Shared mutex mode for read-heavy graphs that are mutated in place.
+    ConcurrentGraph<GraphMatrix<int, int, UndirectedG>> network;
+    network.addVertex(1, 2, 3);
+    network.addEdge(1, 2, 10);
+    std::cout << "Density: " << network.density() << "\n";
+    return 0;
+}
@@ -0,0 +1,34 @@
+#include <iostream>
+#include <string>
+#include "../../include/GraphMatrix.hpp"
+
+using namespace Appledore;
+
+int main()
+{
+    GraphMatrix<std::string, int, DirectedG> flights;
+    flights.addVertices({std::string("AMS"), std::string("BER"), std::string("CDG"), std::string("DUB")});
+    flights.addEdge("AMS", "BER", 90);
+    flights.addEdge("BER", "CDG", 105);
+    flights.addEdge("CDG", "DUB", 95);
+
+    // findEdge answers a probe with a pointer, nullptr for a miss, and never throws.
+    const std::string pairs[][2] = {{"AMS", "BER"}, {"AMS", "CDG"}, {"CDG", "DUB"}, {"DUB", "AMS"}};
+    for (const auto &[from, to] : pairs)
+    {
+        if (const int *minutes = flights.findEdge(from, to))
+            std::cout << from << " -> " << to << ": " << *minutes << " min\n";
+        else
+            std::cout << from << " -> " << to << ": no direct flight\n";
+    }
+
+    // The try* calls say why they failed; the message is only built when asked for.
+    GraphResult<const int &> leg = flights.tryGetEdge("AMS", "OSL");
+    if (!leg)
+        std::cout << graphErrorMessage(leg.error(), std::string("AMS"), std::string("OSL")) << "\n";
+
+    if (!flights.tryRemoveEdge("DUB", "AMS"))
+        std::cout << "Nothing to cancel between DUB and AMS\n";
+    std::cout << "Departures from BER: " << flights.tryOutdegree("BER").value_or(0) << "\n";
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../include/GraphMatrix.hpp"
+
+using namespace Appledore;
+
+static void printUsage(const char *label, const MemoryUsage &usage)
+{
+    MemoryBlock total = usage.total();
+    std::cout << label << ": " << total.capacity << " bytes held, " << total.used << " used ("
+              << "adjacency " << usage.adjacency.capacity << ", vertex map " << usage.vertexToIndex.capacity
+              << ", vertex array " << usage.indexToVertex.capacity << ", vertex names " << usage.vertexData.capacity << ")\n";
+}
+
+int main()
+{
+    GraphMatrix<std::string, double, UndirectedG> roads;
+    std::vector<std::string> towns;
+    for (int i = 0; i < 400; ++i)
+        towns.push_back("town-with-a-long-name-" + std::to_string(i));
+    roads.addVertices(towns);
+    for (int i = 1; i < 400; ++i)
+        roads.addEdge(towns[i - 1], towns[i], 1.5 * i);
+    printUsage("Built", roads.memoryUsage());
+
+    // Removing vertices one by one truncates the packed triangle in place, the freed
+    // cells stay allocated until shrinkToFit().
+    for (int i = 399; i >= 100; --i)
+        roads.removeVertex(towns[i]);
+    MemoryUsage churned = roads.memoryUsage();
+    printUsage("After removals", churned);
+    std::cout << "Slack: " << churned.total().slack() << " bytes\n";
+
+    roads.shrinkToFit();
+    MemoryUsage compact = roads.memoryUsage();
+    printUsage("After shrinkToFit", compact);
+    std::cout << "Slack: " << compact.total().slack() << " bytes\n";
+    return 0;
+}
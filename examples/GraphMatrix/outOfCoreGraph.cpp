@@ -0,0 +1,39 @@
+#include <iostream>
+#include <vector>
+#include "../../include/GraphMatrix.hpp"
+#include "../../include/MappedStorage.hpp"
+
+using namespace Appledore;
+
+int main()
+{
+    // The adjacency matrix lives in a file-backed mapping under MappedStorage::directory()
+    // rather than on the heap; only the pages that are touched become resident.
+    MappedStorage::directory() = "/tmp";
+
+    GraphMatrix<int, double, DirectedG, MappedStorage> ring;
+    std::vector<int> stations(5000);
+    for (int i = 0; i < 5000; ++i)
+        stations[i] = i;
+    ring.addVertices(stations);
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        ring.addEdge(i, (i + 1) % 5000, 1.5);
+    }
+    ring.addEdge(0, 2500, 10.0);
+
+    // Row scans are hinted to the kernel as sequential reads.
+    std::cout << "Outdegree of 0: " << ring.outdegree(0) << "\n";
+    std::cout << "Neighbors of 0:";
+    for (int station : ring.getNeighbors(0))
+    {
+        std::cout << " " << station;
+    }
+    std::cout << "\n";
+    std::cout << "Cyclic: " << (ring.isCyclic() ? "yes" : "no") << "\n";
+
+    // Push the dirty pages to the backing file.
+    ring.flush();
+    return 0;
+}
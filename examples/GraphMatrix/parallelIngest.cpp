@@ -0,0 +1,40 @@
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include "../../include/ConcurrentIngest.hpp"
+
+using namespace Appledore;
+
+int main()
+{
+    // The vertex set is fixed up front; edges can then be inserted from any number of threads.
+    std::vector<int> users(1000);
+    std::iota(users.begin(), users.end(), 0);
+    ConcurrentIngestGraph<int> follows(users);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+    {
+        workers.emplace_back([&follows, t]
+                             {
+                                 for (int user = t; user < 1000; user += 4)
+                                 {
+                                     follows.addEdge(user, (user * 7 + 1) % 1000);
+                                     follows.addEdge(user, (user * 13 + 5) % 1000);
+                                 }
+                             });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    std::cout << "Edges ingested: " << follows.getNumEdges() << "\n";
+    std::cout << "Followers of user 1: " << follows.indegree(1) << "\n";
+
+    // Hand the result over to the regular graph API.
+    auto graph = follows.toGraphMatrix();
+    std::cout << "User 0 follows user 1: " << (graph.hasEdge(0, 1) ? "yes" : "no") << "\n";
+    return 0;
+}
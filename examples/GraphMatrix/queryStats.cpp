@@ -0,0 +1,38 @@
+#include <iostream>
+#include "../../include/GraphGenerators.hpp"
+
+using namespace Appledore;
+
+int main()
+{
+    // Instrumented<DenseStorage> keeps the dense containers and adds stats(). With the
+    // default policy the same calls record nothing and cost nothing.
+    GraphMatrix<int, double, DirectedG, Instrumented<DenseStorage>> routes;
+    addEdgeList(routes, erdosRenyiGraph<int, double>(12, 0.3, true, {.seed = 1, .maxWeight = 9.0}));
+
+    for (int src = 0; src < 12; ++src)
+    {
+        for (int dest = 0; dest < 12; ++dest)
+        {
+            if (routes.hasEdge(src, dest))
+                routes.getEdge(src, dest);
+        }
+        (void)routes.totalDegree(src);
+    }
+    std::cout << routes.findAllPaths(0, 11).size() << " paths from 0 to 11\n";
+
+    GraphStats stats = routes.stats();
+    for (GraphOp op : {GraphOp::AddEdge, GraphOp::HasEdge, GraphOp::GetEdge, GraphOp::Degree, GraphOp::FindAllPaths})
+    {
+        const OpStats &calls = stats[op];
+        std::cout << graphOpName(op) << ": " << calls.calls << " calls, mean " << calls.meanNs()
+                  << " ns, p99 under " << calls.latency.quantileNs(0.99) << " ns\n";
+    }
+    std::cout << "Paths emitted: " << stats[GraphCounter::PathsEmitted]
+              << ", nodes expanded: " << stats[GraphCounter::NodesExpanded]
+              << ", rows scanned: " << stats[GraphCounter::RowsScanned]
+              << ", columns scanned: " << stats[GraphCounter::ColumnsScanned] << "\n";
+
+    routes.resetStats();
+    return 0;
+}
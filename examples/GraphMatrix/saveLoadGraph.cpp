@@ -0,0 +1,36 @@
+#include <iostream>
+#include <string>
+#include "../../include/GraphSerialization.hpp"
+
+using namespace Appledore;
+
+int main()
+{
+    GraphMatrix<std::string, double, DirectedG> roads;
+    roads.addVertices({"Amsterdam", "Berlin", "Copenhagen", "Dresden"});
+    roads.addEdge("Amsterdam", "Berlin", 655.0);
+    roads.addEdge("Berlin", "Copenhagen", 440.0);
+    roads.addEdge("Berlin", "Dresden", 193.0);
+    roads.addEdge("Dresden", "Amsterdam", 812.0);
+
+    saveGraph(roads, "roads.appledore");
+
+    // The view maps the file and answers queries from it directly, nothing is parsed.
+    GraphFileView<std::string, double> view("roads.appledore");
+    std::cout << "Vertices: " << view.getNumVertices() << ", edges: " << view.getNumEdges() << "\n";
+    std::cout << "Berlin -> Dresden: " << view.getEdge("Berlin", "Dresden") << " km\n";
+
+    size_t berlin = view.getIndexOf("Berlin");
+    std::cout << "Berlin connects to:";
+    for (size_t neighbor : view.getNeighborsAt(berlin))
+    {
+        std::cout << " " << view.getVertexAt(neighbor);
+    }
+    std::cout << "\n";
+
+    // A mutable copy, when the graph has to change.
+    auto loaded = loadGraph<GraphMatrix<std::string, double, DirectedG>>("roads.appledore");
+    loaded.addEdge("Copenhagen", "Amsterdam", 780.0);
+    std::cout << "Loaded graph cyclic: " << (loaded.isCyclic() ? "yes" : "no") << "\n";
+    return 0;
+}
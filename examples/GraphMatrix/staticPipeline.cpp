@@ -0,0 +1,46 @@
+#include <array>
+#include <iostream>
+#include "../../include/StaticGraph.hpp"
+
+using namespace Appledore;
+
+// Build pipeline stages, known when compiling.
+enum Stage : size_t
+{
+    Fetch,
+    Configure,
+    Compile,
+    Test,
+    Package,
+    StageCount
+};
+
+constexpr std::array<const char *, StageCount> stageNames = {"fetch", "configure", "compile", "test", "package"};
+
+// Edge values are the stage durations in seconds.
+constexpr StaticGraphMatrix<StageCount, int, DirectedG> pipeline{
+    {Fetch, Configure, 5},
+    {Configure, Compile, 12},
+    {Compile, Test, 90},
+    {Compile, Package, 90},
+    {Test, Package, 40}};
+
+// Checked by the compiler: adding {Package, Fetch} would make both lines fail to compile.
+static_assert(!pipeline.isCyclic(), "pipeline stages must not depend on each other in a cycle");
+constexpr auto buildOrder = pipeline.topologicalSort();
+static_assert(buildOrder[0] == Fetch);
+
+int main()
+{
+    std::cout << "Build order:";
+    for (size_t stage : buildOrder)
+    {
+        std::cout << " " << stageNames[stage];
+    }
+    std::cout << "\n";
+
+    // Runtime queries read the precomputed tables.
+    std::cout << "package waits for " << pipeline.indegree(Package) << " stages\n";
+    std::cout << "compile -> test takes " << pipeline.getEdge(Compile, Test) << "s\n";
+    return 0;
+}
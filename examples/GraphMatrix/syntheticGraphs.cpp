@@ -0,0 +1,36 @@
+#include <iostream>
+#include "../../include/GraphGenerators.hpp"
+
+using namespace Appledore;
+
+int main()
+{
+    // Same seed, same graph, whatever the thread count.
+    auto social = barabasiAlbertGraph<int>(2000, 3, {.seed = 7, .threads = 4});
+    auto again = barabasiAlbertGraph<int>(2000, 3, {.seed = 7, .threads = 1});
+    std::cout << "Preferential attachment: " << social.edges.size() << " edges, "
+              << (social.edges.size() == again.edges.size() ? "reproducible" : "differs") << "\n";
+
+    GraphMatrix<int, UnweightedG, UndirectedG> network;
+    addEdgeList(network, social);
+    std::cout << "Degree of the oldest vertex: " << network.totalDegree(0)
+              << ", of the newest: " << network.totalDegree(1999) << "\n";
+
+    // A road-like grid with travel times between 1 and 5, some streets closed.
+    auto roads = gridGraph<int, double>(20, 20, 0.9, 0.05, {.seed = 3, .minWeight = 1.0, .maxWeight = 5.0});
+    GraphMatrix<int, double, UndirectedG> city;
+    addEdgeList(city, roads);
+    std::cout << "Road grid: " << city.getNumVertices() << " junctions, density " << city.density() << "\n";
+
+    // Random DAGs keep their vertex numbering as a topological order.
+    MixedGraphMatrix<int> tasks;
+    addEdgeList(tasks, randomDag<int, bool>(300, 0.02, {.seed = 11}));
+    std::cout << "Task graph acyclic: " << (tasks.isMixedAcyclic() ? "yes" : "no") << "\n";
+
+    // Skewed R-MAT graph over 2^12 vertices, vertex 0 is the largest hub.
+    auto web = rmatGraph<int>(12, 8, true, {}, {.seed = 5});
+    GraphMatrix<int, UnweightedG, DirectedG> links;
+    addEdgeList(links, web);
+    std::cout << "R-MAT: " << web.edges.size() << " links, hub out-degree " << links.outdegree(0) << "\n";
+    return 0;
+}
@@ -0,0 +1,30 @@
+#include <iostream>
+#include <string>
+#include "../../include/GraphMatrix.hpp"
+
+using namespace Appledore;
+
+int main()
+{
+    // CowStorage shares storage blocks between copies, so snapshots are O(1).
+    GraphMatrix<std::string, int, DirectedG, CowStorage> pipeline;
+    pipeline.addVertex(std::string("ingest"), std::string("clean"), std::string("train"), std::string("deploy"));
+    pipeline.addEdge("ingest", "clean", 1);
+    pipeline.addEdge("clean", "train", 2);
+    pipeline.addEdge("train", "deploy", 3);
+
+    // Analytics run against a consistent version...
+    auto version1 = pipeline.snapshot();
+
+    // ...while live updates keep arriving. Only the touched block is copied.
+    pipeline.addEdge("deploy", "ingest", 4);
+    pipeline.removeEdge("clean", "train");
+
+    std::cout << "Snapshot cyclic: " << (version1.isCyclic() ? "yes" : "no")
+              << ", paths ingest -> deploy: " << version1.findAllPaths("ingest", "deploy").size() << "\n";
+    std::cout << "Live cyclic: " << (pipeline.isCyclic() ? "yes" : "no")
+              << ", paths ingest -> deploy: " << pipeline.findAllPaths("ingest", "deploy").size() << "\n";
+
+    // version1 is released automatically when it goes out of scope.
+    return 0;
+}
@@ -0,0 +1,38 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../include/GraphMatrix.hpp"
+
+using namespace Appledore;
+
+int main()
+{
+    GraphMatrix<std::string, int, UndirectedG> network;
+    const std::vector<std::string> hosts = {"gateway", "db-primary", "db-replica", "cache", "worker-1", "worker-2"};
+    network.addVertices(hosts);
+
+    // Look every host up once; the handles then address it without touching the vertex map.
+    std::vector<VertexHandle> handles;
+    for (const std::string &host : hosts)
+        handles.push_back(network.handleOf(host));
+    const VertexHandle gateway = handles[0], primary = handles[1], replica = handles[2], cache = handles[3];
+
+    network.addEdge(gateway, cache, 2);
+    network.addEdge(cache, primary, 4);
+    network.addEdge(primary, replica, 1);
+    for (size_t i = 4; i < handles.size(); ++i)
+        network.addEdge(handles[i], gateway, 3);
+    std::cout << "gateway links: " << network.totalDegree(gateway) << "\n";
+
+    // Removing a vertex moves another one to its index; handles follow the move.
+    network.removeVertex(replica);
+    std::cout << "worker-2 is now at index " << network.getIndexOf(handles[5]) << ", still "
+              << network.getVertex(handles[5]) << "\n";
+
+    // Handles of removed vertices are stale, also after their slot is reused.
+    network.addVertex(std::string("db-replica-2"));
+    if (!network.isValid(replica))
+        std::cout << "replica handle is stale\n";
+    std::cout << "replica link: " << (network(primary, replica) ? "up" : "gone") << "\n";
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "../../include/GraphExport.hpp"
+
+// Custom edge type for flight details
+struct FlightRoute
+{
+    int duration = 0;
+    std::string airline;
+};
+
+int main()
+{
+    Appledore::MixedGraphMatrix<std::string, FlightRoute> flightGraph;
+    flightGraph.addVertex("New York", "London", "Paris", "Tokyo");
+
+    flightGraph.addEdge("New York", "London", FlightRoute{415, "British Airways"}, true); // Directed route
+    flightGraph.addEdge("London", "Paris", FlightRoute{90, "Air France"}, false);         // Undirected route
+    flightGraph.addEdge("Paris", "Tokyo", FlightRoute{720, "ANA"}, true);                 // Directed route
+
+    // Edge payloads are written through a formatter, straight into the output buffer.
+    auto formatRoute = [](Appledore::BufferedSink &out, const FlightRoute &route)
+    {
+        out << route.airline << " (" << route.duration << " min)";
+    };
+
+    // Undirected routes are drawn without arrowheads.
+    Appledore::writeDot(flightGraph, std::cout, Appledore::DefaultFormatter{}, formatRoute);
+
+    std::ofstream graphml("flights.graphml");
+    Appledore::writeGraphML(flightGraph, graphml, Appledore::DefaultFormatter{}, formatRoute);
+
+    // Matrix Market wants numeric values, so only the duration is exported.
+    std::ofstream matrix("flights.mtx");
+    Appledore::writeMatrixMarket(flightGraph, matrix, [](Appledore::BufferedSink &out, const FlightRoute &route)
+                                 { out << route.duration; });
+
+    std::cout << "Wrote flights.graphml and flights.mtx\n";
+    return 0;
+}
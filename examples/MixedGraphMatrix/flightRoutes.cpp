@@ -1,6 +1,6 @@
 #include <iostream>
 #include <string>
-#include "../../include/MixedGraph.hpp"
+#include "../../include/MixedGraphSearch.hpp"
 
 // Custom edge type for flight details
 class FlightRoute
@@ -66,5 +66,22 @@ int main()
     // Check for a non-existent route
     // flightGraph.getEdgeValue("Paris", "New York"); //throws error, handle carefully
 
+    // Fastest itinerary, weighing each route by its duration. London - Paris is
+    // undirected and can be flown both ways, the other routes only one way.
+    Appledore::MixedGraphSearch search(flightGraph, [](const FlightRoute &r)
+                                       { return r.duration; });
+    size_t from = flightGraph.getIndexOf("New York");
+    size_t to = flightGraph.getIndexOf("Tokyo");
+    if (auto itinerary = search.shortestPath(from, to))
+    {
+        std::cout << "Fastest itinerary from New York to Tokyo (" << itinerary->distance << " mins): ";
+        for (size_t city : itinerary->vertices)
+        {
+            std::cout << flightGraph.getVertexAt(city) << (city == to ? "\n" : " -> ");
+        }
+    }
+    std::cout << "Can Tokyo reach New York? "
+              << (search.reachable(to, from) ? "Yes" : "No") << "\n";
+
     return 0;
 }
@@ -0,0 +1,54 @@
+#include <iostream>
+#include <string>
+#include "../../include/MixedGraph.hpp"
+
+int main()
+{
+    // Directed edges are precedence constraints, undirected edges are jobs that must not
+    // overlap but may run in either order.
+    Appledore::MixedGraphMatrix<std::string> schedule;
+    schedule.addVertex("fetch", "compile", "test", "package", "docs");
+
+    schedule.addEdge("fetch", "compile", std::nullopt, true);
+    schedule.addEdge("compile", "test", std::nullopt, true);
+    schedule.addEdge("compile", "package", std::nullopt, true);
+    schedule.addEdge("test", "package", std::nullopt, false);
+    schedule.addEdge("docs", "package", std::nullopt, false);
+
+    if (auto order = schedule.acyclicOrientation())
+    {
+        std::cout << "Conflicts resolved without a cycle:\n";
+        for (const auto &[first, second] : *order)
+        {
+            std::cout << "  " << schedule.getVertexAt(first) << " before " << schedule.getVertexAt(second) << "\n";
+        }
+    }
+
+    // A street network: one-way streets are directed, two-way streets undirected. It can
+    // be made all one-way and stay navigable only if no two-way street is a bridge.
+    Appledore::MixedGraphMatrix<int> streets;
+    streets.addVertex(0, 1, 2, 3);
+    streets.addEdge(0, 1, std::nullopt, true);
+    streets.addEdge(1, 2, std::nullopt, false);
+    streets.addEdge(2, 0, std::nullopt, false);
+    streets.addEdge(2, 3, std::nullopt, false);
+
+    std::cout << "Bridges:";
+    for (const auto &[a, b] : streets.bridges())
+    {
+        std::cout << " " << a << "-" << b;
+    }
+    std::cout << "\nStrong orientation " << (streets.strongOrientation() ? "exists" : "does not exist") << "\n";
+
+    streets.addEdge(3, 0, std::nullopt, false);
+    if (auto oneWay = streets.strongOrientation())
+    {
+        std::cout << "After adding 3-0:";
+        for (const auto &[src, dest] : *oneWay)
+        {
+            std::cout << " " << src << "->" << dest;
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
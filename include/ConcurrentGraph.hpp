@@ -0,0 +1,295 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace Appledore
+{
+    // Concurrency modes for ConcurrentGraph.
+    // SharedMutexMode: readers share a std::shared_mutex, writers take it exclusively.
+    // SnapshotMode: readers work on an immutable published version without taking any lock,
+    //               writers copy the current version, modify the copy and publish it.
+    struct SharedMutexMode{};
+    struct SnapshotMode{};
+
+    // Thread-safe wrapper around GraphMatrix/MixedGraphMatrix. Any query can be run through
+    // read(), any mutation through write(); the common queries and mutations are forwarded
+    // directly for convenience.
+    template <typename Graph, typename Mode = SharedMutexMode>
+    class ConcurrentGraph;
+
+    template <typename Graph>
+    class ConcurrentGraph<Graph, SharedMutexMode>
+    {
+    public:
+        ConcurrentGraph() = default;
+        explicit ConcurrentGraph(Graph graph) : graph(std::move(graph)) {}
+
+        template <typename Func>
+        decltype(auto) read(Func &&func) const
+        {
+            std::shared_lock lock(mutex);
+            return std::invoke(std::forward<Func>(func), std::as_const(graph));
+        }
+
+        template <typename Func>
+        decltype(auto) write(Func &&func)
+        {
+            std::unique_lock lock(mutex);
+            return std::invoke(std::forward<Func>(func), graph);
+        }
+
+        template <typename... Args>
+        bool hasEdge(const Args &...args) const
+        {
+            return read([&](const Graph &g) { return g.hasEdge(args...); });
+        }
+        template <typename VertexType>
+        auto getNeighbors(const VertexType &vertex) const
+        {
+            return read([&](const Graph &g) { return g.getNeighbors(vertex); });
+        }
+        template <typename... Args>
+        auto findAllPaths(const Args &...args) const
+        {
+            return read([&](const Graph &g) { return g.findAllPaths(args...); });
+        }
+        [[nodiscard]] double density() const
+        {
+            return read([](const Graph &g) { return g.density(); });
+        }
+        // returned by value, a reference would outlive the lock.
+        auto getVertices() const
+        {
+            return read([](const Graph &g) { return g.getVertices(); });
+        }
+
+        template <typename... Args>
+        void addVertex(Args &&...args)
+        {
+            write([&](Graph &g) { g.addVertex(std::forward<Args>(args)...); });
+        }
+        template <typename... Args>
+        void addEdge(const Args &...args)
+        {
+            write([&](Graph &g) { g.addEdge(args...); });
+        }
+        template <typename... Args>
+        void updateEdge(const Args &...args)
+        {
+            write([&](Graph &g) { g.updateEdge(args...); });
+        }
+        template <typename VertexType>
+        void removeEdge(const VertexType &src, const VertexType &dest)
+        {
+            write([&](Graph &g) { g.removeEdge(src, dest); });
+        }
+        template <typename VertexType>
+        void removeVertex(const VertexType &vertex)
+        {
+            write([&](Graph &g) { g.removeVertex(vertex); });
+        }
+
+    private:
+        mutable std::shared_mutex mutex;
+        Graph graph;
+    };
+
+    // RCU style wrapper. The published version is reached through an atomic pointer, and
+    // readers announce themselves in one of a fixed set of cache-line sized slots chosen by
+    // thread id, so concurrent readers touch no shared cache line. A writer publishes the
+    // next version, flips the global epoch and waits until no reader is left in the previous
+    // epoch before it drops its reference to the old version (a grace period).
+    //
+    // read() is meant for short queries. Long running analytics should hold a Snapshot
+    // instead: it keeps its version alive by reference count and never delays writers.
+    // Every write() copies the graph, so batch several mutations into one write(), or use
+    // GraphMatrix with CowStorage, where the copy is O(1) and only touched blocks are duplicated.
+    template <typename Graph>
+    class ConcurrentGraph<Graph, SnapshotMode>
+    {
+        struct Version : std::enable_shared_from_this<Version>
+        {
+            Graph graph;
+            uint64_t number;
+
+            Version(Graph graph, uint64_t number) : graph(std::move(graph)), number(number) {}
+        };
+
+    public:
+        // Immutable view of one published version.
+        class Snapshot
+        {
+        public:
+            const Graph &operator*() const { return version->graph; }
+            const Graph *operator->() const { return &version->graph; }
+            [[nodiscard]] uint64_t versionNumber() const { return version->number; }
+
+        private:
+            friend class ConcurrentGraph;
+            explicit Snapshot(std::shared_ptr<const Version> version) : version(std::move(version)) {}
+            std::shared_ptr<const Version> version;
+        };
+
+        ConcurrentGraph() : ConcurrentGraph(Graph()) {}
+        explicit ConcurrentGraph(Graph graph)
+            : owner(std::make_shared<Version>(std::move(graph), 0))
+        {
+            current.store(owner.get());
+        }
+        ConcurrentGraph(const ConcurrentGraph &) = delete;
+        ConcurrentGraph &operator=(const ConcurrentGraph &) = delete;
+
+        template <typename Func>
+        decltype(auto) read(Func &&func) const
+        {
+            ReadSection section(*this);
+            return std::invoke(std::forward<Func>(func), std::as_const(section.version->graph));
+        }
+
+        [[nodiscard]] Snapshot snapshot() const
+        {
+            ReadSection section(*this);
+            return Snapshot(section.version->shared_from_this());
+        }
+
+        [[nodiscard]] uint64_t versionNumber() const
+        {
+            ReadSection section(*this);
+            return section.version->number;
+        }
+
+        // Applies func to a private copy of the current version and publishes the result.
+        // If func throws, nothing is published.
+        template <typename Func>
+        void write(Func &&func)
+        {
+            std::lock_guard lock(writerMutex);
+            auto next = std::make_shared<Version>(owner->graph, owner->number + 1);
+            std::invoke(std::forward<Func>(func), next->graph);
+
+            current.store(next.get());
+            std::shared_ptr<Version> previous = std::exchange(owner, std::move(next));
+            synchronize();
+            // previous is released here unless a Snapshot still holds it.
+        }
+
+        template <typename... Args>
+        bool hasEdge(const Args &...args) const
+        {
+            return read([&](const Graph &g) { return g.hasEdge(args...); });
+        }
+        template <typename VertexType>
+        auto getNeighbors(const VertexType &vertex) const
+        {
+            return read([&](const Graph &g) { return g.getNeighbors(vertex); });
+        }
+        template <typename... Args>
+        auto findAllPaths(const Args &...args) const
+        {
+            return read([&](const Graph &g) { return g.findAllPaths(args...); });
+        }
+        [[nodiscard]] double density() const
+        {
+            return read([](const Graph &g) { return g.density(); });
+        }
+        auto getVertices() const
+        {
+            return read([](const Graph &g) { return g.getVertices(); });
+        }
+
+        template <typename... Args>
+        void addVertex(Args &&...args)
+        {
+            write([&](Graph &g) { g.addVertex(std::forward<Args>(args)...); });
+        }
+        template <typename... Args>
+        void addEdge(const Args &...args)
+        {
+            write([&](Graph &g) { g.addEdge(args...); });
+        }
+        template <typename... Args>
+        void updateEdge(const Args &...args)
+        {
+            write([&](Graph &g) { g.updateEdge(args...); });
+        }
+        template <typename VertexType>
+        void removeEdge(const VertexType &src, const VertexType &dest)
+        {
+            write([&](Graph &g) { g.removeEdge(src, dest); });
+        }
+        template <typename VertexType>
+        void removeVertex(const VertexType &vertex)
+        {
+            write([&](Graph &g) { g.removeVertex(vertex); });
+        }
+
+    private:
+        static constexpr size_t slotCount = 64;
+
+        struct alignas(64) ReaderSlot
+        {
+            std::atomic<uint64_t> readers[2] = {0, 0};
+        };
+
+        // Registers the calling thread as a reader of the current epoch for its lifetime.
+        struct ReadSection
+        {
+            ReaderSlot &slot;
+            uint64_t parity;
+            const Version *version;
+
+            explicit ReadSection(const ConcurrentGraph &g)
+                : slot(g.slots[slotIndex()]), parity(g.epoch.load() & 1)
+            {
+                slot.readers[parity].fetch_add(1);
+                version = g.current.load();
+            }
+            ~ReadSection()
+            {
+                slot.readers[parity].fetch_sub(1, std::memory_order_release);
+            }
+            ReadSection(const ReadSection &) = delete;
+            ReadSection &operator=(const ReadSection &) = delete;
+        };
+
+        std::atomic<const Version *> current{nullptr};
+        std::shared_ptr<Version> owner;
+        std::atomic<uint64_t> epoch{0};
+        mutable std::array<ReaderSlot, slotCount> slots;
+        std::mutex writerMutex;
+
+        static size_t slotIndex()
+        {
+            static thread_local const size_t index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % slotCount;
+            return index;
+        }
+
+        // Waits until every reader that may have loaded the previous version has left.
+        // Readers entering after a flip are counted under the other parity and can only see
+        // the new version. A reader that sampled the epoch before an earlier flip may still
+        // sit under either parity, so both are drained in turn.
+        void synchronize()
+        {
+            for (int round = 0; round < 2; ++round)
+            {
+                uint64_t previousParity = epoch.fetch_add(1) & 1;
+                for (const ReaderSlot &slot : slots)
+                {
+                    while (slot.readers[previousParity].load() != 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "GraphMatrix.hpp"
+
+namespace Appledore
+{
+    // Unweighted directed graph for parallel edge ingestion. The vertex set is frozen at
+    // construction, so vertex lookups only read the maps and need no synchronization.
+    // Each row of the adjacency matrix is a run of atomic 64-bit words; addEdge/removeEdge
+    // flip one bit with fetch_or/fetch_and and keep the degree counters in sync only when
+    // the bit actually changed, so any number of threads can insert and remove edges at
+    // the same time without locks.
+    //
+    // Updates are relaxed: edges written by one thread are guaranteed to be visible to
+    // another after the threads synchronize (e.g. std::thread::join). Once ingestion is
+    // done, toGraphMatrix() converts the result into a regular GraphMatrix.
+    template <typename VertexType>
+    class ConcurrentIngestGraph
+    {
+    public:
+        template <typename Range>
+        explicit ConcurrentIngestGraph(const Range &vertices)
+        {
+            for (const auto &vertex : vertices)
+            {
+                if (vertexToIndex.count(vertex))
+                    continue;
+                vertexToIndex.emplace(vertex, indexToVertex.size());
+                indexToVertex.push_back(vertex);
+            }
+            numVertices = indexToVertex.size();
+            wordsPerRow = (numVertices + 63) / 64;
+            rows = std::make_unique<std::atomic<uint64_t>[]>(numVertices * wordsPerRow);
+            outDegrees = std::make_unique<std::atomic<size_t>[]>(numVertices);
+            inDegrees = std::make_unique<std::atomic<size_t>[]>(numVertices);
+        }
+
+        ConcurrentIngestGraph(std::initializer_list<VertexType> vertices)
+            : ConcurrentIngestGraph(std::vector<VertexType>(vertices)) {}
+
+        // Returns true if the edge was not present before.
+        bool addEdge(const VertexType &src, const VertexType &dest)
+        {
+            return addEdgeAt(getIndexOf(src), getIndexOf(dest));
+        }
+
+        bool addEdgeAt(size_t srcIndex, size_t destIndex)
+        {
+            checkIndices(srcIndex, destIndex);
+            uint64_t mask = uint64_t{1} << (destIndex % 64);
+            uint64_t previous = word(srcIndex, destIndex).fetch_or(mask, std::memory_order_relaxed);
+            if (previous & mask)
+                return false;
+
+            outDegrees[srcIndex].fetch_add(1, std::memory_order_relaxed);
+            inDegrees[destIndex].fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Returns true if the edge was present before.
+        bool removeEdge(const VertexType &src, const VertexType &dest)
+        {
+            return removeEdgeAt(getIndexOf(src), getIndexOf(dest));
+        }
+
+        bool removeEdgeAt(size_t srcIndex, size_t destIndex)
+        {
+            checkIndices(srcIndex, destIndex);
+            uint64_t mask = uint64_t{1} << (destIndex % 64);
+            uint64_t previous = word(srcIndex, destIndex).fetch_and(~mask, std::memory_order_relaxed);
+            if (!(previous & mask))
+                return false;
+
+            outDegrees[srcIndex].fetch_sub(1, std::memory_order_relaxed);
+            inDegrees[destIndex].fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        [[nodiscard]] bool hasEdge(const VertexType &src, const VertexType &dest) const
+        {
+            return hasEdgeAt(getIndexOf(src), getIndexOf(dest));
+        }
+
+        [[nodiscard]] bool hasEdgeAt(size_t srcIndex, size_t destIndex) const
+        {
+            checkIndices(srcIndex, destIndex);
+            uint64_t mask = uint64_t{1} << (destIndex % 64);
+            return word(srcIndex, destIndex).load(std::memory_order_relaxed) & mask;
+        }
+
+        [[nodiscard]] size_t outdegree(const VertexType &vertex) const
+        {
+            return outDegrees[getIndexOf(vertex)].load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] size_t indegree(const VertexType &vertex) const
+        {
+            return inDegrees[getIndexOf(vertex)].load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] size_t totalDegree(const VertexType &vertex) const
+        {
+            return indegree(vertex) + outdegree(vertex);
+        }
+
+        // Sum of the out-degrees, O(V). There is no shared edge counter for the writers to
+        // contend on.
+        [[nodiscard]] size_t getNumEdges() const
+        {
+            size_t edges = 0;
+            for (size_t i = 0; i < numVertices; ++i)
+                edges += outDegrees[i].load(std::memory_order_relaxed);
+            return edges;
+        }
+
+        [[nodiscard]] size_t getNumVertices() const
+        {
+            return numVertices;
+        }
+
+        const std::vector<VertexType> &getVertices() const
+        {
+            return indexToVertex;
+        }
+
+        [[nodiscard]] size_t getIndexOf(const VertexType &vertex) const
+        {
+            auto it = vertexToIndex.find(vertex);
+            if (it == vertexToIndex.end())
+            {
+                throw std::invalid_argument("Vertex does not exist in the graph");
+            }
+            return it->second;
+        }
+
+        // Should not run concurrently with writers, the copy would be torn. Indices carry over
+        // unchanged, so the cells are written by index without vertex lookups.
+        [[nodiscard]] GraphMatrix<VertexType, UnweightedG, DirectedG> toGraphMatrix() const
+        {
+            GraphMatrix<VertexType, UnweightedG, DirectedG> graph;
+            graph.addVertices(indexToVertex);
+
+            for (size_t src = 0; src < numVertices; ++src)
+            {
+                for (size_t w = 0; w < wordsPerRow; ++w)
+                {
+                    uint64_t bits = rows[src * wordsPerRow + w].load(std::memory_order_relaxed);
+                    while (bits)
+                    {
+                        size_t dest = w * 64 + static_cast<size_t>(std::countr_zero(bits));
+                        graph.addEdgeAt(src, dest);
+                        bits &= bits - 1;
+                    }
+                }
+            }
+            return graph;
+        }
+
+    private:
+        std::map<VertexType, size_t> vertexToIndex;
+        std::vector<VertexType> indexToVertex;
+        size_t numVertices = 0;
+        size_t wordsPerRow = 0;
+        std::unique_ptr<std::atomic<uint64_t>[]> rows;
+        std::unique_ptr<std::atomic<size_t>[]> outDegrees;
+        std::unique_ptr<std::atomic<size_t>[]> inDegrees;
+
+        std::atomic<uint64_t> &word(size_t src, size_t dest) const
+        {
+            return rows[src * wordsPerRow + dest / 64];
+        }
+
+        void checkIndices(size_t srcIndex, size_t destIndex) const
+        {
+            if (srcIndex >= numVertices || destIndex >= numVertices)
+            {
+                throw std::out_of_range("Vertex index out of range");
+            }
+        }
+    };
+}
@@ -0,0 +1,418 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "GraphMatrix.hpp"
+#include "MixedGraph.hpp"
+#include "MappedFile.hpp"
+
+namespace Appledore
+{
+    // Whitespace: SNAP style "src dest [weight]" lines, '#' and '%' start comments.
+    // CSV:        "src,dest[,weight]" lines. For numeric vertex types a first line that does
+    //             not parse is taken as a header.
+    // MatrixMarket: coordinate format, "%%MatrixMarket matrix coordinate <field> <symmetry>"
+    //             banner and a size line, entries "row col [value]".
+    // Auto picks MatrixMarket on the banner, CSV if the first record has a comma.
+    enum class EdgeListFormat
+    {
+        Auto,
+        Whitespace,
+        CSV,
+        MatrixMarket
+    };
+
+    struct EdgeListOptions
+    {
+        EdgeListFormat format = EdgeListFormat::Auto;
+        // 0 uses std::thread::hardware_concurrency().
+        unsigned threads = 0;
+    };
+
+    // Parsed edge list. vertices holds every endpoint once, sorted. symmetric is set for
+    // Matrix Market files declared symmetric, where each entry stands for both directions.
+    template <typename VertexType, typename EdgeType>
+    struct EdgeList
+    {
+        struct Edge
+        {
+            VertexType src;
+            VertexType dest;
+            EdgeType value;
+        };
+
+        std::vector<VertexType> vertices;
+        std::vector<Edge> edges;
+        bool symmetric = false;
+    };
+
+    namespace detail
+    {
+        // Below this many bytes per thread, splitting the file is not worth it.
+        inline constexpr size_t minEdgeListChunk = size_t{1} << 20;
+
+        struct EdgeListLayout
+        {
+            EdgeListFormat format;
+            size_t dataBegin;
+            bool symmetric;
+            bool hasValues;
+        };
+
+        inline bool isFieldSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        inline bool isCommentLine(const char *line, const char *end)
+        {
+            while (line < end && isFieldSpace(*line))
+                ++line;
+            return line == end || *line == '#' || *line == '%';
+        }
+
+        inline const char *lineEnd(const char *pos, const char *end)
+        {
+            const void *newline = std::memchr(pos, '\n', static_cast<size_t>(end - pos));
+            return newline ? static_cast<const char *>(newline) : end;
+        }
+
+        // Reads the next field of a record and advances pos past it and its separator.
+        inline std::string_view nextField(const char *&pos, const char *end, char separator)
+        {
+            while (pos < end && isFieldSpace(*pos))
+                ++pos;
+            const char *begin = pos;
+            while (pos < end && *pos != separator && !(separator == ' ' && isFieldSpace(*pos)))
+                ++pos;
+            const char *fieldEnd = pos;
+            while (fieldEnd > begin && isFieldSpace(fieldEnd[-1]))
+                --fieldEnd;
+            if (pos < end && *pos == separator)
+                ++pos;
+            return std::string_view(begin, static_cast<size_t>(fieldEnd - begin));
+        }
+
+        template <typename T>
+        bool parseField(std::string_view field, T &out)
+        {
+            if (field.empty())
+                return false;
+            if constexpr (std::is_same_v<T, std::string>)
+            {
+                out.assign(field);
+                return true;
+            }
+            else
+            {
+                static_assert(std::is_arithmetic_v<T>, "Edge lists can only be parsed into arithmetic types or std::string.");
+                const char *first = field.data();
+                const char *last = first + field.size();
+                if (*first == '+')
+                    ++first;
+                auto [ptr, ec] = std::from_chars(first, last, out);
+                return ec == std::errc() && ptr == last;
+            }
+        }
+
+        inline char edgeListSeparator(EdgeListFormat format)
+        {
+            return format == EdgeListFormat::CSV ? ',' : ' ';
+        }
+
+        inline bool startsWith(const char *pos, const char *end, std::string_view prefix)
+        {
+            return static_cast<size_t>(end - pos) >= prefix.size() && std::string_view(pos, prefix.size()) == prefix;
+        }
+
+        // Detects the format and finds where the records start, so that every chunk after
+        // that point can be parsed the same way.
+        template <typename VertexType>
+        EdgeListLayout edgeListLayout(const char *begin, const char *end, EdgeListFormat format)
+        {
+            EdgeListLayout layout{format, 0, false, true};
+
+            if (format == EdgeListFormat::Auto && startsWith(begin, end, "%%MatrixMarket"))
+                layout.format = EdgeListFormat::MatrixMarket;
+
+            const char *pos = begin;
+            if (layout.format == EdgeListFormat::MatrixMarket)
+            {
+                const char *bannerEnd = lineEnd(pos, end);
+                std::string banner(pos, bannerEnd);
+                std::transform(banner.begin(), banner.end(), banner.begin(), [](unsigned char c)
+                               { return static_cast<char>(std::tolower(c)); });
+                if (banner.find("coordinate") == std::string::npos)
+                    throw std::runtime_error("Only coordinate Matrix Market files can be read as edge lists");
+                layout.symmetric = banner.find("symmetric") != std::string::npos || banner.find("hermitian") != std::string::npos;
+                layout.hasValues = banner.find("pattern") == std::string::npos;
+
+                // skip comments and the size line.
+                bool sizeLineSeen = false;
+                while (pos < end && !sizeLineSeen)
+                {
+                    const char *next = lineEnd(pos, end);
+                    if (!isCommentLine(pos, next))
+                        sizeLineSeen = true;
+                    pos = next < end ? next + 1 : end;
+                }
+                layout.dataBegin = static_cast<size_t>(pos - begin);
+                return layout;
+            }
+
+            while (pos < end)
+            {
+                const char *next = lineEnd(pos, end);
+                if (!isCommentLine(pos, next))
+                {
+                    if (layout.format == EdgeListFormat::Auto)
+                    {
+                        layout.format = std::memchr(pos, ',', static_cast<size_t>(next - pos)) ? EdgeListFormat::CSV : EdgeListFormat::Whitespace;
+                    }
+                    if (layout.format == EdgeListFormat::CSV)
+                    {
+                        const char *field = pos;
+                        VertexType probe{};
+                        if (!parseField(nextField(field, next, ','), probe))
+                            pos = next < end ? next + 1 : end;
+                    }
+                    break;
+                }
+                pos = next < end ? next + 1 : end;
+            }
+            if (layout.format == EdgeListFormat::Auto)
+                layout.format = EdgeListFormat::Whitespace;
+            layout.dataBegin = static_cast<size_t>(pos - begin);
+            return layout;
+        }
+
+        inline size_t countEdgeRecords(const char *pos, const char *end)
+        {
+            size_t records = 0;
+            while (pos < end)
+            {
+                const char *next = lineEnd(pos, end);
+                records += !isCommentLine(pos, next);
+                pos = next < end ? next + 1 : end;
+            }
+            return records;
+        }
+
+        template <typename VertexType, typename EdgeType>
+        void parseEdgeRecords(const char *pos, const char *end, const char *fileBegin, const EdgeListLayout &layout,
+                              typename EdgeList<VertexType, EdgeType>::Edge *out)
+        {
+            const char separator = edgeListSeparator(layout.format);
+            while (pos < end)
+            {
+                const char *next = lineEnd(pos, end);
+                if (!isCommentLine(pos, next))
+                {
+                    const char *field = pos;
+                    auto &edge = *out++;
+                    bool ok = parseField(nextField(field, next, separator), edge.src) &&
+                              parseField(nextField(field, next, separator), edge.dest);
+                    if constexpr (!std::is_same_v<EdgeType, UnweightedG>)
+                    {
+                        std::string_view value = layout.hasValues ? nextField(field, next, separator) : std::string_view();
+                        if (value.empty())
+                            edge.value = EdgeType(1);
+                        else
+                            ok = ok && parseField(value, edge.value);
+                    }
+                    if (!ok)
+                    {
+                        throw std::runtime_error("Malformed edge list record at byte " + std::to_string(pos - fileBegin));
+                    }
+                }
+                pos = next < end ? next + 1 : end;
+            }
+        }
+
+        // Runs func(chunk) on one thread per chunk and rethrows the first failure.
+        template <typename Func>
+        void forEachChunk(size_t chunks, Func func)
+        {
+            std::vector<std::exception_ptr> errors(chunks);
+            std::vector<std::thread> workers;
+            workers.reserve(chunks);
+            for (size_t chunk = 0; chunk < chunks; ++chunk)
+            {
+                workers.emplace_back([&, chunk]
+                                     {
+                    try
+                    {
+                        func(chunk);
+                    }
+                    catch (...)
+                    {
+                        errors[chunk] = std::current_exception();
+                    } });
+            }
+            for (auto &worker : workers)
+                worker.join();
+            for (auto &error : errors)
+            {
+                if (error)
+                    std::rethrow_exception(error);
+            }
+        }
+    }
+
+    // Reads an edge list file. The file is memory mapped and split at line boundaries into
+    // one chunk per thread. A first parallel pass counts the records of each chunk, so the
+    // edge array is allocated once and every thread parses straight into its own slice in the
+    // second pass. Each thread then sorts and deduplicates the endpoints of its slice, and
+    // the slices are merged into the vertex list.
+    template <typename VertexType, typename EdgeType>
+    EdgeList<VertexType, EdgeType> readEdgeList(const std::string &path, EdgeListOptions options = {})
+    {
+        using Edge = typename EdgeList<VertexType, EdgeType>::Edge;
+
+        MappedFile file(path);
+        file.advise(MappedAccess::Sequential);
+        const char *begin = reinterpret_cast<const char *>(file.data());
+        const char *end = begin + file.size();
+
+        detail::EdgeListLayout layout = detail::edgeListLayout<VertexType>(begin, end, options.format);
+        const char *dataBegin = begin + layout.dataBegin;
+        const size_t dataSize = static_cast<size_t>(end - dataBegin);
+
+        size_t threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+        threads = std::max<size_t>(1, std::min(threads, dataSize / detail::minEdgeListChunk + 1));
+
+        std::vector<const char *> bounds(threads + 1, end);
+        bounds[0] = dataBegin;
+        for (size_t t = 1; t < threads; ++t)
+        {
+            const char *pos = std::max(bounds[t - 1], dataBegin + dataSize / threads * t);
+            pos = detail::lineEnd(pos, end);
+            bounds[t] = pos < end ? pos + 1 : end;
+        }
+
+        // pass 1: count records per chunk.
+        std::vector<size_t> offsets(threads + 1, 0);
+        detail::forEachChunk(threads, [&](size_t chunk)
+                             { offsets[chunk + 1] = detail::countEdgeRecords(bounds[chunk], bounds[chunk + 1]); });
+        for (size_t t = 0; t < threads; ++t)
+            offsets[t + 1] += offsets[t];
+
+        // pass 2: parse into the preallocated slices and collect endpoints.
+        EdgeList<VertexType, EdgeType> result;
+        result.symmetric = layout.symmetric;
+        result.edges.resize(offsets[threads]);
+        std::vector<std::vector<VertexType>> endpoints(threads);
+        detail::forEachChunk(threads, [&](size_t chunk)
+                             {
+            Edge *slice = result.edges.data() + offsets[chunk];
+            detail::parseEdgeRecords<VertexType, EdgeType>(bounds[chunk], bounds[chunk + 1], begin, layout, slice);
+
+            auto &local = endpoints[chunk];
+            local.reserve(2 * (offsets[chunk + 1] - offsets[chunk]));
+            for (Edge *edge = slice; edge != result.edges.data() + offsets[chunk + 1]; ++edge)
+            {
+                local.push_back(edge->src);
+                local.push_back(edge->dest);
+            }
+            std::sort(local.begin(), local.end());
+            local.erase(std::unique(local.begin(), local.end()), local.end()); });
+
+        for (auto &local : endpoints)
+        {
+            size_t middle = result.vertices.size();
+            result.vertices.insert(result.vertices.end(), std::make_move_iterator(local.begin()), std::make_move_iterator(local.end()));
+            std::inplace_merge(result.vertices.begin(), result.vertices.begin() + middle, result.vertices.end());
+            result.vertices.erase(std::unique(result.vertices.begin(), result.vertices.end()), result.vertices.end());
+            std::vector<VertexType>().swap(local);
+        }
+        return result;
+    }
+
+    namespace detail
+    {
+        // Adds the vertices of list to graph and returns the graph index of each of them.
+        // When all of them are new this is a run from the old vertex count and needs no
+        // lookups.
+        template <typename Graph, typename VertexType, typename EdgeType>
+        std::vector<size_t> addEdgeListVertices(Graph &graph, const EdgeList<VertexType, EdgeType> &list)
+        {
+            size_t firstIndex = graph.getNumVertices();
+            graph.addVertices(list.vertices);
+            std::vector<size_t> indices(list.vertices.size());
+            if (graph.getNumVertices() - firstIndex == list.vertices.size())
+            {
+                std::iota(indices.begin(), indices.end(), firstIndex);
+            }
+            else
+            {
+                for (size_t i = 0; i < indices.size(); ++i)
+                    indices[i] = graph.getIndexOf(list.vertices[i]);
+            }
+            return indices;
+        }
+
+        // The edges of list as (srcIndex, destIndex, value) tuples. Endpoints are found by
+        // binary search in the sorted vertex list instead of hashing them through the graph.
+        template <typename VertexType, typename EdgeType>
+        auto edgeListIndices(const EdgeList<VertexType, EdgeType> &list, const std::vector<size_t> &indices, bool reversed)
+        {
+            auto indexOf = [&list, &indices](const VertexType &vertex)
+            {
+                return indices[std::lower_bound(list.vertices.begin(), list.vertices.end(), vertex) - list.vertices.begin()];
+            };
+            return list.edges | std::views::transform([indexOf, reversed](const auto &edge)
+                                                      {
+                                                          size_t src = indexOf(edge.src);
+                                                          size_t dest = indexOf(edge.dest);
+                                                          if (reversed)
+                                                              std::swap(src, dest);
+                                                          return std::tuple<size_t, size_t, const EdgeType &>(src, dest, edge.value); });
+        }
+    }
+
+    // Adds a parsed or generated edge list to graph. All vertices are added in one
+    // addVertices call, so the matrix is laid out once, and the edges go in through the
+    // index level addEdgesAt. Edges of a symmetric list are added in both directions (as
+    // undirected edges for MixedGraphMatrix).
+    template <typename VertexType, typename EdgeType, typename Direction, typename Storage>
+    void addEdgeList(GraphMatrix<VertexType, EdgeType, Direction, Storage> &graph, const EdgeList<VertexType, EdgeType> &list)
+    {
+        std::vector<size_t> indices = detail::addEdgeListVertices(graph, list);
+        graph.addEdgesAt(detail::edgeListIndices(list, indices, false));
+        if (list.symmetric)
+            graph.addEdgesAt(detail::edgeListIndices(list, indices, true));
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void addEdgeList(MixedGraphMatrix<VertexType, EdgeType, Storage> &graph, const EdgeList<VertexType, EdgeType> &list)
+    {
+        std::vector<size_t> indices = detail::addEdgeListVertices(graph, list);
+        graph.addEdgesAt(detail::edgeListIndices(list, indices, false), !list.symmetric);
+    }
+
+    // Reads an edge list and adds it to graph through addEdgeList. Entries of a symmetric
+    // Matrix Market file are added in both directions.
+    template <typename VertexType, typename EdgeType, typename Direction, typename Storage>
+    void loadEdgeList(GraphMatrix<VertexType, EdgeType, Direction, Storage> &graph, const std::string &path, EdgeListOptions options = {})
+    {
+        addEdgeList(graph, readEdgeList<VertexType, EdgeType>(path, options));
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void loadEdgeList(MixedGraphMatrix<VertexType, EdgeType, Storage> &graph, const std::string &path, EdgeListOptions options = {})
+    {
+        addEdgeList(graph, readEdgeList<VertexType, EdgeType>(path, options));
+    }
+}
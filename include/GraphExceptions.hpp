@@ -1,10 +1,15 @@
 #pragma once
 
+#include <cstdint>
 #include <exception>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <type_traits>
 #include <typeinfo>
+#include <utility>
+#include <variant>
 
 namespace Appledore {
 
@@ -195,4 +200,128 @@ namespace Appledore {
         }
     };
 
+    // Why a try* member of GraphMatrix or MixedGraphMatrix failed. Only the code is kept;
+    // the message is formatted on request, from the vertices of the call, by
+    // graphErrorMessage or throwGraphError.
+    enum class GraphError : uint8_t {
+        VertexNotFound, // the vertex of a single vertex call
+        SourceNotFound,
+        TargetNotFound,
+        EdgeNotFound
+    };
+
+    namespace detail {
+        // VertexNotFoundException(const std::string&) takes a whole message, so string
+        // vertices are formatted here.
+        template<typename V>
+        VertexNotFoundException vertexNotFound(const V& vertex) {
+            if constexpr (std::is_same_v<V, std::string>)
+                return VertexNotFoundException("Vertex not found: " + vertex);
+            else
+                return VertexNotFoundException(vertex);
+        }
+    }
+
+    template<typename V>
+    std::string graphErrorMessage(GraphError error, const V& source, const V& target) {
+        switch (error) {
+        case GraphError::TargetNotFound:
+            return detail::vertexNotFound(target).message();
+        case GraphError::EdgeNotFound:
+            return EdgeNotFoundException(source, target).message();
+        default:
+            return detail::vertexNotFound(source).message();
+        }
+    }
+
+    template<typename V>
+    std::string graphErrorMessage(GraphError error, const V& vertex) {
+        return graphErrorMessage(error, vertex, vertex);
+    }
+
+    // Throws the GraphException matching error, for callers that want the failure of a
+    // try* call to propagate after all.
+    template<typename V>
+    [[noreturn]] void throwGraphError(GraphError error, const V& source, const V& target) {
+        switch (error) {
+        case GraphError::TargetNotFound:
+            throw detail::vertexNotFound(target);
+        case GraphError::EdgeNotFound:
+            throw EdgeNotFoundException(source, target);
+        default:
+            throw detail::vertexNotFound(source);
+        }
+    }
+
+    template<typename V>
+    [[noreturn]] void throwGraphError(GraphError error, const V& vertex) {
+        throwGraphError(error, vertex, vertex);
+    }
+
+    // Value or GraphError returned by the try* members; the subset of
+    // std::expected<T, GraphError> they need, as the library builds as C++20. T may be an
+    // lvalue reference, which then refers into the graph and is valid until the graph is
+    // modified. GraphResult<> only reports success or the error.
+    template<typename T = void>
+    class [[nodiscard]] GraphResult {
+        using Stored = std::conditional_t<std::is_reference_v<T>, std::remove_reference_t<T>*, T>;
+
+    public:
+        GraphResult(T value) requires(!std::is_reference_v<T>)
+            : m_state(std::in_place_index<0>, std::move(value))
+        {}
+
+        GraphResult(T value) requires(std::is_reference_v<T>)
+            : m_state(std::in_place_index<0>, std::addressof(value))
+        {}
+
+        GraphResult(GraphError error)
+            : m_state(std::in_place_index<1>, error)
+        {}
+
+        bool has_value() const { return m_state.index() == 0; }
+        explicit operator bool() const { return has_value(); }
+
+        // The value, only when has_value().
+        decltype(auto) operator*() const {
+            if constexpr (std::is_reference_v<T>)
+                return static_cast<T>(**std::get_if<0>(&m_state));
+            else
+                return static_cast<const T&>(*std::get_if<0>(&m_state));
+        }
+
+        const std::remove_reference_t<T>* operator->() const { return std::addressof(**this); }
+
+        // The error, only when !has_value().
+        GraphError error() const { return *std::get_if<1>(&m_state); }
+
+        template<typename U>
+        std::remove_cvref_t<T> value_or(U&& fallback) const {
+            if (has_value())
+                return **this;
+            return static_cast<std::remove_cvref_t<T>>(std::forward<U>(fallback));
+        }
+
+    private:
+        std::variant<Stored, GraphError> m_state;
+    };
+
+    template<>
+    class [[nodiscard]] GraphResult<void> {
+    public:
+        GraphResult() = default;
+
+        GraphResult(GraphError error)
+            : m_error(error)
+        {}
+
+        bool has_value() const { return !m_error.has_value(); }
+        explicit operator bool() const { return has_value(); }
+
+        GraphError error() const { return *m_error; }
+
+    private:
+        std::optional<GraphError> m_error;
+    };
+
 } // namespace Appledore
@@ -0,0 +1,403 @@
+#pragma once
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "GraphMatrix.hpp"
+#include "MixedGraph.hpp"
+
+namespace Appledore
+{
+    // Text output with a fixed size buffer in front of a std::ostream. Numbers are written
+    // with std::to_chars. While an escape mode is set, text is escaped for XML attributes or
+    // DOT quoted strings; the exporters set it around user formatted labels.
+    class BufferedSink
+    {
+    public:
+        enum class Escape
+        {
+            None,
+            Xml,
+            Dot
+        };
+
+        explicit BufferedSink(std::ostream &out, size_t capacity = size_t{1} << 16)
+            : out(out), buffer(capacity) {}
+
+        BufferedSink(const BufferedSink &) = delete;
+        BufferedSink &operator=(const BufferedSink &) = delete;
+
+        ~BufferedSink()
+        {
+            try
+            {
+                flush();
+            }
+            catch (...)
+            {
+            }
+        }
+
+        BufferedSink &operator<<(std::string_view text)
+        {
+            if (escape == Escape::None)
+            {
+                write(text.data(), text.size());
+                return *this;
+            }
+            for (char c : text)
+            {
+                *this << c;
+            }
+            return *this;
+        }
+
+        BufferedSink &operator<<(const char *text)
+        {
+            return *this << std::string_view(text);
+        }
+
+        BufferedSink &operator<<(const std::string &text)
+        {
+            return *this << std::string_view(text);
+        }
+
+        BufferedSink &operator<<(char c)
+        {
+            std::string_view replacement = escaped(c);
+            if (replacement.empty())
+                put(c);
+            else
+                write(replacement.data(), replacement.size());
+            return *this;
+        }
+
+        template <typename T>
+            requires(std::is_arithmetic_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>)
+        BufferedSink &operator<<(T value)
+        {
+            char digits[64];
+            auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+            write(digits, static_cast<size_t>(end - digits));
+            return *this;
+        }
+
+        void setEscape(Escape mode) { escape = mode; }
+
+        void flush()
+        {
+            if (used)
+            {
+                out.write(buffer.data(), static_cast<std::streamsize>(used));
+                used = 0;
+            }
+            out.flush();
+        }
+
+    private:
+        std::ostream &out;
+        std::vector<char> buffer;
+        size_t used = 0;
+        Escape escape = Escape::None;
+
+        void put(char c)
+        {
+            if (used == buffer.size())
+                drain();
+            buffer[used++] = c;
+        }
+
+        void write(const char *data, size_t size)
+        {
+            if (size > buffer.size() - used)
+            {
+                drain();
+                if (size > buffer.size())
+                {
+                    out.write(data, static_cast<std::streamsize>(size));
+                    return;
+                }
+            }
+            std::char_traits<char>::copy(buffer.data() + used, data, size);
+            used += size;
+        }
+
+        void drain()
+        {
+            out.write(buffer.data(), static_cast<std::streamsize>(used));
+            used = 0;
+        }
+
+        std::string_view escaped(char c) const
+        {
+            if (escape == Escape::Xml)
+            {
+                switch (c)
+                {
+                case '&':
+                    return "&amp;";
+                case '<':
+                    return "&lt;";
+                case '>':
+                    return "&gt;";
+                case '"':
+                    return "&quot;";
+                case '\'':
+                    return "&apos;";
+                }
+            }
+            else if (escape == Escape::Dot)
+            {
+                switch (c)
+                {
+                case '"':
+                    return "\\\"";
+                case '\\':
+                    return "\\\\";
+                case '\n':
+                    return "\\n";
+                }
+            }
+            return {};
+        }
+    };
+
+    // Formatter used when none is given. Writes numbers and strings directly, GraphVertex/
+    // GraphEdge types by name, and anything else through its operator<<.
+    struct DefaultFormatter
+    {
+        template <typename T>
+        void operator()(BufferedSink &out, const T &value) const
+        {
+            if constexpr (std::is_arithmetic_v<T> || std::is_convertible_v<const T &, std::string_view>)
+            {
+                out << value;
+            }
+            else if constexpr (std::is_base_of_v<GraphVertex, T> || std::is_base_of_v<GraphEdge, T>)
+            {
+                out << value.name();
+            }
+            else
+            {
+                static_assert(requires(std::ostream &os) { os << value; },
+                              "No operator<< for this type, pass a formatter to the exporter.");
+                std::ostringstream text;
+                text << value;
+                out << text.str();
+            }
+        }
+    };
+
+    namespace detail
+    {
+        template <typename VertexType, typename EdgeType, typename Direction, typename Storage>
+        constexpr bool isMixedGraph(const GraphMatrix<VertexType, EdgeType, Direction, Storage> *) { return false; }
+        template <typename VertexType, typename EdgeType, typename Storage>
+        constexpr bool isMixedGraph(const MixedGraphMatrix<VertexType, EdgeType, Storage> *) { return true; }
+
+        template <typename VertexType, typename EdgeType, typename Direction, typename Storage>
+        constexpr bool isUndirectedGraph(const GraphMatrix<VertexType, EdgeType, Direction, Storage> *) { return std::is_same_v<Direction, UndirectedG>; }
+        template <typename VertexType, typename EdgeType, typename Storage>
+        constexpr bool isUndirectedGraph(const MixedGraphMatrix<VertexType, EdgeType, Storage> *) { return false; }
+
+        template <typename VertexType, typename EdgeType, typename Direction, typename Storage>
+        EdgeType exportEdgeType(const GraphMatrix<VertexType, EdgeType, Direction, Storage> *);
+        template <typename VertexType, typename EdgeType, typename Storage>
+        EdgeType exportEdgeType(const MixedGraphMatrix<VertexType, EdgeType, Storage> *);
+
+        template <typename Graph>
+        inline constexpr bool mixedGraph = isMixedGraph(static_cast<const Graph *>(nullptr));
+        template <typename Graph>
+        inline constexpr bool undirectedGraph = isUndirectedGraph(static_cast<const Graph *>(nullptr));
+        template <typename Graph>
+        inline constexpr bool weightedGraph = !std::is_same_v<decltype(exportEdgeType(static_cast<const Graph *>(nullptr))), UnweightedG>;
+
+        // Calls func(src, dest, directed) for every edge, walking the matrix row by row.
+        // Undirected edges are reported once, with src <= dest, unless bothDirections is set.
+        // An undirected cell of a MixedGraphMatrix whose reverse cell is directed (one
+        // direction of an undirected edge added again as directed) is reported on its own.
+        template <typename Graph, typename Func>
+        void forEachExportEdge(const Graph &graph, bool bothDirections, Func &&func)
+        {
+            const size_t numVertices = graph.getNumVertices();
+            for (size_t src = 0; src < numVertices; ++src)
+            {
+                for (size_t dest = 0; dest < numVertices; ++dest)
+                {
+                    if (!graph.hasEdgeAt(src, dest))
+                        continue;
+
+                    bool directed;
+                    if constexpr (mixedGraph<Graph>)
+                        directed = graph.isDirectedAt(src, dest);
+                    else
+                        directed = !undirectedGraph<Graph>;
+
+                    bool mirrored = false;
+                    if (!directed && src > dest)
+                    {
+                        if constexpr (mixedGraph<Graph>)
+                            mirrored = graph.hasEdgeAt(dest, src) && !graph.isDirectedAt(dest, src);
+                        else
+                            mirrored = true;
+                    }
+                    if (bothDirections || !mirrored)
+                        func(src, dest, directed);
+                }
+            }
+        }
+
+        template <typename Formatter, typename Value>
+        void writeLabel(BufferedSink &out, BufferedSink::Escape escape, Formatter &format, const Value &value)
+        {
+            out.setEscape(escape);
+            format(out, value);
+            out.setEscape(BufferedSink::Escape::None);
+        }
+    }
+
+    // Edge list, one "src dest [value]" line per edge, readable by loadEdgeList. Undirected
+    // edges are written once; undirected edges of a MixedGraphMatrix are written in both
+    // directions, since the format has no per edge direction.
+    template <typename Graph, typename VertexFormatter = DefaultFormatter, typename EdgeFormatter = DefaultFormatter>
+    void writeEdgeList(const Graph &graph, std::ostream &stream, VertexFormatter formatVertex = {}, EdgeFormatter formatEdge = {})
+    {
+        BufferedSink out(stream);
+        detail::forEachExportEdge(graph, detail::mixedGraph<Graph>, [&](size_t src, size_t dest, bool)
+                                  {
+            formatVertex(out, graph.getVertexAt(src));
+            out << ' ';
+            formatVertex(out, graph.getVertexAt(dest));
+            if constexpr (detail::weightedGraph<Graph>)
+            {
+                out << ' ';
+                formatEdge(out, graph.getEdgeAt(src, dest));
+            }
+            out << '\n'; });
+        out.flush();
+    }
+
+    // Matrix Market coordinate format. Rows and columns are 1-based vertex indices in the
+    // order of getVertices(). Undirected graphs are written as symmetric (lower triangle),
+    // unweighted graphs as pattern. The entry count is taken with a first pass over the
+    // matrix, so nothing is buffered.
+    template <typename Graph, typename EdgeFormatter = DefaultFormatter>
+    void writeMatrixMarket(const Graph &graph, std::ostream &stream, EdgeFormatter formatEdge = {})
+    {
+        using EdgeType = decltype(detail::exportEdgeType(static_cast<const Graph *>(nullptr)));
+        constexpr bool weighted = detail::weightedGraph<Graph>;
+        constexpr bool symmetric = detail::undirectedGraph<Graph>;
+
+        size_t entries = 0;
+        detail::forEachExportEdge(graph, !symmetric, [&](size_t, size_t, bool)
+                                  { ++entries; });
+
+        BufferedSink out(stream);
+        out << "%%MatrixMarket matrix coordinate "
+            << (!weighted ? "pattern" : std::is_integral_v<EdgeType> ? "integer" : "real")
+            << (symmetric ? " symmetric\n" : " general\n");
+        out << graph.getNumVertices() << ' ' << graph.getNumVertices() << ' ' << entries << '\n';
+
+        detail::forEachExportEdge(graph, !symmetric, [&](size_t src, size_t dest, bool)
+                                  {
+            // symmetric files store the lower triangle.
+            if (symmetric)
+                std::swap(src, dest);
+            out << src + 1 << ' ' << dest + 1;
+            if constexpr (weighted)
+            {
+                out << ' ';
+                formatEdge(out, graph.getEdgeAt(src, dest));
+            }
+            out << '\n'; });
+        out.flush();
+    }
+
+    // GraphML. Vertices get ids n0, n1, ... and a "label" attribute; weighted edges a
+    // "weight" attribute. Mixed graphs set edgedefault="directed" and mark undirected edges
+    // with directed="false".
+    template <typename Graph, typename VertexFormatter = DefaultFormatter, typename EdgeFormatter = DefaultFormatter>
+    void writeGraphML(const Graph &graph, std::ostream &stream, VertexFormatter formatVertex = {}, EdgeFormatter formatEdge = {})
+    {
+        constexpr bool weighted = detail::weightedGraph<Graph>;
+        BufferedSink out(stream);
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+            << "  <key id=\"label\" for=\"node\" attr.name=\"label\" attr.type=\"string\"/>\n";
+        if (weighted)
+            out << "  <key id=\"weight\" for=\"edge\" attr.name=\"weight\" attr.type=\"string\"/>\n";
+        out << "  <graph id=\"G\" edgedefault=\"" << (detail::undirectedGraph<Graph> ? "undirected" : "directed") << "\">\n";
+
+        for (size_t i = 0; i < graph.getNumVertices(); ++i)
+        {
+            out << "    <node id=\"n" << i << "\"><data key=\"label\">";
+            detail::writeLabel(out, BufferedSink::Escape::Xml, formatVertex, graph.getVertexAt(i));
+            out << "</data></node>\n";
+        }
+
+        detail::forEachExportEdge(graph, false, [&](size_t src, size_t dest, bool directed)
+                                  {
+            out << "    <edge source=\"n" << src << "\" target=\"n" << dest << '"';
+            if (detail::mixedGraph<Graph> && !directed)
+                out << " directed=\"false\"";
+            if constexpr (weighted)
+            {
+                out << "><data key=\"weight\">";
+                detail::writeLabel(out, BufferedSink::Escape::Xml, formatEdge, graph.getEdgeAt(src, dest));
+                out << "</data></edge>\n";
+            }
+            else
+            {
+                out << "/>\n";
+            } });
+
+        out << "  </graph>\n</graphml>\n";
+        out.flush();
+    }
+
+    // Graphviz DOT. Mixed graphs are written as a digraph with dir=none on undirected edges.
+    template <typename Graph, typename VertexFormatter = DefaultFormatter, typename EdgeFormatter = DefaultFormatter>
+    void writeDot(const Graph &graph, std::ostream &stream, VertexFormatter formatVertex = {}, EdgeFormatter formatEdge = {})
+    {
+        constexpr bool undirected = detail::undirectedGraph<Graph>;
+        BufferedSink out(stream);
+        out << (undirected ? "graph G {\n" : "digraph G {\n");
+
+        for (size_t i = 0; i < graph.getNumVertices(); ++i)
+        {
+            out << "  n" << i << " [label=\"";
+            detail::writeLabel(out, BufferedSink::Escape::Dot, formatVertex, graph.getVertexAt(i));
+            out << "\"];\n";
+        }
+
+        detail::forEachExportEdge(graph, false, [&](size_t src, size_t dest, bool directed)
+                                  {
+            out << "  n" << src << (undirected ? " -- n" : " -> n") << dest;
+            bool undirectedInDigraph = detail::mixedGraph<Graph> && !directed;
+            if (detail::weightedGraph<Graph> || undirectedInDigraph)
+            {
+                out << " [";
+                if constexpr (detail::weightedGraph<Graph>)
+                {
+                    out << "label=\"";
+                    detail::writeLabel(out, BufferedSink::Escape::Dot, formatEdge, graph.getEdgeAt(src, dest));
+                    out << '"';
+                    if (undirectedInDigraph)
+                        out << ", ";
+                }
+                if (undirectedInDigraph)
+                    out << "dir=none";
+                out << ']';
+            }
+            out << ";\n"; });
+
+        out << "}\n";
+        out.flush();
+    }
+}
@@ -0,0 +1,328 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "EdgeListLoader.hpp"
+
+namespace Appledore
+{
+    struct GeneratorOptions
+    {
+        uint64_t seed = 1;
+        // 0 uses std::thread::hardware_concurrency().
+        unsigned threads = 0;
+        // Edge values are drawn uniformly from [minWeight, maxWeight], inclusive for
+        // integral edge types. Ignored for UnweightedG.
+        double minWeight = 1.0;
+        double maxWeight = 1.0;
+    };
+
+    // R-MAT quadrant probabilities, d = 1 - a - b - c. The defaults are the Graph500 ones.
+    struct RmatParameters
+    {
+        double a = 0.57;
+        double b = 0.19;
+        double c = 0.19;
+    };
+
+    namespace detail
+    {
+        // Work is cut into blocks whose boundaries depend only on the graph size, and every
+        // block draws from its own generator seeded from (seed, block). Threads take
+        // contiguous runs of blocks and the blocks are concatenated in order, so the output
+        // is the same for any thread count.
+        inline constexpr size_t generatorRowsPerBlock = 1024;
+        inline constexpr size_t generatorEdgesPerBlock = size_t{1} << 16;
+
+        inline uint64_t mix64(uint64_t x)
+        {
+            x += 0x9e3779b97f4a7c15ULL;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        // SplitMix64. The distributions are spelled out here rather than taken from
+        // <random>, whose results differ between standard libraries.
+        struct GeneratorRng
+        {
+            uint64_t state;
+
+            explicit GeneratorRng(uint64_t seed) : state(seed) {}
+
+            uint64_t next()
+            {
+                state += 0x9e3779b97f4a7c15ULL;
+                return mix64(state - 0x9e3779b97f4a7c15ULL);
+            }
+
+            // uniform in [0, 1)
+            double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+            // uniform in [0, bound), bound > 0
+            size_t below(size_t bound) { return static_cast<size_t>(next() % bound); }
+        };
+
+        inline uint64_t blockSeed(uint64_t seed, uint64_t stream, size_t block)
+        {
+            return mix64(mix64(seed ^ mix64(stream)) + block);
+        }
+
+        template <typename EdgeType>
+        EdgeType drawWeight(GeneratorRng &rng, const GeneratorOptions &options)
+        {
+            if constexpr (std::is_same_v<EdgeType, UnweightedG>)
+            {
+                return EdgeType{};
+            }
+            else if constexpr (std::is_integral_v<EdgeType>)
+            {
+                auto low = static_cast<long long>(std::ceil(options.minWeight));
+                auto high = static_cast<long long>(std::floor(options.maxWeight));
+                if (high <= low)
+                    return static_cast<EdgeType>(low);
+                return static_cast<EdgeType>(low + static_cast<long long>(rng.below(static_cast<size_t>(high - low) + 1)));
+            }
+            else
+            {
+                static_assert(std::is_floating_point_v<EdgeType>, "Generated edge values must be arithmetic or UnweightedG.");
+                return static_cast<EdgeType>(options.minWeight + rng.uniform() * (options.maxWeight - options.minWeight));
+            }
+        }
+
+        // Runs block(index, rng, emit) for every block and collects the emitted (src, dest)
+        // pairs into an edge list over the vertices 0 .. numVertices-1.
+        template <typename VertexType, typename EdgeType, typename Block>
+        EdgeList<VertexType, EdgeType> generateEdgeList(size_t numVertices, size_t numBlocks, bool symmetric,
+                                                        const GeneratorOptions &options, uint64_t stream, Block block)
+        {
+            static_assert(std::is_arithmetic_v<VertexType>, "Generated vertices are numbered, use an arithmetic vertex type.");
+            using Edge = typename EdgeList<VertexType, EdgeType>::Edge;
+
+            size_t threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+            threads = std::max<size_t>(1, std::min(threads, numBlocks));
+
+            std::vector<std::vector<Edge>> parts(numBlocks);
+            forEachChunk(threads, [&](size_t chunk)
+                         {
+                for (size_t b = numBlocks * chunk / threads; b < numBlocks * (chunk + 1) / threads; ++b)
+                {
+                    GeneratorRng rng(blockSeed(options.seed, stream, b));
+                    GeneratorRng weights(blockSeed(options.seed, ~stream, b));
+                    auto &out = parts[b];
+                    block(b, rng, [&](size_t src, size_t dest)
+                          { out.push_back(Edge{static_cast<VertexType>(src), static_cast<VertexType>(dest), drawWeight<EdgeType>(weights, options)}); });
+                } });
+
+            EdgeList<VertexType, EdgeType> result;
+            result.symmetric = symmetric;
+            size_t total = 0;
+            for (const auto &part : parts)
+                total += part.size();
+            result.edges.reserve(total);
+            for (auto &part : parts)
+            {
+                result.edges.insert(result.edges.end(), part.begin(), part.end());
+                std::vector<Edge>().swap(part);
+            }
+            result.vertices.reserve(numVertices);
+            for (size_t v = 0; v < numVertices; ++v)
+                result.vertices.push_back(static_cast<VertexType>(v));
+            return result;
+        }
+
+        inline void checkProbability(double p, const char *what)
+        {
+            if (!(p >= 0.0 && p <= 1.0))
+            {
+                throw std::invalid_argument(std::string(what) + " must be between 0 and 1");
+            }
+        }
+
+        // G(n, p) rows by geometric skipping (Batagelj and Brandes), O(n + m) instead of
+        // one coin flip per vertex pair. upper keeps only src < dest.
+        template <typename VertexType, typename EdgeType>
+        EdgeList<VertexType, EdgeType> bernoulliRows(size_t numVertices, double p, bool upper, bool symmetric,
+                                                     const GeneratorOptions &options, uint64_t stream)
+        {
+            checkProbability(p, "Edge probability");
+            const size_t numBlocks = (numVertices + generatorRowsPerBlock - 1) / generatorRowsPerBlock;
+            const double logMiss = std::log1p(-p);
+            return generateEdgeList<VertexType, EdgeType>(numVertices, p > 0.0 ? numBlocks : 0, symmetric, options, stream,
+                                                          [&](size_t b, GeneratorRng &rng, auto &&emit)
+                                                          {
+                // candidates of row src skipped before the next edge.
+                auto skip = [&](size_t candidates) -> size_t
+                {
+                    if (p >= 1.0)
+                        return 0;
+                    double gap = std::floor(std::log(1.0 - rng.uniform()) / logMiss);
+                    return gap < static_cast<double>(candidates) ? static_cast<size_t>(gap) : candidates;
+                };
+                size_t rowEnd = std::min(numVertices, (b + 1) * generatorRowsPerBlock);
+                for (size_t src = b * generatorRowsPerBlock; src < rowEnd; ++src)
+                {
+                    size_t candidates = upper ? numVertices - src - 1 : numVertices - 1;
+                    for (size_t i = skip(candidates); i < candidates; i += 1 + skip(candidates))
+                    {
+                        emit(src, upper ? src + 1 + i : (i < src ? i : i + 1));
+                    }
+                } });
+        }
+    }
+
+    // Generated graphs are edge lists over the vertices 0 .. n-1, as produced by
+    // readEdgeList, and are added to a graph with addEdgeList. Undirected generators return
+    // symmetric lists with src < dest. For a given seed the result does not depend on the
+    // thread count. Self loops and duplicate edges are never emitted.
+    //
+    //   auto list = erdosRenyiGraph<int, double>(10000, 0.001, false, {.seed = 42, .maxWeight = 10.0});
+    //   GraphMatrix<int, double, UndirectedG> graph;
+    //   addEdgeList(graph, list);
+
+    // G(n, p): every vertex pair is an edge with probability p.
+    template <typename VertexType = size_t, typename EdgeType = UnweightedG>
+    EdgeList<VertexType, EdgeType> erdosRenyiGraph(size_t numVertices, double p, bool directed, GeneratorOptions options = {})
+    {
+        return detail::bernoulliRows<VertexType, EdgeType>(numVertices, p, !directed, !directed, options, 1);
+    }
+
+    // Directed acyclic G(n, p): every pair src < dest is an edge src -> dest with
+    // probability p, so the vertex numbering is a topological order.
+    template <typename VertexType = size_t, typename EdgeType = UnweightedG>
+    EdgeList<VertexType, EdgeType> randomDag(size_t numVertices, double p, GeneratorOptions options = {})
+    {
+        return detail::bernoulliRows<VertexType, EdgeType>(numVertices, p, true, false, options, 2);
+    }
+
+    // R-MAT (a stochastic Kronecker graph with a 2x2 initiator) over 2^scale vertices.
+    // Draws edgeFactor * 2^scale edges, each by descending scale levels of the adjacency
+    // matrix into quadrant a, b, c or d, then drops self loops and duplicates, so the
+    // result has somewhat fewer edges. The degree distribution is skewed like real
+    // networks, with vertex 0 the largest hub.
+    template <typename VertexType = size_t, typename EdgeType = UnweightedG>
+    EdgeList<VertexType, EdgeType> rmatGraph(unsigned scale, size_t edgeFactor, bool directed,
+                                             RmatParameters quadrants = {}, GeneratorOptions options = {})
+    {
+        if (scale >= 48)
+        {
+            throw std::invalid_argument("R-MAT scale must be below 48");
+        }
+        detail::checkProbability(quadrants.a, "R-MAT a");
+        detail::checkProbability(quadrants.b, "R-MAT b");
+        detail::checkProbability(quadrants.c, "R-MAT c");
+        detail::checkProbability(quadrants.a + quadrants.b + quadrants.c, "R-MAT a + b + c");
+
+        const size_t numVertices = size_t{1} << scale;
+        const size_t draws = edgeFactor * numVertices;
+        const size_t numBlocks = (draws + detail::generatorEdgesPerBlock - 1) / detail::generatorEdgesPerBlock;
+        auto list = detail::generateEdgeList<VertexType, EdgeType>(numVertices, numBlocks, !directed, options, 3,
+                                                                   [&](size_t b, detail::GeneratorRng &rng, auto &&emit)
+                                                                   {
+            size_t end = std::min(draws, (b + 1) * detail::generatorEdgesPerBlock);
+            for (size_t e = b * detail::generatorEdgesPerBlock; e < end; ++e)
+            {
+                size_t src = 0, dest = 0;
+                for (unsigned level = 0; level < scale; ++level)
+                {
+                    double u = rng.uniform();
+                    bool down = u >= quadrants.a + quadrants.b;
+                    bool right = down ? u >= quadrants.a + quadrants.b + quadrants.c : u >= quadrants.a;
+                    src = src << 1 | down;
+                    dest = dest << 1 | right;
+                }
+                if (src == dest)
+                    continue;
+                if (!directed && src > dest)
+                    std::swap(src, dest);
+                emit(src, dest);
+            } });
+
+        auto endpoints = [](const auto &x, const auto &y)
+        { return std::pair(x.src, x.dest) < std::pair(y.src, y.dest); };
+        std::stable_sort(list.edges.begin(), list.edges.end(), endpoints);
+        list.edges.erase(std::unique(list.edges.begin(), list.edges.end(), [](const auto &x, const auto &y)
+                                     { return x.src == y.src && x.dest == y.dest; }),
+                         list.edges.end());
+        return list;
+    }
+
+    // Barabási–Albert preferential attachment, undirected. Vertex v >= 1 attaches up to
+    // edgesPerVertex edges to earlier vertices, each chosen with probability proportional
+    // to its degree. Sequential attachment is replaced by the copy model of Sanders and
+    // Schulz: edge slots are numbered, and a slot's endpoint is found by following random
+    // earlier slots with a counter based hash, so every edge is drawn independently and
+    // blocks run in parallel. Repeated choices of the same target collapse into one edge.
+    template <typename VertexType = size_t, typename EdgeType = UnweightedG>
+    EdgeList<VertexType, EdgeType> barabasiAlbertGraph(size_t numVertices, size_t edgesPerVertex, GeneratorOptions options = {})
+    {
+        const size_t m = edgesPerVertex;
+        const uint64_t slotSeed = detail::mix64(options.seed ^ 0x4241);
+        // Edge e belongs to vertex e / m + 1. Slot 2e holds its source and slot 2e + 1 its
+        // target, which is a uniform pick among the slots of earlier vertices.
+        auto target = [&](size_t e) -> size_t
+        {
+            while (true)
+            {
+                size_t owner = e / m + 1;
+                if (owner == 1)
+                    return 0;
+                size_t slot = detail::mix64(slotSeed + e) % (2 * (owner - 1) * m);
+                if (slot % 2 == 0)
+                    return slot / 2 / m + 1;
+                e = slot / 2;
+            }
+        };
+
+        const size_t numBlocks = m == 0 ? 0 : (numVertices + detail::generatorRowsPerBlock - 1) / detail::generatorRowsPerBlock;
+        return detail::generateEdgeList<VertexType, EdgeType>(numVertices, numBlocks, true, options, 4,
+                                                              [&](size_t b, detail::GeneratorRng &, auto &&emit)
+                                                              {
+            std::vector<size_t> targets;
+            size_t rowEnd = std::min(numVertices, (b + 1) * detail::generatorRowsPerBlock);
+            for (size_t v = std::max<size_t>(1, b * detail::generatorRowsPerBlock); v < rowEnd; ++v)
+            {
+                targets.clear();
+                for (size_t j = 0; j < m; ++j)
+                    targets.push_back(target((v - 1) * m + j));
+                std::sort(targets.begin(), targets.end());
+                targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+                for (size_t dest : targets)
+                    emit(dest, v);
+            } });
+    }
+
+    // Road-like undirected grid of rows x cols vertices, vertex r * cols + c. Each lattice
+    // edge to the right and below is kept with probability keep, and each diagonal to the
+    // lower right is added with probability diagonal.
+    template <typename VertexType = size_t, typename EdgeType = UnweightedG>
+    EdgeList<VertexType, EdgeType> gridGraph(size_t rows, size_t cols, double keep = 1.0, double diagonal = 0.0, GeneratorOptions options = {})
+    {
+        detail::checkProbability(keep, "Grid keep probability");
+        detail::checkProbability(diagonal, "Grid diagonal probability");
+        const size_t numBlocks = (rows + detail::generatorRowsPerBlock - 1) / detail::generatorRowsPerBlock;
+        return detail::generateEdgeList<VertexType, EdgeType>(rows * cols, cols ? numBlocks : 0, true, options, 5,
+                                                              [&](size_t b, detail::GeneratorRng &rng, auto &&emit)
+                                                              {
+            size_t rowEnd = std::min(rows, (b + 1) * detail::generatorRowsPerBlock);
+            for (size_t r = b * detail::generatorRowsPerBlock; r < rowEnd; ++r)
+            {
+                for (size_t c = 0; c < cols; ++c)
+                {
+                    size_t v = r * cols + c;
+                    if (c + 1 < cols && rng.uniform() < keep)
+                        emit(v, v + 1);
+                    if (r + 1 < rows && rng.uniform() < keep)
+                        emit(v, v + cols);
+                    if (c + 1 < cols && r + 1 < rows && rng.uniform() < diagonal)
+                        emit(v, v + cols + 1);
+                }
+            } });
+    }
+}
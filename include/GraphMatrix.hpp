@@ -6,47 +6,55 @@
 #include <optional>
 #include <map>
 #include <stack>
+#include <deque>
+#include <memory_resource>
 #include <algorithm>
 #include <set>
 #include "MatrixRep.hpp"
+#include "GraphStorage.hpp"
 namespace Appledore
 {
 
     // GraphMatrix class template
-    template <typename VertexType, typename EdgeType, typename Direction>
-    class GraphMatrix: public Appledore::MatrixRepresentation<VertexType, EdgeType>
+    // Storage selects the containers behind the graph, see GraphStorage.hpp.
+    template <typename VertexType, typename EdgeType, typename Direction, typename Storage = DenseStorage>
+    class GraphMatrix : public Appledore::MatrixRepresentation<GraphMatrix<VertexType, EdgeType, Direction, Storage>, VertexType, EdgeType, Storage>
     {
-    public:
-        GraphMatrix()
-            : isDirected(std::is_same_v<Direction, DirectedG>),
-              isWeighted(!std::is_same_v<EdgeType, UnweightedG>) {}
+        using Base = MatrixRepresentation<GraphMatrix, VertexType, EdgeType, Storage>;
+        friend Base;
+        using Base::vertexToIndex;
+        using Base::indexToVertex;
+        using Base::numVertices;
 
-        template <typename... Vertices>
-        void addVertex(Vertices &&...vertices)
-        {
-            auto add_single_vertex = [this](const VertexType &vertex)
-            {
-                if (vertexToIndex.count(vertex))
-                    return;
-                size_t newIndex = numVertices++;
-                vertexToIndex[vertex] = newIndex;
-                indexToVertex.push_back(vertex);
-            };
+        using EdgeCell = MatrixCellFor<EdgeType>;
+        using AdjacencyStorage = typename Storage::template Cells<EdgeCell>;
 
-            (add_single_vertex(std::forward<Vertices>(vertices)), ...);
+        // Direction and weight are part of the type, every branch on them is resolved
+        // while compiling.
+        static constexpr bool isDirected = std::is_same_v<Direction, DirectedG>;
+        static constexpr bool isWeighted = !std::is_same_v<EdgeType, UnweightedG>;
+
+    public:
+        GraphMatrix() = default;
 
-            adjacencyMatrix.resize(numVertices * numVertices, std::nullopt);
+        // With PmrStorage, the matrix and vertex maps allocate from resource, which must
+        // outlive the graph.
+        explicit GraphMatrix(std::pmr::memory_resource *resource)
+            requires detail::PmrStoragePolicy<Storage>
+            : Base(resource), adjacencyMatrix(resource)
+        {
         }
 
-        bool operator()(const VertexType &src, const VertexType &dest)
+        bool operator()(const VertexType &src, const VertexType &dest) const
         {
+            auto timer = this->timeOp(GraphOp::HasEdge);
             if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
             {
                 return false;
             }
 
-            size_t srcIndex = vertexToIndex[src];
-            size_t destIndex = vertexToIndex[dest];
+            size_t srcIndex = vertexToIndex.at(src);
+            size_t destIndex = vertexToIndex.at(dest);
 
             if (adjacencyMatrix[getIndex(srcIndex, destIndex)].has_value())
             {
@@ -61,23 +69,20 @@ namespace Appledore
         // for weighted.
         void addEdge(const VertexType &src, const VertexType &dest, const EdgeType &edge)
         {
+            auto timer = this->timeOp(GraphOp::AddEdge);
             if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
                 throw std::invalid_argument("One or both vertices do not exist");
 
             size_t srcIndex = vertexToIndex.at(src);
             size_t destIndex = vertexToIndex.at(dest);
 
-            adjacencyMatrix[getIndex(srcIndex, destIndex)] = EdgeInfo<EdgeType>(edge);
-
-            if (!isDirected)
-            {
-                adjacencyMatrix[getIndex(destIndex, srcIndex)] = EdgeInfo<EdgeType>(edge);
-            }
+            adjacencyMatrix[getIndex(srcIndex, destIndex)] = EdgeCell(edge);
         }
 
         // for unweighted
         void addEdge(const VertexType &src, const VertexType &dest)
         {
+            auto timer = this->timeOp(GraphOp::AddEdge);
             if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
             {
                 throw std::invalid_argument("One or both vertices do not exist");
@@ -86,17 +91,13 @@ namespace Appledore
             size_t srcIndex = vertexToIndex.at(src);
             size_t destIndex = vertexToIndex.at(dest);
 
-            adjacencyMatrix[getIndex(srcIndex, destIndex)] = EdgeInfo<EdgeType>();
-
-            if (!isDirected)
-            {
-                adjacencyMatrix[getIndex(destIndex, srcIndex)] = EdgeInfo<EdgeType>();
-            }
+            adjacencyMatrix[getIndex(srcIndex, destIndex)] = EdgeCell(EdgeType{});
         }
 
         // Remove edge
         void removeEdge(const VertexType &src, const VertexType &dest)
         {
+            auto timer = this->timeOp(GraphOp::RemoveEdge);
             if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
                 throw std::invalid_argument("One or both vertices do not exist");
 
@@ -104,16 +105,12 @@ namespace Appledore
             size_t destIndex = vertexToIndex.at(dest);
 
             adjacencyMatrix[getIndex(srcIndex, destIndex)] = std::nullopt;
-
-            if (!isDirected)
-            {
-                adjacencyMatrix[getIndex(destIndex, srcIndex)] = std::nullopt;
-            }
         }
 
         // Check if edge exists
         bool hasEdge(const VertexType &src, const VertexType &dest) const
         {
+            auto timer = this->timeOp(GraphOp::HasEdge);
             if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
                 throw std::invalid_argument("One or both vertices do not exist");
 
@@ -123,14 +120,9 @@ namespace Appledore
             return adjacencyMatrix[getIndex(srcIndex, destIndex)].has_value();
         }
 
-        // Get vertices
-        const std::vector<VertexType> &getVertices() const
-        {
-            return indexToVertex;
-        }
-
         const EdgeType &getEdge(const VertexType &src, const VertexType &dest) const
         {
+            auto timer = this->timeOp(GraphOp::GetEdge);
             if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
             {
                 throw std::invalid_argument("One or both vertices do not exist!");
@@ -142,7 +134,7 @@ namespace Appledore
 
             if (edgeValue.has_value())
             {
-                return edgeValue.value().value;
+                return *edgeValue;
             }
             else
             {
@@ -150,6 +142,199 @@ namespace Appledore
             }
         }
 
+        // Non-throwing counterparts of the lookups and edge updates, for workloads that
+        // probe for edges that are often missing. Failures come back as a GraphError in
+        // the result (see GraphExceptions.hpp); nothing is thrown and no message is built.
+
+        GraphResult<bool> tryHasEdge(const VertexType &src, const VertexType &dest) const
+        {
+            auto timer = this->timeOp(GraphOp::HasEdge);
+            GraphResult<size_t> cell = tryCellIndex(src, dest);
+            if (!cell)
+                return cell.error();
+            return adjacencyMatrix[*cell].has_value();
+        }
+
+        // The reference stays valid until the graph is modified.
+        GraphResult<const EdgeType &> tryGetEdge(const VertexType &src, const VertexType &dest) const
+        {
+            auto timer = this->timeOp(GraphOp::GetEdge);
+            GraphResult<size_t> cell = tryCellIndex(src, dest);
+            if (!cell)
+                return cell.error();
+            const EdgeCell &edge = adjacencyMatrix[*cell];
+            if (!edge.has_value())
+                return GraphError::EdgeNotFound;
+            return *edge;
+        }
+
+        // The edge value, or nullptr when either vertex or the edge is missing.
+        const EdgeType *findEdge(const VertexType &src, const VertexType &dest) const
+        {
+            GraphResult<const EdgeType &> edge = tryGetEdge(src, dest);
+            return edge ? &*edge : nullptr;
+        }
+
+        // EdgeNotFound when there was no edge to remove, which removeEdge ignores.
+        GraphResult<> tryRemoveEdge(const VertexType &src, const VertexType &dest)
+        {
+            auto timer = this->timeOp(GraphOp::RemoveEdge);
+            GraphResult<size_t> cell = tryCellIndex(src, dest);
+            if (!cell)
+                return cell.error();
+            if (!std::as_const(adjacencyMatrix)[*cell].has_value())
+                return GraphError::EdgeNotFound;
+            adjacencyMatrix[*cell] = std::nullopt;
+            return {};
+        }
+
+        GraphResult<> tryUpdateEdge(const VertexType &src, const VertexType &dest, const EdgeType &newEdgeValue)
+            requires isWeighted
+        {
+            auto timer = this->timeOp(GraphOp::UpdateEdge);
+            GraphResult<size_t> cell = tryCellIndex(src, dest);
+            if (!cell)
+                return cell.error();
+            if (!std::as_const(adjacencyMatrix)[*cell].has_value())
+                return GraphError::EdgeNotFound;
+            adjacencyMatrix[*cell] = EdgeCell(newEdgeValue);
+            return {};
+        }
+
+        GraphResult<size_t> tryIndegree(const VertexType &vertex) const
+        {
+            auto timer = this->timeOp(GraphOp::Degree);
+            const size_t *index = this->findIndex(vertex);
+            if (!index)
+                return GraphError::VertexNotFound;
+            if constexpr (isDirected)
+                return this->columnCount(*index);
+            else
+                return rowCount(*index);
+        }
+
+        GraphResult<size_t> tryOutdegree(const VertexType &vertex) const
+        {
+            auto timer = this->timeOp(GraphOp::Degree);
+            const size_t *index = this->findIndex(vertex);
+            if (!index)
+                return GraphError::VertexNotFound;
+            return rowCount(*index);
+        }
+
+        GraphResult<size_t> tryTotalDegree(const VertexType &vertex) const
+        {
+            auto timer = this->timeOp(GraphOp::Degree);
+            const size_t *index = this->findIndex(vertex);
+            if (!index)
+                return GraphError::VertexNotFound;
+            if constexpr (isDirected)
+                return this->columnCount(*index) + rowCount(*index);
+            else
+                return rowCount(*index);
+        }
+
+        // Overloads taking handles from handleOf(), which resolve both vertices without a map
+        // lookup. Stale handles throw std::invalid_argument, except in operator() and
+        // findEdge, which answer false and nullptr.
+
+        bool operator()(VertexHandle src, VertexHandle dest) const
+        {
+            auto timer = this->timeOp(GraphOp::HasEdge);
+            std::optional<size_t> srcIndex = this->findIndex(src);
+            std::optional<size_t> destIndex = this->findIndex(dest);
+            return srcIndex && destIndex && adjacencyMatrix[getIndex(*srcIndex, *destIndex)].has_value();
+        }
+
+        void addEdge(VertexHandle src, VertexHandle dest, const EdgeType &edge)
+        {
+            auto timer = this->timeOp(GraphOp::AddEdge);
+            adjacencyMatrix[handleCell(src, dest)] = EdgeCell(edge);
+        }
+
+        void addEdge(VertexHandle src, VertexHandle dest)
+        {
+            auto timer = this->timeOp(GraphOp::AddEdge);
+            adjacencyMatrix[handleCell(src, dest)] = EdgeCell(EdgeType{});
+        }
+
+        void removeEdge(VertexHandle src, VertexHandle dest)
+        {
+            auto timer = this->timeOp(GraphOp::RemoveEdge);
+            adjacencyMatrix[handleCell(src, dest)] = std::nullopt;
+        }
+
+        bool hasEdge(VertexHandle src, VertexHandle dest) const
+        {
+            auto timer = this->timeOp(GraphOp::HasEdge);
+            return adjacencyMatrix[handleCell(src, dest)].has_value();
+        }
+
+        const EdgeType &getEdge(VertexHandle src, VertexHandle dest) const
+        {
+            auto timer = this->timeOp(GraphOp::GetEdge);
+            const EdgeCell &edge = adjacencyMatrix[handleCell(src, dest)];
+            if (!edge.has_value())
+                throw std::runtime_error("No Edge exists between the given vertices.");
+            return *edge;
+        }
+
+        const EdgeType *findEdge(VertexHandle src, VertexHandle dest) const
+        {
+            auto timer = this->timeOp(GraphOp::GetEdge);
+            std::optional<size_t> srcIndex = this->findIndex(src);
+            std::optional<size_t> destIndex = this->findIndex(dest);
+            if (!srcIndex || !destIndex)
+                return nullptr;
+            const EdgeCell &edge = adjacencyMatrix[getIndex(*srcIndex, *destIndex)];
+            return edge.has_value() ? &*edge : nullptr;
+        }
+
+        void updateEdge(VertexHandle src, VertexHandle dest, const EdgeType &newEdgeValue)
+            requires isWeighted
+        {
+            auto timer = this->timeOp(GraphOp::UpdateEdge);
+            size_t index = handleCell(src, dest);
+            if (!std::as_const(adjacencyMatrix)[index].has_value())
+                throw std::runtime_error("No edge exists between the specified vertices.");
+            adjacencyMatrix[index] = EdgeCell(newEdgeValue);
+        }
+
+        [[nodiscard]] size_t indegree(VertexHandle vertex) const
+        {
+            auto timer = this->timeOp(GraphOp::Degree);
+            size_t index = this->getIndexOf(vertex);
+            if constexpr (isDirected)
+                return this->columnCount(index);
+            else
+                return rowCount(index);
+        }
+
+        [[nodiscard]] size_t outdegree(VertexHandle vertex) const
+        {
+            auto timer = this->timeOp(GraphOp::Degree);
+            return rowCount(this->getIndexOf(vertex));
+        }
+
+        [[nodiscard]] size_t totalDegree(VertexHandle vertex) const
+        {
+            auto timer = this->timeOp(GraphOp::Degree);
+            size_t index = this->getIndexOf(vertex);
+            if constexpr (isDirected)
+                return this->columnCount(index) + rowCount(index);
+            else
+                return rowCount(index);
+        }
+
+        std::set<VertexType> getNeighbors(VertexHandle vertex) const
+        {
+            auto timer = this->timeOp(GraphOp::Neighbors);
+            std::set<VertexType> neighbors;
+            forEachInRow(this->getIndexOf(vertex), [&](size_t destIndex)
+                         { neighbors.insert(indexToVertex[destIndex]); });
+            return neighbors;
+        }
+
         // Get all edges
         std::vector<std::tuple<VertexType, VertexType, EdgeType>> getAllEdges(
             std::optional<bool> returnSorted = std::nullopt,
@@ -157,22 +342,24 @@ namespace Appledore
                                const std::tuple<VertexType, VertexType, EdgeType> &)>
                 customPredicate = nullptr) const
         {
-            if (!isWeighted)
+            auto timer = this->timeOp(GraphOp::GetEdges);
+            if constexpr (!isWeighted)
                 throw std::invalid_argument("Given Graph must be Weighted.");
             // Collect all edges
             std::vector<std::tuple<VertexType, VertexType, EdgeType>> edges;
 
+            this->countStat(GraphCounter::RowsScanned, numVertices);
             for (size_t srcIndex = 0; srcIndex < numVertices; ++srcIndex)
             {
                 for (size_t destIndex = 0; destIndex < numVertices; ++destIndex)
                 {
-                    const std::optional<EdgeInfo<EdgeType>> &edgeValue = adjacencyMatrix[getIndex(srcIndex, destIndex)];
+                    const EdgeCell &edgeValue = adjacencyMatrix[getIndex(srcIndex, destIndex)];
                     if (edgeValue.has_value())
                     {
                         edges.emplace_back(
                             indexToVertex[srcIndex],
                             indexToVertex[destIndex],
-                            edgeValue.value().value);
+                            *edgeValue);
                     }
                 }
             }
@@ -208,96 +395,49 @@ namespace Appledore
 
         [[nodiscard]] size_t indegree(const VertexType &vertex) const
         {
-            if (!vertexToIndex.count(vertex))
-            {
-                throw std::invalid_argument("Vertex does not exist in the graph");
-            }
-            if (!isDirected)
-            {
-                std::cerr << "\nIndegree is not defined for undirected graphs. Returning Total Degree\n";
-                return totalDegree(vertex);
-            }
-            size_t vertexIndex = vertexToIndex.at(vertex);
-            size_t indegree = 0;
-            for (size_t srcIndex = 0; srcIndex < numVertices; ++srcIndex)
+            auto timer = this->timeOp(GraphOp::Degree);
+            size_t index = this->getIndexOf(vertex);
+            if constexpr (!isDirected)
             {
-                if (adjacencyMatrix[getIndex(srcIndex, vertexIndex)].has_value())
-                {
-                    indegree++;
-                }
+                return rowCount(index);
             }
-            return indegree;
+            return this->columnCount(index);
         }
         [[nodiscard]] size_t outdegree(const VertexType &vertex) const
         {
-            if (!vertexToIndex.count(vertex))
-            {
-                throw std::invalid_argument("Vertex does not exist in the graph");
-            }
-            if (!isDirected)
-            {
-                std::cerr << "\nOutdegree is not defined for undirected graphs. Returning total degree\n";
-                return totalDegree(vertex);
-            }
-            size_t vertexIndex = vertexToIndex.at(vertex);
-            size_t outdegree = 0;
-            for (size_t destIndex = 0; destIndex < numVertices; ++destIndex)
-            {
-                if (adjacencyMatrix[getIndex(vertexIndex, destIndex)].has_value())
-                {
-                    outdegree++;
-                }
-            }
-            return outdegree;
+            auto timer = this->timeOp(GraphOp::Degree);
+            return rowCount(this->getIndexOf(vertex));
         }
         [[nodiscard]] size_t totalDegree(const VertexType &vertex) const
         {
-            if (!vertexToIndex.count(vertex))
-            {
-                throw std::invalid_argument("Vertex does not exist in the graph");
-            }
-            if (isDirected)
-                return indegree(vertex) + outdegree(vertex);
-            size_t vertexIndex = vertexToIndex.at(vertex);
-            size_t totaldegree = 0;
-            for (size_t srcIndex = 0; srcIndex < numVertices; ++srcIndex)
-            {
-                if (adjacencyMatrix[getIndex(srcIndex, vertexIndex)].has_value())
-                {
-                    totaldegree++;
-                }
-            }
-            return totaldegree;
+            auto timer = this->timeOp(GraphOp::Degree);
+            size_t index = this->getIndexOf(vertex);
+            if constexpr (isDirected)
+                return this->columnCount(index) + rowCount(index);
+            // the matrix of an undirected graph is symmetric, the row holds the same cells
+            // as the column.
+            return rowCount(index);
         }
         std::set<VertexType> getNeighbors(const VertexType &vertex) const
         {
-            if (!vertexToIndex.count(vertex))
-            {
-                throw std::invalid_argument("Vertex does not exist in the graph");
-            }
-
-            size_t vertexIndex = vertexToIndex.at(vertex);
+            auto timer = this->timeOp(GraphOp::Neighbors);
+            size_t vertexIndex = this->getIndexOf(vertex);
 
             std::set<VertexType> neighbors;
 
-            for (size_t destIndex = 0; destIndex < numVertices; ++destIndex)
-            {
-                if (adjacencyMatrix[getIndex(vertexIndex, destIndex)].has_value())
-                {
-                    neighbors.insert(indexToVertex[destIndex]);
-                }
-
-                if (!isDirected && adjacencyMatrix[getIndex(destIndex, vertexIndex)].has_value())
-                {
-                    neighbors.insert(indexToVertex[destIndex]);
-                }
-            }
+            // undirected edges are stored in both rows, so the row alone is enough.
+            forEachInRow(vertexIndex, [&](size_t destIndex)
+                         { neighbors.insert(indexToVertex[destIndex]); });
 
             return neighbors;
         }
 
-        std::vector<std::vector<VertexType>> findAllPaths(const VertexType &src, const VertexType &dest, size_t pl = 0)
+        // The search stack and the partial paths are allocated from scratch, e.g. a
+        // std::pmr::monotonic_buffer_resource reused per query; the returned paths are not.
+        std::vector<std::vector<VertexType>> findAllPaths(const VertexType &src, const VertexType &dest, size_t pl = 0,
+                                                          std::pmr::memory_resource *scratch = std::pmr::get_default_resource()) const
         {
+            auto timer = this->timeOp(GraphOp::FindAllPaths);
             if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
                 throw std::invalid_argument("One or both vertices do not exist");
 
@@ -306,27 +446,28 @@ namespace Appledore
 
             if (pl > 0)
             {
-                size_t totalPaths = countPathsDFS(src, dest);
+                size_t totalPaths = countPathsDFS(src, dest, scratch);
                 if (pl > totalPaths)
                     throw std::invalid_argument("Path limit exceeds the total number of possible paths");
             }
 
             std::vector<std::vector<VertexType>> allPaths;
-            std::stack<std::pair<VertexType, std::vector<VertexType>>> stack;
+            PathStack stack{std::pmr::deque<PathEntry>(scratch)};
 
-            stack.push({src, {src}});
+            stack.emplace(src, std::pmr::vector<VertexType>({src}, scratch));
 
             while (!stack.empty())
             {
-                std::pair<VertexType, std::vector<VertexType>> currentElement = stack.top();
+                PathEntry currentElement = std::move(stack.top());
                 stack.pop();
 
-                VertexType current = currentElement.first;
-                std::vector<VertexType> currentPath = currentElement.second;
+                const VertexType &current = currentElement.first;
+                const std::pmr::vector<VertexType> &currentPath = currentElement.second;
 
                 if (current == dest)
                 {
-                    allPaths.push_back(currentPath);
+                    allPaths.emplace_back(currentPath.begin(), currentPath.end());
+                    this->countStat(GraphCounter::PathsEmitted);
 
                     if (pl > 0 && allPaths.size() >= pl)
                     {
@@ -335,6 +476,8 @@ namespace Appledore
                 }
                 else
                 {
+                    this->countStat(GraphCounter::NodesExpanded);
+                    this->countStat(GraphCounter::RowsScanned);
                     size_t currentIndex = vertexToIndex.at(current);
                     for (size_t i = 0; i < numVertices; ++i)
                     {
@@ -353,9 +496,9 @@ namespace Appledore
 
                             if (!vertexInPath)
                             {
-                                auto newPath = currentPath;
+                                std::pmr::vector<VertexType> newPath(currentPath, scratch);
                                 newPath.push_back(nextVertex);
-                                stack.push({nextVertex, newPath});
+                                stack.emplace(nextVertex, std::move(newPath));
                             }
                         }
                     }
@@ -367,11 +510,13 @@ namespace Appledore
 
         [[nodiscard]] double density() const
         {
+            auto timer = this->timeOp(GraphOp::Density);
             if (numVertices <= 1)
             {
                 return 0.0;
             }
 
+            // an undirected graph stores each edge in one cell of the triangle.
             size_t edgeCount = 0;
             for (size_t i = 0; i < adjacencyMatrix.size(); ++i)
             {
@@ -381,11 +526,6 @@ namespace Appledore
                 }
             }
 
-            if (!isDirected)
-            {
-                edgeCount /= 2;
-            }
-
             double denominator = static_cast<double>(numVertices) * (numVertices - 1);
             double numerator = isDirected ? static_cast<double>(edgeCount) : 2.0 * static_cast<double>(edgeCount);
 
@@ -394,9 +534,10 @@ namespace Appledore
 
         [[nodiscard]] bool isConnected() const
         {
+            auto timer = this->timeOp(GraphOp::Connectivity);
             if (numVertices == 0)
                 return true;
-            if (isDirected)
+            if constexpr (isDirected)
                 return false;
             std::vector<bool> visited(numVertices, false);
             dfsforConnectivity(0, visited);
@@ -404,32 +545,37 @@ namespace Appledore
                                { return v; });
         }
 
-        size_t countPathsDFS(const VertexType &src, const VertexType &dest)
+        size_t countPathsDFS(const VertexType &src, const VertexType &dest,
+                             std::pmr::memory_resource *scratch = std::pmr::get_default_resource()) const
         {
+            auto timer = this->timeOp(GraphOp::CountPaths);
             if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
                 throw std::invalid_argument("One or both vertices do not exist");
 
-            std::stack<std::pair<VertexType, std::vector<VertexType>>> stack;
+            PathStack stack{std::pmr::deque<PathEntry>(scratch)};
 
-            stack.push({src, {src}});
+            stack.emplace(src, std::pmr::vector<VertexType>({src}, scratch));
 
             size_t pathCount = 0;
 
             while (!stack.empty())
             {
-                std::pair<VertexType, std::vector<VertexType>> currentElement = stack.top();
+                PathEntry currentElement = std::move(stack.top());
                 stack.pop();
 
-                VertexType current = currentElement.first;
-                std::vector<VertexType> currentPath = currentElement.second;
+                const VertexType &current = currentElement.first;
+                const std::pmr::vector<VertexType> &currentPath = currentElement.second;
 
                 if (current == dest)
                 {
                     pathCount++;
+                    this->countStat(GraphCounter::PathsEmitted);
                 }
                 else
                 {
-                    size_t currentIndex = vertexToIndex[current];
+                    this->countStat(GraphCounter::NodesExpanded);
+                    this->countStat(GraphCounter::RowsScanned);
+                    size_t currentIndex = vertexToIndex.at(current);
                     for (size_t i = 0; i < numVertices; ++i)
                     {
                         if (adjacencyMatrix[getIndex(currentIndex, i)].has_value())
@@ -447,9 +593,9 @@ namespace Appledore
 
                             if (!vertexInPath)
                             {
-                                auto newPath = currentPath;
+                                std::pmr::vector<VertexType> newPath(currentPath, scratch);
                                 newPath.push_back(nextVertex);
-                                stack.push({nextVertex, newPath});
+                                stack.emplace(nextVertex, std::move(newPath));
                             }
                         }
                     }
@@ -472,66 +618,19 @@ namespace Appledore
                 if (!visited[current])
                 {
                     visited[current] = true;
+                    this->countStat(GraphCounter::NodesExpanded);
 
-                    for (size_t dest = 0; dest < numVertices; ++dest)
-                    {
-                        if (adjacencyMatrix[getIndex(current, dest)].has_value() && !visited[dest])
-                        {
-                            stack.push(dest);
-                        }
-                    }
-                }
-            }
-        }
-
-        void removeVertex(const VertexType &vert)
-        {
-
-            if (!vertexToIndex.count(vert))
-            {
-                throw std::invalid_argument("Vertex does not exist in the graph.");
-            }
-
-            size_t remIdx = vertexToIndex[vert];
-            size_t lastIdx = numVertices - 1;
-
-            if (remIdx != lastIdx)
-            {
-                for (size_t c = 0; c < numVertices; ++c)
-                {
-                    std::swap(adjacencyMatrix[getIndex(remIdx, c)], adjacencyMatrix[getIndex(lastIdx, c)]);
-                }
-                for (size_t r = 0; r < numVertices; ++r)
-                {
-                    std::swap(adjacencyMatrix[getIndex(r, remIdx)], adjacencyMatrix[getIndex(r, lastIdx)]);
+                    forEachInRow(current, [&](size_t dest)
+                                 {
+                                     if (!visited[dest])
+                                         stack.push(dest); });
                 }
-
-                VertexType movedVertex = indexToVertex[lastIdx];
-                vertexToIndex[movedVertex] = remIdx;
-                indexToVertex[remIdx] = movedVertex;
             }
-
-            vertexToIndex.erase(vert);
-            indexToVertex.pop_back();
-
-            size_t newSize = (numVertices - 1) * (numVertices - 1);
-            std::vector<std::optional<EdgeInfo<EdgeType>>> newMatrix(newSize);
-
-            for (size_t r = 0; r < numVertices - 1; ++r)
-            {
-                for (size_t c = 0; c < numVertices - 1; ++c)
-                {
-                    newMatrix[r * (numVertices - 1) + c] = adjacencyMatrix[getIndex(r, c)];
-                }
-            }
-
-            adjacencyMatrix = std::move(newMatrix);
-
-            --numVertices;
         }
 
         [[nodiscard]] std::vector<VertexType> getIsolated() const
         {
+            auto timer = this->timeOp(GraphOp::Isolated);
             if (numVertices == 0)
             {
                 throw std::runtime_error("Graph is empty. No vertices available.");
@@ -557,7 +656,8 @@ namespace Appledore
 
         void updateEdge(const VertexType &src, const VertexType &dest, const EdgeType &newEdgeValue)
         {
-            if (!isWeighted)
+            auto timer = this->timeOp(GraphOp::UpdateEdge);
+            if constexpr (!isWeighted)
             {
                 throw std::logic_error("Cannot update an edge in an unweighted graph.");
             }
@@ -570,23 +670,21 @@ namespace Appledore
             size_t srcIndex = vertexToIndex.at(src);
             size_t destIndex = vertexToIndex.at(dest);
 
-            std::optional<EdgeInfo<EdgeType>> edgeInfo = adjacencyMatrix[getIndex(srcIndex, destIndex)];
-            if (!edgeInfo.has_value())
+            size_t index = getIndex(srcIndex, destIndex);
+            if (!std::as_const(adjacencyMatrix)[index].has_value())
             {
                 throw std::runtime_error("No edge exists between the specified vertices.");
             }
 
-            edgeInfo = EdgeInfo<EdgeType>(newEdgeValue);
-
-            if (!isDirected)
-            {
-                adjacencyMatrix[getIndex(destIndex, srcIndex)] = EdgeInfo<EdgeType>(newEdgeValue);
-            }
+            adjacencyMatrix[index] = EdgeCell(newEdgeValue);
         }
       bool isCyclicDirectedDFS(const size_t v, std::vector<bool> &visited, std::vector<bool> &recStack) const {
             visited[v] = true;
             recStack[v] = true;
 
+            this->countStat(GraphCounter::NodesExpanded);
+            this->countStat(GraphCounter::RowsScanned);
+            adviseRowScan(v);
             for (size_t dest = 0; dest < numVertices; ++dest) {
                 if (!adjacencyMatrix[getIndex(v, dest)].has_value()) {
                     continue;
@@ -608,6 +706,9 @@ namespace Appledore
         bool isCyclicUndirectedDFS(size_t v, size_t parent, std::vector<bool> &visited) const {
             visited[v] = true;
 
+            this->countStat(GraphCounter::NodesExpanded);
+            this->countStat(GraphCounter::RowsScanned);
+            adviseRowScan(v);
             for (size_t dest = 0; dest < numVertices; ++dest) {
                 if (!adjacencyMatrix[getIndex(v, dest)].has_value()) {
                     continue;
@@ -625,9 +726,10 @@ namespace Appledore
         }
 
         [[nodiscard]] bool isCyclic() const {
+            auto timer = this->timeOp(GraphOp::CycleCheck);
             std::vector<bool> visited(numVertices, false);
 
-            if (isDirected) {
+            if constexpr (isDirected) {
                 std::vector<bool> recStack(numVertices, false);
                 for (size_t i = 0; i < numVertices; ++i) {
                     if (visited[i]) {
@@ -651,17 +753,241 @@ namespace Appledore
             return false;
         }
 
+        // Index level insertion, without vertex lookups.
+        void addEdgeAt(size_t srcIndex, size_t destIndex, const EdgeType &edge = EdgeType{})
+        {
+            auto timer = this->timeOp(GraphOp::AddEdge);
+            this->checkIndex(srcIndex);
+            this->checkIndex(destIndex);
+            adjacencyMatrix[getIndex(srcIndex, destIndex)] = EdgeCell(edge);
+        }
+
+        // Bulk index level insertion of (srcIndex, destIndex, edge) tuples, timed as one
+        // operation.
+        template <typename Range>
+        void addEdgesAt(const Range &edges)
+        {
+            auto timer = this->timeOp(GraphOp::AddEdge);
+            for (const auto &[srcIndex, destIndex, edge] : edges)
+            {
+                this->checkIndex(srcIndex);
+                this->checkIndex(destIndex);
+                adjacencyMatrix[getIndex(srcIndex, destIndex)] = EdgeCell(edge);
+            }
+        }
+
+        const EdgeType &getEdgeAt(size_t srcIndex, size_t destIndex) const
+        {
+            if (!this->hasEdgeAt(srcIndex, destIndex))
+            {
+                throw std::runtime_error("No Edge exists between the given vertices.");
+            }
+            return *adjacencyMatrix[getIndex(srcIndex, destIndex)];
+        }
+
+        // Writes the adjacency matrix back to its file, for storage policies that keep it in
+        // one (MappedStorage).
+        void flush(bool wait = true)
+            requires requires(AdjacencyStorage &cells) { cells.flush(wait); }
+        {
+            adjacencyMatrix.flush(wait);
+        }
+
+        // Returns an independent copy of the graph. With CowStorage this is O(1): the copy
+        // shares all blocks with this graph until either of them is modified.
+        [[nodiscard]] GraphMatrix snapshot() const
+        {
+            return *this;
+        }
+
     private:
-        std::map<VertexType, size_t> vertexToIndex;
-        std::vector<VertexType> indexToVertex;
-        std::vector<std::optional<EdgeInfo<EdgeType>>> adjacencyMatrix;
-        size_t numVertices = 0;
-        bool isDirected;
-        bool isWeighted;
+        AdjacencyStorage adjacencyMatrix;
+
+        // Depth-first path enumeration state: a vertex and the path that reached it.
+        using PathEntry = std::pair<VertexType, std::pmr::vector<VertexType>>;
+        using PathStack = std::stack<PathEntry, std::pmr::deque<PathEntry>>;
+
+        // Undirected graphs keep only the upper triangle, packed column by column: (i, j) is
+        // canonicalized to i <= j and stored at j * (j + 1) / 2 + i. Every edge has a single
+        // cell, and adding a vertex appends a column without moving existing cells.
+        static constexpr bool triangular = std::is_same_v<Direction, UndirectedG>;
+
+        static size_t cellIndex(size_t src, size_t dest, size_t vertexCount)
+        {
+            if constexpr (triangular)
+            {
+                if (src > dest)
+                    std::swap(src, dest);
+                return dest * (dest + 1) / 2 + src;
+            }
+            else
+            {
+                return src * vertexCount + dest;
+            }
+        }
+
+        static size_t cellCount(size_t vertexCount)
+        {
+            return triangular ? vertexCount * (vertexCount + 1) / 2 : vertexCount * vertexCount;
+        }
 
         inline size_t getIndex(size_t src, size_t dest) const
         {
-            return src * numVertices + dest;
+            return cellIndex(src, dest, numVertices);
+        }
+
+        // Cell of (src, dest) with one lookup per vertex.
+        GraphResult<size_t> tryCellIndex(const VertexType &src, const VertexType &dest) const
+        {
+            const size_t *srcIndex = this->findIndex(src);
+            if (!srcIndex)
+                return GraphError::SourceNotFound;
+            const size_t *destIndex = this->findIndex(dest);
+            if (!destIndex)
+                return GraphError::TargetNotFound;
+            return getIndex(*srcIndex, *destIndex);
+        }
+
+        // Cell of (src, dest) from handles, throws for stale ones.
+        size_t handleCell(VertexHandle src, VertexHandle dest) const
+        {
+            return getIndex(this->getIndexOf(src), this->getIndexOf(dest));
+        }
+
+        // Read-ahead hint before scanning a row, for file-backed storage. Only the part of
+        // a triangular row up to the diagonal is contiguous.
+        void adviseRowScan(size_t row) const
+        {
+            if constexpr (requires { adjacencyMatrix.adviseSequential(row, numVertices); })
+            {
+                if constexpr (triangular)
+                    adjacencyMatrix.adviseSequential(getIndex(0, row), row + 1);
+                else
+                    adjacencyMatrix.adviseSequential(getIndex(row, 0), numVertices);
+            }
+        }
+
+        bool cellAt(size_t src, size_t dest) const
+        {
+            return adjacencyMatrix[getIndex(src, dest)].has_value();
+        }
+
+        template <typename Func>
+        void forEachInRow(size_t row, Func &&func) const
+        {
+            adviseRowScan(row);
+            Base::forEachInRow(row, func);
+        }
+
+        size_t rowCount(size_t row) const
+        {
+            adviseRowScan(row);
+            return Base::rowCount(row);
+        }
+
+        // The cells of an undirected graph are symmetric, so the column is read as the row.
+        size_t columnCount(size_t col) const
+        {
+            if constexpr (triangular)
+                return rowCount(col);
+            else
+                return Base::columnCount(col);
+        }
+
+        void cellMemory(MemoryUsage &usage) const
+        {
+            usage.adjacency = detail::containerMemory(adjacencyMatrix);
+            if constexpr (!std::is_trivially_copyable_v<EdgeType>)
+            {
+                for (size_t i = 0, cells = cellCount(numVertices); i < cells; ++i)
+                {
+                    const EdgeCell &cell = adjacencyMatrix[i];
+                    if (cell.has_value())
+                        usage.edgeData += HeapFootprint<EdgeType>::of(*cell);
+                }
+            }
+        }
+
+        // Vertex removal on the packed triangle truncates in place, which keeps capacity.
+        void shrinkCells()
+        {
+            detail::shrinkContainer(adjacencyMatrix);
+        }
+
+        // Re-lays the rows of the old matrix out for the new vertex count. The packed
+        // triangle only grows at its end.
+        void growCells(size_t oldNumVertices)
+        {
+            if (oldNumVertices == 0 || triangular)
+            {
+                adjacencyMatrix.resize(cellCount(numVertices));
+                return;
+            }
+
+            AdjacencyStorage newMatrix = detail::sizedLike(adjacencyMatrix, cellCount(numVertices));
+            for (size_t r = 0; r < oldNumVertices; ++r)
+            {
+                for (size_t c = 0; c < oldNumVertices; ++c)
+                {
+                    const EdgeCell &cell = std::as_const(adjacencyMatrix)[r * oldNumVertices + c];
+                    if (cell.has_value())
+                    {
+                        newMatrix[r * numVertices + c] = cell;
+                    }
+                }
+            }
+            adjacencyMatrix = std::move(newMatrix);
+        }
+
+        // Keeps vertex order[i] as index i. Survivors are visited in storage order: row by
+        // row for the full matrix, column by column (rows up to the diagonal) for the
+        // packed triangle.
+        void selectCells(const std::vector<size_t> &order)
+        {
+            size_t newNumVertices = order.size();
+            AdjacencyStorage newMatrix = detail::sizedLike(adjacencyMatrix, cellCount(newNumVertices));
+            size_t writePos = 0;
+            for (size_t outer = 0; outer < newNumVertices; ++outer)
+            {
+                size_t innerEnd = triangular ? outer + 1 : newNumVertices;
+                for (size_t inner = 0; inner < innerEnd; ++inner)
+                {
+                    const EdgeCell &cell = std::as_const(adjacencyMatrix)[getIndex(order[outer], order[inner])];
+                    if (cell.has_value())
+                    {
+                        newMatrix[writePos] = cell;
+                    }
+                    ++writePos;
+                }
+            }
+            adjacencyMatrix = std::move(newMatrix);
+        }
+
+        // The packed triangle is compacted in place: the removed vertex's column is swapped
+        // with the last one, which is the tail of the storage and is then cut off.
+        void swapRemoveCells(size_t removedIndex, size_t lastIndex)
+        {
+            if constexpr (triangular)
+            {
+                if (removedIndex != lastIndex)
+                {
+                    // row and column are the same cells, swap them once. The cell shared by
+                    // both vertices stays where it is.
+                    for (size_t c = 0; c < numVertices; ++c)
+                    {
+                        if (c != removedIndex && c != lastIndex)
+                            std::swap(adjacencyMatrix[getIndex(removedIndex, c)], adjacencyMatrix[getIndex(lastIndex, c)]);
+                    }
+                    std::swap(adjacencyMatrix[getIndex(removedIndex, removedIndex)], adjacencyMatrix[getIndex(lastIndex, lastIndex)]);
+                }
+                adjacencyMatrix.resize(cellCount(lastIndex));
+            }
+            else
+            {
+                Base::swapRemoveCells(removedIndex, lastIndex);
+            }
         }
     };
+
+    static_assert(AdjacencyMatrixGraph<GraphMatrix<int, int, DirectedG>>);
 }
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Appledore
+{
+    // Bytes of one structure: used is what the live elements take, capacity what is
+    // allocated for them including slack and estimated allocator and node overhead.
+    struct MemoryBlock
+    {
+        size_t used = 0;
+        size_t capacity = 0;
+
+        [[nodiscard]] size_t slack() const { return capacity - used; }
+
+        MemoryBlock &operator+=(const MemoryBlock &other)
+        {
+            used += other.used;
+            capacity += other.capacity;
+            return *this;
+        }
+    };
+
+    // Breakdown returned by memoryUsage() on GraphMatrix and MixedGraphMatrix.
+    //
+    // Vertices are stored twice, as keys of vertexToIndex and in indexToVertex, so
+    // vertexData counts their heap data for both copies. Names of GraphVertex and GraphEdge
+    // live in a SymbolTable and are not counted. Containers shared between copies
+    // of a graph (CowStorage) are counted in full by every copy.
+    struct MemoryUsage
+    {
+        MemoryBlock object;        // the graph object itself, including inline statistics
+        MemoryBlock adjacency;     // edge cells or bitmaps and edge values
+        MemoryBlock edgeData;      // heap owned by edge values
+        MemoryBlock vertexToIndex; // tree nodes of the vertex map
+        MemoryBlock indexToVertex; // the vertex array
+        MemoryBlock vertexData;    // heap owned by vertex values
+        MemoryBlock handles;       // vertex handle slots and the name index
+
+        [[nodiscard]] MemoryBlock total() const
+        {
+            MemoryBlock sum = object;
+            sum += adjacency;
+            sum += edgeData;
+            sum += vertexToIndex;
+            sum += indexToVertex;
+            sum += vertexData;
+            sum += handles;
+            return sum;
+        }
+    };
+
+    // Heap owned by a vertex or edge value, beyond sizeof(T). Zero unless specialized;
+    // std::string and std::vector are provided. Types holding heap data specialize it:
+    //
+    //   template <> struct Appledore::HeapFootprint<Airport> {
+    //       static MemoryBlock of(const Airport &a) { return HeapFootprint<std::string>::of(a.city); }
+    //   };
+    template <typename T>
+    struct HeapFootprint
+    {
+        static MemoryBlock of(const T &) { return {}; }
+    };
+
+    template <typename Char, typename Traits, typename Alloc>
+    struct HeapFootprint<std::basic_string<Char, Traits, Alloc>>
+    {
+        static MemoryBlock of(const std::basic_string<Char, Traits, Alloc> &value)
+        {
+            // short strings live inside the object
+            const auto *object = reinterpret_cast<const std::byte *>(&value);
+            const auto *data = reinterpret_cast<const std::byte *>(value.data());
+            if (data >= object && data < object + sizeof(value))
+                return {};
+            return {(value.size() + 1) * sizeof(Char), (value.capacity() + 1) * sizeof(Char)};
+        }
+    };
+
+    template <typename T, typename Alloc>
+    struct HeapFootprint<std::vector<T, Alloc>>
+    {
+        static MemoryBlock of(const std::vector<T, Alloc> &value)
+        {
+            MemoryBlock block{value.size() * sizeof(T), value.capacity() * sizeof(T)};
+            for (const T &element : value)
+                block += HeapFootprint<T>::of(element);
+            return block;
+        }
+    };
+
+    namespace detail
+    {
+        // Size of the heap chunk behind a request of the given size, modelled on glibc
+        // malloc: an 8 byte header, 16 byte granularity, 32 bytes at least.
+        constexpr size_t heapChunkBytes(size_t bytes)
+        {
+            return std::max<size_t>(32, (bytes + sizeof(size_t) + 15) / 16 * 16);
+        }
+
+        // Red-black tree node of std::map and std::set: color and three links before the
+        // value.
+        template <typename Value>
+        constexpr size_t treeNodeBytes()
+        {
+            return heapChunkBytes(4 * sizeof(void *) + sizeof(Value));
+        }
+
+        // Memory of the containers used by the storage policies. Containers of this library
+        // report themselves through a memoryUsage() member, copy-on-write wrappers through
+        // the container they share.
+        template <typename Container>
+        MemoryBlock containerMemory(const Container &container)
+        {
+            if constexpr (requires { container.memoryUsage(); })
+            {
+                return container.memoryUsage();
+            }
+            else if constexpr (requires { container.get(); })
+            {
+                return containerMemory(container.get());
+            }
+            else if constexpr (requires { typename Container::key_type; typename Container::mapped_type; })
+            {
+                using Value = typename Container::value_type;
+                return {container.size() * sizeof(Value), container.size() * treeNodeBytes<Value>()};
+            }
+            else
+            {
+                using Value = typename Container::value_type;
+                return {container.size() * sizeof(Value), container.capacity() * sizeof(Value)};
+            }
+        }
+
+        // Heap owned by the elements of a container.
+        template <typename T, typename Container>
+        MemoryBlock elementHeap(const Container &container)
+        {
+            MemoryBlock block;
+            for (const T &element : container)
+                block += HeapFootprint<T>::of(element);
+            return block;
+        }
+
+        // Releases unused capacity where the container has any.
+        template <typename Container>
+        void shrinkContainer(Container &container)
+        {
+            if constexpr (requires { container.shrink_to_fit(); })
+                container.shrink_to_fit();
+        }
+    }
+}
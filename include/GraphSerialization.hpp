@@ -0,0 +1,687 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "GraphMatrix.hpp"
+#include "MixedGraph.hpp"
+#include "MappedFile.hpp"
+
+namespace Appledore
+{
+    namespace detail
+    {
+        // Ids and symbols of GraphVertex/GraphEdge only mean something in the process that
+        // handed them out, so these types are never stored as raw bytes.
+        template <typename T>
+        inline constexpr bool processLocalIdentity = std::is_base_of_v<GraphVertex, T> || std::is_base_of_v<GraphEdge, T>;
+
+        // Sort key of the index map. A GraphVertex comes back from a file with a new id, so
+        // it is ordered and looked up by name instead.
+        template <typename T>
+        const T &graphFileKey(const T &vertex)
+        {
+            return vertex;
+        }
+
+        inline std::string graphFileKey(const GraphVertex &vertex)
+        {
+            return vertex.name();
+        }
+    }
+
+    // Byte encoding of vertex payloads. Trivially copyable types are stored as their raw
+    // bytes, std::string as its characters and GraphVertex as its name; a loaded GraphVertex
+    // gets a fresh id. Other vertex types, including classes derived from GraphVertex, need
+    // a specialization:
+    //
+    //   template <> struct Appledore::BinaryCodec<Airport> {
+    //       static void encode(const Airport &a, std::string &out);
+    //       static Airport decode(const std::byte *data, size_t size);
+    //   };
+    template <typename T, typename = void>
+    struct BinaryCodec
+    {
+        static_assert(!detail::processLocalIdentity<T>,
+                      "GraphVertex/GraphEdge ids and symbols are process-local and cannot be stored as raw bytes, "
+                      "specialize Appledore::BinaryCodec to store the payload and name.");
+        static_assert(detail::processLocalIdentity<T>, "No BinaryCodec for this vertex type, specialize Appledore::BinaryCodec.");
+    };
+
+    template <typename T>
+    struct BinaryCodec<T, std::enable_if_t<std::is_trivially_copyable_v<T> && !detail::processLocalIdentity<T>>>
+    {
+        static void encode(const T &value, std::string &out)
+        {
+            out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+        static T decode(const std::byte *data, size_t)
+        {
+            std::array<std::byte, sizeof(T)> raw;
+            std::memcpy(raw.data(), data, sizeof(T));
+            return std::bit_cast<T>(raw);
+        }
+    };
+
+    template <>
+    struct BinaryCodec<std::string>
+    {
+        static void encode(const std::string &value, std::string &out)
+        {
+            out.append(value);
+        }
+        static std::string decode(const std::byte *data, size_t size)
+        {
+            return std::string(reinterpret_cast<const char *>(data), size);
+        }
+    };
+
+    template <>
+    struct BinaryCodec<GraphVertex>
+    {
+        static void encode(const GraphVertex &value, std::string &out)
+        {
+            out.append(value.name());
+        }
+        static GraphVertex decode(const std::byte *data, size_t size)
+        {
+            return GraphVertex(std::string_view(reinterpret_cast<const char *>(data), size));
+        }
+    };
+
+    // On-disk layout (version 1). All integers are native 64-bit words and every section
+    // starts on a 64 byte boundary, so a mapped file can be used without any parsing:
+    //
+    //   header          GraphFileHeader
+    //   vertex table    (V + 1) byte offsets into the vertex blob, then the blob
+    //   index map       V vertex indices sorted by VertexType::operator<
+    //   presence        V rows of ceil(V / 64) words, bit j of row i set if edge i -> j exists
+    //   direction       same shape as presence, bit set if that edge is directed (mixed graphs only)
+    //   row offsets     V + 1 prefix sums of presence bits per row
+    //   values          edge values in row-major order of the presence bits (weighted graphs only)
+    struct GraphFileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t flags;
+        uint32_t byteOrderMark;
+        uint32_t reserved;
+        uint64_t vertexCount;
+        uint64_t edgeCount;
+        uint64_t wordsPerRow;
+        uint64_t edgeValueSize;
+        uint64_t vertexTableOffset;
+        uint64_t vertexBlobSize;
+        uint64_t indexMapOffset;
+        uint64_t presenceOffset;
+        uint64_t directionOffset;
+        uint64_t rowOffsetsOffset;
+        uint64_t valuesOffset;
+        uint64_t fileSize;
+    };
+    static_assert(sizeof(GraphFileHeader) == 120, "GraphFileHeader layout changed");
+
+    inline constexpr char graphFileMagic[8] = {'A', 'P', 'L', 'D', 'G', 'R', 'P', 'H'};
+    inline constexpr uint32_t graphFileVersion = 1;
+    inline constexpr uint32_t graphFileByteOrderMark = 0x01020304;
+
+    // GraphFileHeader::flags
+    inline constexpr uint32_t GraphFileDirected = 1;
+    inline constexpr uint32_t GraphFileWeighted = 2;
+    inline constexpr uint32_t GraphFileMixed = 4;
+
+    namespace detail
+    {
+        inline constexpr uint64_t graphFileAlignment = 64;
+
+        inline uint64_t alignGraphFileOffset(uint64_t offset)
+        {
+            return (offset + graphFileAlignment - 1) / graphFileAlignment * graphFileAlignment;
+        }
+
+        class GraphFileWriter
+        {
+        public:
+            explicit GraphFileWriter(const std::string &path) : out(path, std::ios::binary | std::ios::trunc)
+            {
+                if (!out)
+                {
+                    throw std::runtime_error("Cannot open file for writing: " + path);
+                }
+            }
+
+            void write(const void *data, size_t size)
+            {
+                out.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+                position += size;
+            }
+
+            void padTo(uint64_t offset)
+            {
+                static const char zeros[graphFileAlignment] = {};
+                while (position < offset)
+                {
+                    write(zeros, std::min<uint64_t>(offset - position, graphFileAlignment));
+                }
+            }
+
+            void finish()
+            {
+                out.flush();
+                if (!out)
+                {
+                    throw std::runtime_error("Writing graph file failed");
+                }
+            }
+
+        private:
+            std::ofstream out;
+            uint64_t position = 0;
+        };
+
+        // Shared writer for both graph classes. directedAt(i, j) reports the per-edge
+        // direction bit and is only called for mixed graphs.
+        template <typename VertexType, typename EdgeType, typename Graph, typename DirectedAt>
+        void saveGraphFile(const Graph &graph, const std::string &path, uint32_t flags, DirectedAt directedAt)
+        {
+            constexpr bool weighted = !std::is_same_v<EdgeType, UnweightedG>;
+            static_assert(!weighted || (std::is_trivially_copyable_v<EdgeType> && !processLocalIdentity<EdgeType>),
+                          "Binary graph files store edge values in place, EdgeType must be trivially copyable "
+                          "and not hold a process-local GraphEdge id.");
+            const bool mixed = flags & GraphFileMixed;
+
+            const size_t numVertices = graph.getNumVertices();
+            const size_t wordsPerRow = (numVertices + 63) / 64;
+
+            std::vector<uint64_t> rowOffsets(numVertices + 1, 0);
+            for (size_t src = 0; src < numVertices; ++src)
+            {
+                size_t rowEdges = 0;
+                for (size_t dest = 0; dest < numVertices; ++dest)
+                {
+                    rowEdges += graph.hasEdgeAt(src, dest);
+                }
+                rowOffsets[src + 1] = rowOffsets[src] + rowEdges;
+            }
+
+            std::vector<uint64_t> vertexOffsets(numVertices + 1, 0);
+            std::string vertexBlob;
+            for (size_t i = 0; i < numVertices; ++i)
+            {
+                BinaryCodec<VertexType>::encode(graph.getVertexAt(i), vertexBlob);
+                vertexOffsets[i + 1] = vertexBlob.size();
+            }
+
+            std::vector<uint64_t> indexMap(numVertices);
+            std::iota(indexMap.begin(), indexMap.end(), uint64_t{0});
+            std::sort(indexMap.begin(), indexMap.end(), [&graph](uint64_t a, uint64_t b)
+                      { return graphFileKey(graph.getVertexAt(a)) < graphFileKey(graph.getVertexAt(b)); });
+
+            GraphFileHeader header{};
+            std::memcpy(header.magic, graphFileMagic, sizeof(graphFileMagic));
+            header.version = graphFileVersion;
+            header.flags = flags | (weighted ? GraphFileWeighted : 0u);
+            header.byteOrderMark = graphFileByteOrderMark;
+            header.vertexCount = numVertices;
+            header.edgeCount = rowOffsets[numVertices];
+            header.wordsPerRow = wordsPerRow;
+            header.edgeValueSize = weighted ? sizeof(EdgeType) : 0;
+
+            const uint64_t matrixBytes = uint64_t{numVertices} * wordsPerRow * sizeof(uint64_t);
+            header.vertexTableOffset = alignGraphFileOffset(sizeof(GraphFileHeader));
+            header.vertexBlobSize = vertexBlob.size();
+            header.indexMapOffset = alignGraphFileOffset(header.vertexTableOffset + vertexOffsets.size() * sizeof(uint64_t) + vertexBlob.size());
+            header.presenceOffset = alignGraphFileOffset(header.indexMapOffset + indexMap.size() * sizeof(uint64_t));
+            header.directionOffset = mixed ? alignGraphFileOffset(header.presenceOffset + matrixBytes) : 0;
+            header.rowOffsetsOffset = alignGraphFileOffset((mixed ? header.directionOffset : header.presenceOffset) + matrixBytes);
+            header.valuesOffset = alignGraphFileOffset(header.rowOffsetsOffset + rowOffsets.size() * sizeof(uint64_t));
+            header.fileSize = header.valuesOffset + header.edgeCount * header.edgeValueSize;
+
+            GraphFileWriter writer(path);
+            writer.write(&header, sizeof(header));
+
+            writer.padTo(header.vertexTableOffset);
+            writer.write(vertexOffsets.data(), vertexOffsets.size() * sizeof(uint64_t));
+            writer.write(vertexBlob.data(), vertexBlob.size());
+
+            writer.padTo(header.indexMapOffset);
+            writer.write(indexMap.data(), indexMap.size() * sizeof(uint64_t));
+
+            std::vector<uint64_t> row(wordsPerRow);
+            auto writeBitmap = [&](auto bitAt)
+            {
+                for (size_t src = 0; src < numVertices; ++src)
+                {
+                    std::fill(row.begin(), row.end(), 0);
+                    for (size_t dest = 0; dest < numVertices; ++dest)
+                    {
+                        if (bitAt(src, dest))
+                        {
+                            row[dest / 64] |= uint64_t{1} << (dest % 64);
+                        }
+                    }
+                    writer.write(row.data(), row.size() * sizeof(uint64_t));
+                }
+            };
+
+            writer.padTo(header.presenceOffset);
+            writeBitmap([&graph](size_t src, size_t dest)
+                        { return graph.hasEdgeAt(src, dest); });
+
+            if (mixed)
+            {
+                writer.padTo(header.directionOffset);
+                writeBitmap([&](size_t src, size_t dest)
+                            { return graph.hasEdgeAt(src, dest) && directedAt(src, dest); });
+            }
+
+            writer.padTo(header.rowOffsetsOffset);
+            writer.write(rowOffsets.data(), rowOffsets.size() * sizeof(uint64_t));
+
+            writer.padTo(header.valuesOffset);
+            if constexpr (weighted)
+            {
+                for (size_t src = 0; src < numVertices; ++src)
+                {
+                    for (size_t dest = 0; dest < numVertices; ++dest)
+                    {
+                        if (graph.hasEdgeAt(src, dest))
+                        {
+                            const EdgeType &value = graph.getEdgeAt(src, dest);
+                            writer.write(&value, sizeof(EdgeType));
+                        }
+                    }
+                }
+            }
+            writer.finish();
+        }
+    }
+
+    template <typename VertexType, typename EdgeType, typename Direction, typename Storage>
+    void saveGraph(const GraphMatrix<VertexType, EdgeType, Direction, Storage> &graph, const std::string &path)
+    {
+        constexpr uint32_t flags = std::is_same_v<Direction, DirectedG> ? GraphFileDirected : 0u;
+        detail::saveGraphFile<VertexType, EdgeType>(graph, path, flags, [](size_t, size_t)
+                                                    { return false; });
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void saveGraph(const MixedGraphMatrix<VertexType, EdgeType, Storage> &graph, const std::string &path)
+    {
+        detail::saveGraphFile<VertexType, EdgeType>(graph, path, GraphFileMixed, [&graph](size_t src, size_t dest)
+                                                    { return graph.isDirectedAt(src, dest); });
+    }
+
+    // Read-only graph served straight from a mapped graph file. Opening validates the header,
+    // the section layout and the O(V) tables, throwing std::runtime_error for a truncated or
+    // corrupt file, and sets up pointers into the mapping; the adjacency bitmaps and edge values are
+    // used in place and never parsed or copied. Vertices are decoded on access.
+    template <typename VertexType, typename EdgeType>
+    class GraphFileView
+    {
+        static_assert(!detail::processLocalIdentity<EdgeType>, "GraphEdge ids are process-local and cannot be read from a graph file.");
+
+    public:
+        explicit GraphFileView(const std::string &path) : file(path)
+        {
+            if (file.size() < sizeof(GraphFileHeader))
+            {
+                throw std::runtime_error("Not a graph file: " + path);
+            }
+            std::memcpy(&header, file.data(), sizeof(GraphFileHeader));
+
+            if (std::memcmp(header.magic, graphFileMagic, sizeof(graphFileMagic)) != 0)
+                throw std::runtime_error("Not a graph file: " + path);
+            if (header.version != graphFileVersion)
+                throw std::runtime_error("Unsupported graph file version: " + std::to_string(header.version));
+            if (header.byteOrderMark != graphFileByteOrderMark)
+                throw std::runtime_error("Graph file was written with a different byte order");
+            if (header.fileSize > file.size())
+                throw std::runtime_error("Graph file is truncated: " + path);
+
+            constexpr bool weighted = !std::is_same_v<EdgeType, UnweightedG>;
+            if (bool(header.flags & GraphFileWeighted) != weighted || (weighted && header.edgeValueSize != sizeof(EdgeType)))
+                throw std::runtime_error("Graph file edge type does not match EdgeType");
+            if (!weighted && header.edgeValueSize != 0)
+                throw std::runtime_error("Graph file is corrupt: edge values in an unweighted graph");
+
+            checkLayout();
+            vertexOffsets = section<uint64_t>(header.vertexTableOffset);
+            vertexBlob = file.data() + header.vertexTableOffset + (header.vertexCount + 1) * sizeof(uint64_t);
+            indexMap = section<uint64_t>(header.indexMapOffset);
+            presence = section<uint64_t>(header.presenceOffset);
+            direction = header.directionOffset ? section<uint64_t>(header.directionOffset) : nullptr;
+            rowOffsets = section<uint64_t>(header.rowOffsetsOffset);
+            values = file.data() + header.valuesOffset;
+            checkTables();
+        }
+
+        [[nodiscard]] size_t getNumVertices() const { return header.vertexCount; }
+        [[nodiscard]] size_t getNumEdges() const { return header.edgeCount; }
+        [[nodiscard]] bool isDirected() const { return header.flags & GraphFileDirected; }
+        [[nodiscard]] bool isMixed() const { return header.flags & GraphFileMixed; }
+
+        [[nodiscard]] VertexType getVertexAt(size_t index) const
+        {
+            checkIndex(index);
+            return BinaryCodec<VertexType>::decode(vertexBlob + vertexOffsets[index], vertexOffsets[index + 1] - vertexOffsets[index]);
+        }
+
+        // Binary search over the sorted index map, O(log V) vertex decodes. GraphVertex is
+        // matched by name.
+        [[nodiscard]] size_t getIndexOf(const VertexType &vertex) const
+        {
+            const uint64_t *first = indexMap;
+            const uint64_t *last = indexMap + header.vertexCount;
+            const uint64_t *it = std::lower_bound(first, last, vertex, [this](uint64_t index, const VertexType &value)
+                                                  { return detail::graphFileKey(getVertexAt(index)) < detail::graphFileKey(value); });
+            if (it == last || detail::graphFileKey(vertex) < detail::graphFileKey(getVertexAt(*it)))
+            {
+                throw std::invalid_argument("Vertex does not exist in the graph");
+            }
+            return *it;
+        }
+
+        [[nodiscard]] bool hasEdgeAt(size_t srcIndex, size_t destIndex) const
+        {
+            checkIndex(srcIndex);
+            checkIndex(destIndex);
+            return (rowWords(presence, srcIndex)[destIndex / 64] >> (destIndex % 64)) & 1;
+        }
+
+        [[nodiscard]] bool hasEdge(const VertexType &src, const VertexType &dest) const
+        {
+            return hasEdgeAt(getIndexOf(src), getIndexOf(dest));
+        }
+
+        [[nodiscard]] EdgeType getEdgeAt(size_t srcIndex, size_t destIndex) const
+        {
+            if (!hasEdgeAt(srcIndex, destIndex))
+            {
+                throw std::runtime_error("No Edge exists between the given vertices.");
+            }
+            if constexpr (std::is_same_v<EdgeType, UnweightedG>)
+            {
+                return EdgeType{};
+            }
+            else
+            {
+                const uint64_t *row = rowWords(presence, srcIndex);
+                uint64_t rank = rowOffsets[srcIndex];
+                for (size_t w = 0; w < destIndex / 64; ++w)
+                {
+                    rank += std::popcount(row[w]);
+                }
+                rank += std::popcount(row[destIndex / 64] & ((uint64_t{1} << (destIndex % 64)) - 1));
+                if (rank >= rowOffsets[srcIndex + 1])
+                    corrupt("adjacency bitmap does not match the row offsets");
+                return BinaryCodec<EdgeType>::decode(values + rank * sizeof(EdgeType), sizeof(EdgeType));
+            }
+        }
+
+        [[nodiscard]] EdgeType getEdge(const VertexType &src, const VertexType &dest) const
+        {
+            return getEdgeAt(getIndexOf(src), getIndexOf(dest));
+        }
+
+        [[nodiscard]] bool isDirectedAt(size_t srcIndex, size_t destIndex) const
+        {
+            if (!hasEdgeAt(srcIndex, destIndex))
+            {
+                throw std::runtime_error("No Edge exists between the given vertices.");
+            }
+            if (!direction)
+            {
+                return isDirected();
+            }
+            return (rowWords(direction, srcIndex)[destIndex / 64] >> (destIndex % 64)) & 1;
+        }
+
+        [[nodiscard]] size_t outdegreeAt(size_t index) const
+        {
+            checkIndex(index);
+            return rowOffsets[index + 1] - rowOffsets[index];
+        }
+
+        [[nodiscard]] size_t indegreeAt(size_t index) const
+        {
+            checkIndex(index);
+            size_t degree = 0;
+            for (size_t src = 0; src < header.vertexCount; ++src)
+            {
+                degree += (rowWords(presence, src)[index / 64] >> (index % 64)) & 1;
+            }
+            return degree;
+        }
+
+        // Out-neighbor indices of a vertex, in increasing order.
+        [[nodiscard]] std::vector<size_t> getNeighborsAt(size_t index) const
+        {
+            checkIndex(index);
+            std::vector<size_t> neighbors;
+            neighbors.reserve(outdegreeAt(index));
+            for (size_t w = 0; w < header.wordsPerRow; ++w)
+            {
+                for (uint64_t bits = rowWord(presence, index, w); bits; bits &= bits - 1)
+                {
+                    neighbors.push_back(w * 64 + std::countr_zero(bits));
+                }
+            }
+            return neighbors;
+        }
+
+        void advise(MappedAccess access) const
+        {
+            file.advise(access);
+        }
+
+    private:
+        MappedFile file;
+        GraphFileHeader header;
+        const uint64_t *vertexOffsets = nullptr;
+        const std::byte *vertexBlob = nullptr;
+        const uint64_t *indexMap = nullptr;
+        const uint64_t *presence = nullptr;
+        const uint64_t *direction = nullptr;
+        const uint64_t *rowOffsets = nullptr;
+        const std::byte *values = nullptr;
+
+        template <typename T>
+        const T *section(uint64_t offset) const
+        {
+            return reinterpret_cast<const T *>(file.data() + offset);
+        }
+
+        [[noreturn]] static void corrupt(const char *what)
+        {
+            throw std::runtime_error(std::string("Graph file is corrupt: ") + what);
+        }
+
+        // count * size bytes, throws when that does not fit in 64 bits.
+        static uint64_t sectionBytes(uint64_t count, uint64_t size)
+        {
+            if (size != 0 && count > std::numeric_limits<uint64_t>::max() / size)
+                corrupt("section size overflows");
+            return count * size;
+        }
+
+        // Sections must be aligned, in file order and inside the mapping, so that every
+        // pointer set up from the header stays in bounds.
+        void checkLayout() const
+        {
+            const uint64_t vertexCount = header.vertexCount;
+            if (vertexCount >= std::numeric_limits<uint64_t>::max() / sizeof(uint64_t))
+                corrupt("vertex count out of range");
+            if (header.wordsPerRow != (vertexCount + 63) / 64)
+                corrupt("row width does not match the vertex count");
+            if (bool(header.flags & GraphFileMixed) != (header.directionOffset != 0))
+                corrupt("direction bitmap does not match the graph kind");
+
+            const uint64_t matrixBytes = sectionBytes(sectionBytes(vertexCount, header.wordsPerRow), sizeof(uint64_t));
+            uint64_t end = sizeof(GraphFileHeader);
+            auto place = [&](uint64_t offset, uint64_t bytes, const char *name)
+            {
+                if (offset % detail::graphFileAlignment != 0 || offset < end || bytes > header.fileSize ||
+                    offset > header.fileSize - bytes)
+                    corrupt(name);
+                end = offset + bytes;
+            };
+            const uint64_t tableBytes = sectionBytes(vertexCount + 1, sizeof(uint64_t));
+            if (header.vertexBlobSize > std::numeric_limits<uint64_t>::max() - tableBytes)
+                corrupt("vertex table size overflows");
+            place(header.vertexTableOffset, tableBytes + header.vertexBlobSize, "vertex table out of bounds");
+            place(header.indexMapOffset, sectionBytes(vertexCount, sizeof(uint64_t)), "index map out of bounds");
+            place(header.presenceOffset, matrixBytes, "adjacency bitmap out of bounds");
+            if (header.directionOffset)
+                place(header.directionOffset, matrixBytes, "direction bitmap out of bounds");
+            place(header.rowOffsetsOffset, tableBytes, "row offsets out of bounds");
+            place(header.valuesOffset, sectionBytes(header.edgeCount, header.edgeValueSize), "edge values out of bounds");
+        }
+
+        // O(V) checks of the tables the accessors index with. The bitmaps are not scanned,
+        // so opening stays cheap; accessors guard against bits that disagree with them.
+        void checkTables() const
+        {
+            const uint64_t vertexCount = header.vertexCount;
+            if (vertexOffsets[0] != 0 || vertexOffsets[vertexCount] != header.vertexBlobSize)
+                corrupt("vertex offsets do not span the vertex blob");
+            for (uint64_t i = 0; i < vertexCount; ++i)
+            {
+                if (vertexOffsets[i] > vertexOffsets[i + 1])
+                    corrupt("vertex offsets are not ascending");
+                if (indexMap[i] >= vertexCount)
+                    corrupt("index map entry out of range");
+            }
+            if (rowOffsets[0] != 0 || rowOffsets[vertexCount] != header.edgeCount)
+                corrupt("row offsets do not match the edge count");
+            for (uint64_t i = 0; i < vertexCount; ++i)
+            {
+                if (rowOffsets[i] > rowOffsets[i + 1] || rowOffsets[i + 1] - rowOffsets[i] > vertexCount)
+                    corrupt("row offsets are not ascending");
+            }
+        }
+
+        // Row word w without the padding bits past the last vertex.
+        uint64_t rowWord(const uint64_t *bitmap, size_t row, size_t w) const
+        {
+            uint64_t bits = rowWords(bitmap, row)[w];
+            size_t tail = header.vertexCount % 64;
+            if (tail != 0 && w + 1 == header.wordsPerRow)
+                bits &= (uint64_t{1} << tail) - 1;
+            return bits;
+        }
+
+        const uint64_t *rowWords(const uint64_t *bitmap, size_t row) const
+        {
+            return bitmap + row * header.wordsPerRow;
+        }
+
+        void checkIndex(size_t index) const
+        {
+            if (index >= header.vertexCount)
+            {
+                throw std::out_of_range("Vertex index out of range");
+            }
+        }
+    };
+
+    static_assert(AdjacencyMatrixGraph<GraphFileView<int, int>>);
+
+    // Loads a graph file into a mutable graph. Unlike GraphFileView this copies everything.
+    template <typename Graph>
+    Graph loadGraph(const std::string &path);
+
+    namespace detail
+    {
+        template <typename Graph>
+        struct GraphFileTraits;
+
+        template <typename VertexType, typename EdgeType, typename Direction, typename Storage>
+        struct GraphFileTraits<GraphMatrix<VertexType, EdgeType, Direction, Storage>>
+        {
+            using Vertex = VertexType;
+            using Edge = EdgeType;
+            static constexpr bool mixed = false;
+        };
+
+        template <typename VertexType, typename EdgeType, typename Storage>
+        struct GraphFileTraits<MixedGraphMatrix<VertexType, EdgeType, Storage>>
+        {
+            using Vertex = VertexType;
+            using Edge = EdgeType;
+            static constexpr bool mixed = true;
+        };
+    }
+
+    template <typename Graph>
+    Graph loadGraph(const std::string &path)
+    {
+        using VertexType = typename detail::GraphFileTraits<Graph>::Vertex;
+        using EdgeType = typename detail::GraphFileTraits<Graph>::Edge;
+        constexpr bool mixed = detail::GraphFileTraits<Graph>::mixed;
+
+        GraphFileView<VertexType, EdgeType> view(path);
+        if (view.isMixed() != mixed)
+        {
+            throw std::runtime_error("Graph file kind does not match the requested graph type");
+        }
+
+        std::vector<VertexType> vertices;
+        vertices.reserve(view.getNumVertices());
+        for (size_t i = 0; i < view.getNumVertices(); ++i)
+        {
+            vertices.push_back(view.getVertexAt(i));
+        }
+
+        Graph graph;
+        graph.addVertices(vertices);
+        view.advise(MappedAccess::Sequential);
+
+        // Mixed files go in two passes, undirected cells first: an undirected addEdge sets
+        // both cells, so it must not overwrite the directed half of a pair whose other half
+        // is undirected (addEdge(s, d, false) then addEdge(s, d, true)).
+        auto addEdges = [&](bool directedPass)
+        {
+            for (size_t src = 0; src < vertices.size(); ++src)
+            {
+                for (size_t dest : view.getNeighborsAt(src))
+                {
+                    bool directed = view.isDirectedAt(src, dest);
+                    if (mixed && directed != directedPass)
+                        continue;
+                    // undirected pairs are stored in both rows, add them once.
+                    if (!directed && src > dest && view.hasEdgeAt(dest, src) && !view.isDirectedAt(dest, src))
+                        continue;
+
+                    if constexpr (mixed)
+                    {
+                        graph.addEdge(vertices[src], vertices[dest], view.getEdgeAt(src, dest), directed);
+                    }
+                    else if constexpr (std::is_same_v<EdgeType, UnweightedG>)
+                    {
+                        graph.addEdge(vertices[src], vertices[dest]);
+                    }
+                    else
+                    {
+                        graph.addEdge(vertices[src], vertices[dest], view.getEdgeAt(src, dest));
+                    }
+                }
+            }
+        };
+        addEdges(false);
+        if constexpr (mixed)
+        {
+            addEdges(true);
+        }
+        return graph;
+    }
+}
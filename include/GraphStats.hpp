@@ -0,0 +1,264 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace Appledore
+{
+    // Public graph operations that an instrumented graph times. Index level accessors
+    // (hasEdgeAt, getEdgeAt, forEachOutNeighborAt) are meant for inner loops and are not
+    // timed; their row scans still show up in GraphCounter::RowsScanned.
+    enum class GraphOp : uint8_t
+    {
+        AddVertex,
+        RemoveVertex,
+        AddEdge,
+        RemoveEdge,
+        UpdateEdge,
+        HasEdge,
+        GetEdge,
+        GetEdges,
+        Degree,
+        Neighbors,
+        FindAllPaths,
+        CountPaths,
+        Density,
+        Connectivity,
+        Isolated,
+        CycleCheck,
+        Orientation,
+        Bridges
+    };
+    inline constexpr size_t graphOpCount = static_cast<size_t>(GraphOp::Bridges) + 1;
+
+    constexpr std::string_view graphOpName(GraphOp op)
+    {
+        constexpr std::array<std::string_view, graphOpCount> names{
+            "addVertex", "removeVertex", "addEdge", "removeEdge", "updateEdge", "hasEdge",
+            "getEdge", "getEdges", "degree", "neighbors", "findAllPaths", "countPaths",
+            "density", "connectivity", "isolated", "cycleCheck", "orientation", "bridges"};
+        return names[static_cast<size_t>(op)];
+    }
+
+    // Work done inside algorithms, summed over all calls.
+    enum class GraphCounter : uint8_t
+    {
+        NodesExpanded,  // vertices taken off a search stack or queue and expanded
+        PathsEmitted,   // paths returned or counted by findAllPaths / countPathsDFS
+        RowsScanned,    // adjacency rows walked
+        ColumnsScanned, // adjacency columns walked (in-degrees)
+    };
+    inline constexpr size_t graphCounterCount = static_cast<size_t>(GraphCounter::ColumnsScanned) + 1;
+
+    // Bucket b counts calls that took [2^b, 2^(b+1)) nanoseconds, bucket 0 also takes 0 ns
+    // and the last bucket everything above.
+    struct LatencyHistogram
+    {
+        static constexpr size_t buckets = 40;
+        std::array<uint64_t, buckets> counts{};
+
+        static constexpr size_t bucketOf(uint64_t ns)
+        {
+            size_t bucket = ns ? static_cast<size_t>(std::bit_width(ns)) - 1 : 0;
+            return bucket < buckets ? bucket : buckets - 1;
+        }
+
+        [[nodiscard]] uint64_t calls() const
+        {
+            uint64_t total = 0;
+            for (uint64_t count : counts)
+                total += count;
+            return total;
+        }
+
+        // Upper bound in nanoseconds of the bucket holding quantile q (0.99 for p99), 0
+        // without calls.
+        [[nodiscard]] uint64_t quantileNs(double q) const
+        {
+            uint64_t total = calls();
+            if (total == 0)
+                return 0;
+            uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t b = 0; b < buckets; ++b)
+            {
+                seen += counts[b];
+                if (seen >= rank)
+                    return (uint64_t{2} << b) - 1;
+            }
+            return (uint64_t{2} << (buckets - 1)) - 1;
+        }
+    };
+
+    struct OpStats
+    {
+        uint64_t calls = 0;
+        uint64_t totalNs = 0;
+        LatencyHistogram latency;
+
+        [[nodiscard]] double meanNs() const
+        {
+            return calls ? static_cast<double>(totalNs) / static_cast<double>(calls) : 0.0;
+        }
+    };
+
+    // Snapshot returned by stats() on an instrumented graph.
+    struct GraphStats
+    {
+        std::array<OpStats, graphOpCount> ops{};
+        std::array<uint64_t, graphCounterCount> counters{};
+
+        const OpStats &operator[](GraphOp op) const { return ops[static_cast<size_t>(op)]; }
+        uint64_t operator[](GraphCounter counter) const { return counters[static_cast<size_t>(counter)]; }
+    };
+
+    // Storage policy adapter that turns instrumentation on, keeping the containers of the
+    // wrapped policy:
+    //
+    //   GraphMatrix<int, double, DirectedG, Instrumented<DenseStorage>> graph;
+    //   ...
+    //   GraphStats stats = graph.stats();
+    //   stats[GraphOp::HasEdge].latency.quantileNs(0.99);
+    //
+    // With any other policy the recording calls compile to nothing and the graph has no
+    // stats() member.
+    template <typename Storage>
+    struct Instrumented : Storage
+    {
+        static constexpr bool instrumented = true;
+    };
+
+    namespace detail
+    {
+        template <typename Storage>
+        concept InstrumentedStorage = requires { requires Storage::instrumented; };
+
+        // Depth of timed calls on this thread. Only the outermost call is recorded, so a
+        // public operation built on others (totalDegree on indegree and outdegree) counts
+        // once.
+        inline thread_local unsigned timedCallDepth = 0;
+
+        // Relaxed atomics, so concurrent readers of a shared graph can record without a lock.
+        class StatsRecorder
+        {
+        public:
+            class Timer
+            {
+            public:
+                Timer(const StatsRecorder &recorder, GraphOp op)
+                    : recorder(timedCallDepth++ == 0 ? &recorder : nullptr), op(op)
+                {
+                    if (this->recorder)
+                        start = std::chrono::steady_clock::now();
+                }
+                Timer(const Timer &) = delete;
+                Timer &operator=(const Timer &) = delete;
+                ~Timer()
+                {
+                    --timedCallDepth;
+                    if (recorder)
+                    {
+                        auto elapsed = std::chrono::steady_clock::now() - start;
+                        recorder->record(op, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+                    }
+                }
+
+            private:
+                const StatsRecorder *recorder;
+                GraphOp op;
+                std::chrono::steady_clock::time_point start;
+            };
+
+            StatsRecorder() = default;
+            StatsRecorder(const StatsRecorder &other) { copyFrom(other); }
+            StatsRecorder &operator=(const StatsRecorder &other)
+            {
+                if (this != &other)
+                    copyFrom(other);
+                return *this;
+            }
+
+            [[nodiscard]] Timer time(GraphOp op) const { return Timer(*this, op); }
+
+            void add(GraphCounter counter, uint64_t amount = 1) const
+            {
+                counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] GraphStats snapshot() const
+            {
+                GraphStats stats;
+                for (size_t op = 0; op < graphOpCount; ++op)
+                {
+                    stats.ops[op].calls = ops[op].calls.load(std::memory_order_relaxed);
+                    stats.ops[op].totalNs = ops[op].totalNs.load(std::memory_order_relaxed);
+                    for (size_t b = 0; b < LatencyHistogram::buckets; ++b)
+                        stats.ops[op].latency.counts[b] = ops[op].latency[b].load(std::memory_order_relaxed);
+                }
+                for (size_t c = 0; c < graphCounterCount; ++c)
+                    stats.counters[c] = counters[c].load(std::memory_order_relaxed);
+                return stats;
+            }
+
+            void reset()
+            {
+                restore(GraphStats{});
+            }
+
+        private:
+            struct AtomicOpStats
+            {
+                std::atomic<uint64_t> calls{0};
+                std::atomic<uint64_t> totalNs{0};
+                std::array<std::atomic<uint64_t>, LatencyHistogram::buckets> latency{};
+            };
+
+            mutable std::array<AtomicOpStats, graphOpCount> ops{};
+            mutable std::array<std::atomic<uint64_t>, graphCounterCount> counters{};
+
+            void record(GraphOp op, uint64_t ns) const
+            {
+                AtomicOpStats &stats = ops[static_cast<size_t>(op)];
+                stats.calls.fetch_add(1, std::memory_order_relaxed);
+                stats.totalNs.fetch_add(ns, std::memory_order_relaxed);
+                stats.latency[LatencyHistogram::bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void restore(const GraphStats &stats)
+            {
+                for (size_t op = 0; op < graphOpCount; ++op)
+                {
+                    ops[op].calls.store(stats.ops[op].calls, std::memory_order_relaxed);
+                    ops[op].totalNs.store(stats.ops[op].totalNs, std::memory_order_relaxed);
+                    for (size_t b = 0; b < LatencyHistogram::buckets; ++b)
+                        ops[op].latency[b].store(stats.ops[op].latency.counts[b], std::memory_order_relaxed);
+                }
+                for (size_t c = 0; c < graphCounterCount; ++c)
+                    counters[c].store(stats.counters[c], std::memory_order_relaxed);
+            }
+
+            // copies of a graph carry its statistics along.
+            void copyFrom(const StatsRecorder &other) { restore(other.snapshot()); }
+        };
+
+        // Stand-in for uninstrumented graphs, every call is a no-op.
+        struct NoStatsRecorder
+        {
+            struct Timer
+            {
+                ~Timer() {} // user provided, so an unused timer does not warn
+            };
+
+            Timer time(GraphOp) const { return {}; }
+            void add(GraphCounter, uint64_t = 1) const {}
+        };
+
+        template <typename Storage>
+        using StatsRecorderFor = std::conditional_t<InstrumentedStorage<Storage>, StatsRecorder, NoStatsRecorder>;
+    }
+}
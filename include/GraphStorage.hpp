@@ -0,0 +1,332 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "GraphMemory.hpp"
+
+namespace Appledore
+{
+    // Wraps a standard container so that copies share it until one of them is modified.
+    // Read-only members never copy; every mutating member first makes the container
+    // unique to this wrapper.
+    template <typename Container>
+    class CopyOnWrite
+    {
+    public:
+        CopyOnWrite() : data(std::make_shared<Container>()) {}
+
+        operator const Container &() const { return *data; }
+        const Container &get() const { return *data; }
+
+        Container &edit()
+        {
+            if (data.use_count() > 1)
+            {
+                data = std::make_shared<Container>(*data);
+            }
+            return *data;
+        }
+
+        [[nodiscard]] size_t size() const { return data->size(); }
+        [[nodiscard]] bool empty() const { return data->empty(); }
+
+        template <typename Key>
+        size_t count(const Key &key) const { return data->count(key); }
+        template <typename Key>
+        decltype(auto) at(const Key &key) const { return data->at(key); }
+        template <typename Key>
+        auto find(const Key &key) const { return data->find(key); }
+        template <typename Key>
+        auto find(const Key &key) { return edit().find(key); }
+
+        template <typename Key>
+        decltype(auto) operator[](const Key &key) const { return (*data)[key]; }
+        template <typename Key>
+        decltype(auto) operator[](const Key &key) { return edit()[key]; }
+
+        auto begin() const { return data->cbegin(); }
+        auto end() const { return data->cend(); }
+        auto begin() { return edit().begin(); }
+        auto end() { return edit().end(); }
+
+        template <typename... Args>
+        decltype(auto) erase(Args &&...args) { return edit().erase(std::forward<Args>(args)...); }
+        template <typename Value>
+        void push_back(Value &&value) { edit().push_back(std::forward<Value>(value)); }
+        void pop_back() { edit().pop_back(); }
+
+        // Only a container this wrapper owns alone is shrunk, a shared one stays shared.
+        void shrink_to_fit()
+        {
+            if (data.use_count() == 1)
+                detail::shrinkContainer(*data);
+        }
+
+    private:
+        std::shared_ptr<Container> data;
+    };
+
+    // Persistent vector used for copy-on-write adjacency storage. Elements live in blocks of
+    // 1024 that hang off a radix tree of 64-way nodes, all reference counted. Copying the
+    // vector only copies the root pointer; writing an element copies the one block that
+    // holds it plus the nodes on its path, if they are shared with another copy. Blocks
+    // that were never written are not allocated and read as T{}.
+    template <typename T>
+    class CowChunkedVector
+    {
+        static constexpr size_t blockBits = 10;
+        static constexpr size_t fanoutBits = 6;
+        static constexpr size_t blockMask = (size_t{1} << blockBits) - 1;
+        static constexpr size_t fanoutMask = (size_t{1} << fanoutBits) - 1;
+
+        struct Node
+        {
+            std::vector<std::shared_ptr<Node>> children;
+            std::vector<T> values;
+        };
+
+    public:
+        CowChunkedVector() = default;
+        explicit CowChunkedVector(size_t count) { resize(count); }
+
+        [[nodiscard]] size_t size() const { return count; }
+
+        const T &operator[](size_t index) const
+        {
+            const Node *node = root.get();
+            size_t block = index >> blockBits;
+            for (size_t level = depth; level > 0 && node; --level)
+            {
+                node = node->children[(block >> ((level - 1) * fanoutBits)) & fanoutMask].get();
+            }
+            return node ? node->values[index & blockMask] : emptyValue();
+        }
+
+        T &operator[](size_t index)
+        {
+            return mutableBlock(index >> blockBits)->values[index & blockMask];
+        }
+
+        // New elements are T{}; elements past the new size are reset so that growing again
+        // never exposes stale values.
+        void resize(size_t newCount)
+        {
+            while (capacity() < newCount)
+            {
+                if (root)
+                {
+                    auto newRoot = std::make_shared<Node>();
+                    newRoot->children.resize(size_t{1} << fanoutBits);
+                    newRoot->children[0] = std::move(root);
+                    root = std::move(newRoot);
+                }
+                ++depth;
+            }
+
+            for (size_t index = newCount; index < count;)
+            {
+                size_t block = index >> blockBits;
+                size_t blockEnd = (block + 1) << blockBits;
+                if (blockExists(block))
+                {
+                    auto &values = mutableBlock(block)->values;
+                    for (size_t i = index; i < blockEnd && i < count; ++i)
+                    {
+                        values[i & blockMask] = T{};
+                    }
+                }
+                index = blockEnd;
+            }
+            count = newCount;
+        }
+
+        // Drops the blocks past size() that a shrinking resize left allocated, and the
+        // tree levels no longer needed. Nodes shared with another copy are copied first.
+        void shrink_to_fit()
+        {
+            size_t blocks = (count + blockMask) >> blockBits;
+            while (depth > 0 && blocks <= (size_t{1} << ((depth - 1) * fanoutBits)))
+            {
+                root = root ? root->children[0] : nullptr;
+                --depth;
+            }
+            if (blocks == 0)
+            {
+                root.reset();
+                return;
+            }
+
+            size_t lastBlock = blocks - 1;
+            std::shared_ptr<Node> *slot = &root;
+            for (size_t level = depth; level > 0 && *slot; --level)
+            {
+                size_t child = (lastBlock >> ((level - 1) * fanoutBits)) & fanoutMask;
+                const auto &children = (*slot)->children;
+                if (std::any_of(children.begin() + child + 1, children.end(), [](const auto &node)
+                                { return node != nullptr; }))
+                {
+                    if (slot->use_count() > 1)
+                        *slot = std::make_shared<Node>(**slot);
+                    std::fill((*slot)->children.begin() + child + 1, (*slot)->children.end(), nullptr);
+                }
+                slot = &(*slot)->children[child];
+            }
+        }
+
+        // Cells of allocated blocks below size() are used, everything else reachable from
+        // this vector is capacity. Blocks shared with other copies are counted as well.
+        [[nodiscard]] MemoryBlock memoryUsage() const
+        {
+            MemoryBlock usage;
+            addNodeMemory(root.get(), depth, 0, usage);
+            return usage;
+        }
+
+    private:
+        std::shared_ptr<Node> root;
+        size_t count = 0;
+        size_t depth = 0;
+
+        static const T &emptyValue()
+        {
+            static const T value{};
+            return value;
+        }
+
+        size_t capacity() const
+        {
+            return (size_t{1} << blockBits) << (depth * fanoutBits);
+        }
+
+        void addNodeMemory(const Node *node, size_t level, size_t firstBlock, MemoryBlock &usage) const
+        {
+            if (!node)
+                return;
+            // make_shared puts the node after a control block of two counters and a vtable.
+            usage.capacity += detail::heapChunkBytes(sizeof(Node) + 2 * sizeof(void *));
+            usage.capacity += node->children.capacity() * sizeof(std::shared_ptr<Node>);
+            usage.capacity += node->values.capacity() * sizeof(T);
+            if (level == 0)
+            {
+                size_t first = firstBlock << blockBits;
+                usage.used += (count > first ? std::min(count - first, node->values.size()) : 0) * sizeof(T);
+                return;
+            }
+            size_t span = size_t{1} << ((level - 1) * fanoutBits);
+            for (size_t i = 0; i < node->children.size(); ++i)
+            {
+                addNodeMemory(node->children[i].get(), level - 1, firstBlock + i * span, usage);
+            }
+        }
+
+        bool blockExists(size_t block) const
+        {
+            const Node *node = root.get();
+            for (size_t level = depth; level > 0 && node; --level)
+            {
+                node = node->children[(block >> ((level - 1) * fanoutBits)) & fanoutMask].get();
+            }
+            return node != nullptr;
+        }
+
+        // Makes every node on the path to block exclusively owned, creating missing ones.
+        Node *mutableBlock(size_t block)
+        {
+            std::shared_ptr<Node> *slot = &root;
+            for (size_t level = depth; level > 0; --level)
+            {
+                if (!*slot)
+                {
+                    *slot = std::make_shared<Node>();
+                    (*slot)->children.resize(size_t{1} << fanoutBits);
+                }
+                else if (slot->use_count() > 1)
+                {
+                    *slot = std::make_shared<Node>(**slot);
+                }
+                slot = &(*slot)->children[(block >> ((level - 1) * fanoutBits)) & fanoutMask];
+            }
+
+            if (!*slot)
+            {
+                *slot = std::make_shared<Node>();
+                (*slot)->values.resize(size_t{1} << blockBits);
+            }
+            else if (slot->use_count() > 1)
+            {
+                *slot = std::make_shared<Node>(**slot);
+            }
+            return slot->get();
+        }
+    };
+
+    // Storage policies for GraphMatrix. A policy names the containers used for the
+    // adjacency cells and for the vertex index maps.
+    //
+    // DenseStorage: plain std::vector/std::map, copies are deep.
+    // CowStorage:   copy-on-write containers. Copying a graph (e.g. snapshot()) is O(1);
+    //               an edge write copies only the 1024-cell block it touches, vertex
+    //               insertions and removals copy the vertex maps.
+    // PmrStorage:   std::pmr containers. A graph constructed with a memory resource
+    //               allocates everything from it, so a graph in a monotonic arena is
+    //               released with the arena. Copies use the default resource, as
+    //               std::pmr containers do.
+    struct DenseStorage
+    {
+        template <typename T>
+        using Cells = std::vector<T>;
+        template <typename T>
+        using Vector = std::vector<T>;
+        template <typename Key, typename Value>
+        using Map = std::map<Key, Value>;
+    };
+
+    struct CowStorage
+    {
+        template <typename T>
+        using Cells = CowChunkedVector<T>;
+        template <typename T>
+        using Vector = CopyOnWrite<std::vector<T>>;
+        template <typename Key, typename Value>
+        using Map = CopyOnWrite<std::map<Key, Value>>;
+    };
+
+    struct PmrStorage
+    {
+        template <typename T>
+        using Cells = std::pmr::vector<T>;
+        template <typename T>
+        using Vector = std::pmr::vector<T>;
+        template <typename Key, typename Value>
+        using Map = std::pmr::map<Key, Value>;
+    };
+
+    namespace detail
+    {
+        // Storage policies whose containers take a std::pmr::memory_resource.
+        template <typename Storage>
+        concept PmrStoragePolicy = std::is_same_v<typename Storage::template Vector<char>::allocator_type,
+                                                  std::pmr::polymorphic_allocator<char>>;
+
+        // Plain vector for data a graph keeps outside of the policy containers (bitmaps,
+        // edge values), allocating from the graph's resource under a pmr policy.
+        template <typename Storage, typename T>
+        using DenseVectorFor = std::conditional_t<PmrStoragePolicy<Storage>, std::pmr::vector<T>, std::vector<T>>;
+
+        // count value-initialized elements, allocated from the same place as like.
+        template <typename Container>
+        Container sizedLike(const Container &like, size_t count)
+        {
+            if constexpr (requires { like.get_allocator(); })
+                return Container(count, like.get_allocator());
+            else
+                return Container(count);
+        }
+    }
+}
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "GraphMatrix.hpp"
+
+namespace Appledore
+{
+    namespace detail
+    {
+        // Append-only bit vector with constant time rank, built once and then queried.
+        class RankedBits
+        {
+        public:
+            void push_back(bool bit)
+            {
+                if (bits % 64 == 0)
+                    words.push_back(0);
+                if (bit)
+                    words.back() |= uint64_t{1} << (bits % 64);
+                ++bits;
+            }
+
+            // Must be called after the last push_back and before rank().
+            void buildRanks()
+            {
+                ranks.assign(words.size() + 1, 0);
+                for (size_t w = 0; w < words.size(); ++w)
+                {
+                    ranks[w + 1] = ranks[w] + static_cast<uint64_t>(std::popcount(words[w]));
+                }
+                words.shrink_to_fit();
+            }
+
+            [[nodiscard]] bool operator[](size_t index) const
+            {
+                return (words[index / 64] >> (index % 64)) & 1;
+            }
+
+            // Number of set bits in [0, index].
+            [[nodiscard]] uint64_t rank(size_t index) const
+            {
+                uint64_t mask = index % 64 == 63 ? ~uint64_t{0} : (uint64_t{1} << (index % 64 + 1)) - 1;
+                return ranks[index / 64] + static_cast<uint64_t>(std::popcount(words[index / 64] & mask));
+            }
+
+            [[nodiscard]] size_t size() const { return bits; }
+
+            [[nodiscard]] size_t memoryUsage() const
+            {
+                return words.capacity() * sizeof(uint64_t) + ranks.capacity() * sizeof(uint64_t);
+            }
+
+        private:
+            std::vector<uint64_t> words;
+            std::vector<uint64_t> ranks;
+            size_t bits = 0;
+        };
+    }
+
+    // Read-only graph stored as a k²-tree (Brisaboa, Ladra, Navarro). The adjacency matrix,
+    // padded to K^h x K^h, is split into K² submatrices; one bit per submatrix records
+    // whether it holds any edge, and only non-empty submatrices are split further. The
+    // internal levels and the last level are kept as two bit vectors with rank support,
+    // so the children of a node are found by a rank instead of pointers.
+    //
+    // Large empty regions cost nothing, and clustered sparse graphs (web, social) take a
+    // few bits per edge. Rows and columns are symmetric in the tree: out-neighbors and
+    // in-neighbors are both answered by a top-down traversal that only visits non-empty
+    // submatrices along the row or column, so indegree needs no V step column walk.
+    // Only the structure is kept, edge values are not.
+    template <typename VertexType, unsigned K = 2>
+    class K2TreeGraph
+    {
+        static_assert(K >= 2, "K2TreeGraph needs K >= 2");
+        static constexpr size_t childCount = size_t{K} * K;
+
+    public:
+        // Builds the tree from any GraphMatrix; undirected edges are kept in both directions.
+        template <typename EdgeType, typename Direction, typename Storage>
+        explicit K2TreeGraph(const GraphMatrix<VertexType, EdgeType, Direction, Storage> &graph)
+        {
+            std::vector<VertexType> vertices;
+            std::vector<std::pair<size_t, size_t>> edges;
+            vertices.reserve(graph.getNumVertices());
+            for (size_t src = 0; src < graph.getNumVertices(); ++src)
+            {
+                vertices.push_back(graph.getVertexAt(src));
+                for (size_t dest = 0; dest < graph.getNumVertices(); ++dest)
+                {
+                    if (graph.hasEdgeAt(src, dest))
+                        edges.emplace_back(src, dest);
+                }
+            }
+            build(std::move(vertices), std::move(edges));
+        }
+
+        // Builds the tree from a vertex list and an edge stream of (srcIndex, destIndex)
+        // pairs into it, in any order. Duplicate pairs are merged.
+        K2TreeGraph(std::vector<VertexType> vertices, std::vector<std::pair<size_t, size_t>> edges)
+        {
+            build(std::move(vertices), std::move(edges));
+        }
+
+        [[nodiscard]] size_t getNumVertices() const { return indexToVertex.size(); }
+        [[nodiscard]] size_t getNumEdges() const { return numEdges; }
+        const std::vector<VertexType> &getVertices() const { return indexToVertex; }
+
+        [[nodiscard]] size_t getIndexOf(const VertexType &vertex) const
+        {
+            auto it = vertexToIndex.find(vertex);
+            if (it == vertexToIndex.end())
+            {
+                throw std::invalid_argument("Vertex does not exist in the graph");
+            }
+            return it->second;
+        }
+
+        const VertexType &getVertexAt(size_t index) const
+        {
+            if (index >= indexToVertex.size())
+            {
+                throw std::out_of_range("Vertex index out of range");
+            }
+            return indexToVertex[index];
+        }
+
+        [[nodiscard]] bool hasEdge(const VertexType &src, const VertexType &dest) const
+        {
+            return hasEdgeAt(getIndexOf(src), getIndexOf(dest));
+        }
+
+        [[nodiscard]] bool hasEdgeAt(size_t srcIndex, size_t destIndex) const
+        {
+            checkIndex(srcIndex);
+            checkIndex(destIndex);
+            if (numEdges == 0)
+                return false;
+
+            size_t size = side;
+            size_t row = srcIndex, col = destIndex;
+            uint64_t child = 0;
+            while (true)
+            {
+                size /= K;
+                child += K * (row / size) + col / size;
+                row %= size;
+                col %= size;
+                if (child >= tree.size())
+                    return leaves[child - tree.size()];
+                if (!tree[child])
+                    return false;
+                child = tree.rank(child) * childCount;
+            }
+        }
+
+        [[nodiscard]] std::vector<size_t> getOutNeighborsAt(size_t index) const
+        {
+            checkIndex(index);
+            std::vector<size_t> neighbors;
+            forEachOut(index, [&neighbors](size_t dest)
+                       { neighbors.push_back(dest); });
+            return neighbors;
+        }
+
+        [[nodiscard]] std::vector<size_t> getInNeighborsAt(size_t index) const
+        {
+            checkIndex(index);
+            std::vector<size_t> neighbors;
+            forEachIn(index, [&neighbors](size_t src)
+                      { neighbors.push_back(src); });
+            return neighbors;
+        }
+
+        // Neighbors in index order.
+        [[nodiscard]] std::vector<VertexType> getOutNeighbors(const VertexType &vertex) const
+        {
+            std::vector<VertexType> neighbors;
+            forEachOut(getIndexOf(vertex), [&](size_t dest)
+                       { neighbors.push_back(indexToVertex[dest]); });
+            return neighbors;
+        }
+
+        [[nodiscard]] std::vector<VertexType> getInNeighbors(const VertexType &vertex) const
+        {
+            std::vector<VertexType> neighbors;
+            forEachIn(getIndexOf(vertex), [&](size_t src)
+                      { neighbors.push_back(indexToVertex[src]); });
+            return neighbors;
+        }
+
+        [[nodiscard]] size_t outdegree(const VertexType &vertex) const
+        {
+            size_t degree = 0;
+            forEachOut(getIndexOf(vertex), [&degree](size_t)
+                       { ++degree; });
+            return degree;
+        }
+
+        [[nodiscard]] size_t indegree(const VertexType &vertex) const
+        {
+            size_t degree = 0;
+            forEachIn(getIndexOf(vertex), [&degree](size_t)
+                      { ++degree; });
+            return degree;
+        }
+
+        // Bytes held by the tree bit vectors, without the vertex maps.
+        [[nodiscard]] size_t memoryUsage() const
+        {
+            return tree.memoryUsage() + leaves.memoryUsage();
+        }
+
+    private:
+        std::map<VertexType, size_t> vertexToIndex;
+        std::vector<VertexType> indexToVertex;
+        detail::RankedBits tree;
+        detail::RankedBits leaves;
+        size_t side = K;
+        size_t numEdges = 0;
+
+        void checkIndex(size_t index) const
+        {
+            if (index >= indexToVertex.size())
+            {
+                throw std::out_of_range("Vertex index out of range");
+            }
+        }
+
+        void build(std::vector<VertexType> vertices, std::vector<std::pair<size_t, size_t>> edges)
+        {
+            for (size_t i = 0; i < vertices.size(); ++i)
+            {
+                if (!vertexToIndex.emplace(vertices[i], i).second)
+                {
+                    throw std::invalid_argument("Duplicate vertex in K2TreeGraph");
+                }
+            }
+            indexToVertex = std::move(vertices);
+
+            for (const auto &[src, dest] : edges)
+            {
+                checkIndex(src);
+                checkIndex(dest);
+            }
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+            numEdges = edges.size();
+
+            while (side < indexToVertex.size())
+                side *= K;
+
+            // Level by level, breadth first: each node is a range of edges, split into its
+            // K² children with a counting sort. Children that receive edges become the
+            // nodes of the next level, in the order their bits were emitted.
+            std::vector<std::pair<size_t, size_t>> nodes;
+            if (numEdges)
+                nodes.emplace_back(0, numEdges);
+            std::vector<std::pair<size_t, size_t>> scratch(numEdges);
+
+            for (size_t size = side / K; !nodes.empty(); size /= K)
+            {
+                const bool leafLevel = size == 1;
+                detail::RankedBits &bits = leafLevel ? leaves : tree;
+                std::vector<std::pair<size_t, size_t>> nextNodes;
+
+                for (const auto &[begin, end] : nodes)
+                {
+                    auto childOf = [size](const std::pair<size_t, size_t> &edge)
+                    {
+                        return K * ((edge.first / size) % K) + (edge.second / size) % K;
+                    };
+
+                    size_t offsets[childCount + 1] = {};
+                    for (size_t e = begin; e < end; ++e)
+                        ++offsets[childOf(edges[e]) + 1];
+                    for (size_t c = 0; c < childCount; ++c)
+                        offsets[c + 1] += offsets[c];
+
+                    size_t fill[childCount];
+                    std::copy(offsets, offsets + childCount, fill);
+                    for (size_t e = begin; e < end; ++e)
+                        scratch[begin + fill[childOf(edges[e])]++] = edges[e];
+
+                    for (size_t c = 0; c < childCount; ++c)
+                    {
+                        bool nonEmpty = offsets[c + 1] > offsets[c];
+                        bits.push_back(nonEmpty);
+                        if (nonEmpty && !leafLevel)
+                            nextNodes.emplace_back(begin + offsets[c], begin + offsets[c + 1]);
+                    }
+                }
+                edges.swap(scratch);
+                nodes.swap(nextNodes);
+            }
+            tree.buildRanks();
+            leaves.buildRanks();
+        }
+
+        template <typename Func>
+        void forEachOut(size_t row, Func &&func) const
+        {
+            if (numEdges)
+                outFrom(side, row, 0, 0, func);
+        }
+
+        template <typename Func>
+        void forEachIn(size_t col, Func &&func) const
+        {
+            if (numEdges)
+                inFrom(side, col, 0, 0, func);
+        }
+
+        // Visits the children of the node whose children start at firstChild, in the row of
+        // a size x size submatrix that starts at column colOffset.
+        template <typename Func>
+        void outFrom(size_t size, size_t row, size_t colOffset, uint64_t firstChild, Func &func) const
+        {
+            size_t childSize = size / K;
+            uint64_t child = firstChild + K * (row / childSize);
+            for (size_t j = 0; j < K; ++j, ++child)
+            {
+                size_t col = colOffset + childSize * j;
+                if (child >= tree.size())
+                {
+                    if (leaves[child - tree.size()] && col < indexToVertex.size())
+                        func(col);
+                }
+                else if (tree[child])
+                {
+                    outFrom(childSize, row % childSize, col, tree.rank(child) * childCount, func);
+                }
+            }
+        }
+
+        template <typename Func>
+        void inFrom(size_t size, size_t col, size_t rowOffset, uint64_t firstChild, Func &func) const
+        {
+            size_t childSize = size / K;
+            uint64_t child = firstChild + col / childSize;
+            for (size_t i = 0; i < K; ++i, child += K)
+            {
+                size_t row = rowOffset + childSize * i;
+                if (child >= tree.size())
+                {
+                    if (leaves[child - tree.size()] && row < indexToVertex.size())
+                        func(row);
+                }
+                else if (tree[child])
+                {
+                    inFrom(childSize, col % childSize, row, tree.rank(child) * childCount, func);
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error "MappedFile.hpp requires a POSIX platform (mmap)."
+#endif
+
+namespace Appledore
+{
+    // Access pattern hints forwarded to madvise.
+    enum class MappedAccess
+    {
+        Normal,
+        Sequential,
+        Random,
+        WillNeed
+    };
+
+    enum class MappedMode
+    {
+        ReadOnly,
+        ReadWrite
+    };
+
+    // Memory mapping of a whole file. The mapping is page aligned, so any section at an
+    // aligned file offset can be used in place. ReadOnly mappings are private; ReadWrite
+    // mappings are shared, so writes go to the file through the page cache and can be
+    // resized and flushed.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+
+        explicit MappedFile(const std::string &path, MappedMode mode = MappedMode::ReadOnly)
+            : writable(mode == MappedMode::ReadWrite)
+        {
+            fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::runtime_error("Cannot open file: " + path);
+            }
+
+            struct stat info;
+            if (::fstat(fd, &info) != 0)
+            {
+                close();
+                throw std::runtime_error("Cannot stat file: " + path);
+            }
+
+            try
+            {
+                map(static_cast<size_t>(info.st_size));
+            }
+            catch (...)
+            {
+                close();
+                throw std::runtime_error("Cannot map file: " + path);
+            }
+        }
+
+        // Creates path, or truncates it, with size zero bytes and maps it read-write.
+        static MappedFile create(const std::string &path, size_t size)
+        {
+            MappedFile file;
+            file.writable = true;
+            file.fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (file.fd < 0)
+            {
+                throw std::runtime_error("Cannot create file: " + path);
+            }
+            file.resize(size);
+            return file;
+        }
+
+        // Read-write mapping of a new file in directory that is unlinked right away, so its
+        // blocks are released when the mapping is closed.
+        static MappedFile temporary(const std::string &directory, size_t size)
+        {
+            std::string pattern = directory + "/appledore-XXXXXX";
+            std::vector<char> name(pattern.begin(), pattern.end());
+            name.push_back('\0');
+
+            MappedFile file;
+            file.writable = true;
+            file.fd = ::mkstemp(name.data());
+            if (file.fd < 0)
+            {
+                throw std::runtime_error("Cannot create temporary file in: " + directory);
+            }
+            ::unlink(name.data());
+            file.resize(size);
+            return file;
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept
+            : mapping(std::exchange(other.mapping, nullptr)), length(std::exchange(other.length, 0)),
+              fd(std::exchange(other.fd, -1)), writable(other.writable) {}
+
+        MappedFile &operator=(MappedFile &&other) noexcept
+        {
+            if (this != &other)
+            {
+                unmap();
+                close();
+                mapping = std::exchange(other.mapping, nullptr);
+                length = std::exchange(other.length, 0);
+                fd = std::exchange(other.fd, -1);
+                writable = other.writable;
+            }
+            return *this;
+        }
+
+        ~MappedFile()
+        {
+            unmap();
+            close();
+        }
+
+        [[nodiscard]] const std::byte *data() const { return mapping; }
+        // Only ReadWrite mappings may be written through.
+        [[nodiscard]] std::byte *data() { return mapping; }
+        [[nodiscard]] size_t size() const { return length; }
+        [[nodiscard]] bool isWritable() const { return writable; }
+
+        // Grows or truncates the file and remaps it. Grown bytes read as zero. Pointers into
+        // the old mapping are invalidated.
+        void resize(size_t newSize)
+        {
+            if (!writable)
+            {
+                throw std::logic_error("Cannot resize a read-only mapping");
+            }
+            unmap();
+            if (::ftruncate(fd, static_cast<off_t>(newSize)) != 0)
+            {
+                throw std::runtime_error("Cannot resize mapped file");
+            }
+            map(newSize);
+        }
+
+        // Writes dirty pages back to the file. With wait == false the write back is only
+        // scheduled.
+        void flush(bool wait = true)
+        {
+            if (mapping && writable && ::msync(mapping, length, wait ? MS_SYNC : MS_ASYNC) != 0)
+            {
+                throw std::runtime_error("Cannot flush mapped file");
+            }
+        }
+
+        void advise(MappedAccess access, size_t offset = 0, size_t count = 0) const
+        {
+            if (!mapping)
+                return;
+            adviseRange(mapping, length, access, offset, count);
+        }
+
+    protected:
+        std::byte *mapping = nullptr;
+        size_t length = 0;
+        int fd = -1;
+        bool writable = false;
+
+        void map(size_t size)
+        {
+            length = size;
+            if (length == 0)
+                return;
+
+            int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+            void *address = ::mmap(nullptr, length, protection, writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED)
+            {
+                length = 0;
+                throw std::runtime_error("Cannot map file");
+            }
+            mapping = static_cast<std::byte *>(address);
+
+            // a read-only mapping does not need the descriptor any more.
+            if (!writable)
+                close();
+        }
+
+        void unmap()
+        {
+            if (mapping)
+            {
+                ::munmap(mapping, length);
+                mapping = nullptr;
+            }
+            length = 0;
+        }
+
+        void close()
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+
+        static void adviseRange(std::byte *base, size_t total, MappedAccess access, size_t offset, size_t count)
+        {
+            if (offset >= total)
+                return;
+            if (count == 0 || offset + count > total)
+                count = total - offset;
+
+            // madvise wants a page aligned start address.
+            size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            size_t alignedOffset = offset - offset % page;
+            count += offset - alignedOffset;
+
+            int advice = MADV_NORMAL;
+            switch (access)
+            {
+            case MappedAccess::Sequential:
+                advice = MADV_SEQUENTIAL;
+                break;
+            case MappedAccess::Random:
+                advice = MADV_RANDOM;
+                break;
+            case MappedAccess::WillNeed:
+                advice = MADV_WILLNEED;
+                break;
+            case MappedAccess::Normal:
+                break;
+            }
+            ::madvise(base + alignedOffset, count, advice);
+        }
+    };
+}
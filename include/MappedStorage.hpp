@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "GraphMemory.hpp"
+#include "MappedFile.hpp"
+
+namespace Appledore
+{
+    // Vector of trivially copyable cells kept in a file-backed shared mapping instead of on
+    // the heap. The kernel pages cells in and out through the page cache, so the vector
+    // can be larger than physical memory; only recently touched pages stay resident.
+    //
+    // The backing file is an unlinked temporary file in MappedStorage::directory(). New
+    // cells are the zero bytes of a freshly extended file, which is an empty MatrixCell,
+    // and are never touched until written, so a sparse matrix only uses disk for pages
+    // that hold edges.
+    template <typename T>
+    class MappedCells
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "MappedCells needs trivially copyable cells, use an EdgeType without heap members.");
+
+    public:
+        MappedCells() = default;
+        explicit MappedCells(size_t count) { resize(count); }
+
+        MappedCells(const MappedCells &other)
+        {
+            resize(other.count);
+            if (count)
+                std::memcpy(file.data(), other.file.data(), count * sizeof(T));
+        }
+
+        MappedCells(MappedCells &&other) noexcept
+            : file(std::move(other.file)), count(std::exchange(other.count, 0)) {}
+
+        MappedCells &operator=(MappedCells other) noexcept
+        {
+            std::swap(file, other.file);
+            std::swap(count, other.count);
+            return *this;
+        }
+
+        [[nodiscard]] size_t size() const { return count; }
+
+        const T &operator[](size_t index) const
+        {
+            return reinterpret_cast<const T *>(file.data())[index];
+        }
+
+        T &operator[](size_t index)
+        {
+            return reinterpret_cast<T *>(file.data())[index];
+        }
+
+        // Cells past the new size are dropped with the truncated file, so growing again
+        // yields empty cells.
+        void resize(size_t newCount);
+
+        // Writes dirty pages back to the backing file.
+        void flush(bool wait = true)
+        {
+            file.flush(wait);
+        }
+
+        // Bytes of the mapping. They live in the page cache, not on the heap.
+        [[nodiscard]] MemoryBlock memoryUsage() const
+        {
+            return {count * sizeof(T), count * sizeof(T)};
+        }
+
+        // Hints that [first, first + cells) is about to be read front to back.
+        void adviseSequential(size_t first, size_t cells) const
+        {
+            file.advise(MappedAccess::Sequential, first * sizeof(T), cells * sizeof(T));
+        }
+
+    private:
+        MappedFile file;
+        size_t count = 0;
+    };
+
+    // Storage policy for GraphMatrix with the adjacency matrix in MappedCells. The vertex
+    // maps stay on the heap, they are O(V) next to the O(V^2) matrix. Row scans (outdegree,
+    // getNeighbors, the DFS based algorithms) read the matrix row by row and advise the
+    // kernel to read ahead; column scans such as indegree touch one page per row.
+    struct MappedStorage
+    {
+        template <typename T>
+        using Cells = MappedCells<T>;
+        template <typename T>
+        using Vector = std::vector<T>;
+        template <typename Key, typename Value>
+        using Map = std::map<Key, Value>;
+
+        // Directory for the backing files, $TMPDIR or /tmp unless changed. Point it at a
+        // disk with room for the matrix before creating graphs.
+        static std::string &directory()
+        {
+            static std::string path = []
+            {
+                const char *tmp = std::getenv("TMPDIR");
+                return std::string(tmp && *tmp ? tmp : "/tmp");
+            }();
+            return path;
+        }
+    };
+
+    template <typename T>
+    void MappedCells<T>::resize(size_t newCount)
+    {
+        if (!file.isWritable())
+        {
+            file = MappedFile::temporary(MappedStorage::directory(), newCount * sizeof(T));
+        }
+        else
+        {
+            file.resize(newCount * sizeof(T));
+        }
+        count = newCount;
+    }
+}
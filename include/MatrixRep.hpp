@@ -4,49 +4,71 @@
 #include <iostream>
 #include <stdexcept>
 #include <optional>
+#include <ranges>
 #include <map>
 #include <stack>
 #include <algorithm>
 #include <set>
 #include <random>
 #include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <sstream>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "GraphExceptions.hpp"
+#include "GraphMemory.hpp"
+#include "GraphStorage.hpp"
+#include "GraphStats.hpp"
+#include "SymbolTable.hpp"
 namespace Appledore
 {
     struct DirectedG{};
     struct UndirectedG{};
     struct UnweightedG{};
 
-    std::string __generate_vertex_name()
-    {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        const std::string charset = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
-        const size_t name_length = 10;
-        std::uniform_int_distribution<> dist(0, charset.size() - 1);
-        std::stringstream ss;
-        for (size_t i = 0; i < name_length; ++i)
-        {
-            ss << charset[dist(gen)];
-        }
-        auto now = std::chrono::system_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-        ss << "_" << duration;
-        return ss.str();
-    }
+    // Identity of GraphVertex/GraphEdge is a process-wide id handed out by a relaxed atomic
+    // counter, so objects can be constructed concurrently. Names given to the constructor are
+    // interned in a SymbolTable and each object only stores the symbol id and the table,
+    // which must outlive it. The table defaults to SymbolTable::global(), which lives as long
+    // as the process; pass a graph's symbols() to release the names with the graph.
+    // Default-constructed objects store no name: name() formats one from the id ("v17",
+    // "e4"), so copies of an object always agree on it and reading it never writes.
     class GraphVertex
     {
     public:
         size_t __id_;
-        static size_t nextId;
-        std::string __v___name;
+        inline static std::atomic<size_t> nextId{1};
+        SymbolId __v___symbol = noSymbol;
+        const SymbolTable *__v___table = nullptr;
+
+        GraphVertex() : __id_(nextId.fetch_add(1, std::memory_order_relaxed)) {}
+        GraphVertex(std::string_view vertexName, SymbolTable &table = SymbolTable::global())
+            : __id_(nextId.fetch_add(1, std::memory_order_relaxed)),
+              __v___symbol{table.intern(vertexName)}, __v___table{&table} {};
 
-        GraphVertex()
+        std::string name() const
         {
-            __id_ = nextId++;
-            __v___name = __generate_vertex_name();
+            if (__v___symbol == noSymbol)
+                return "v" + std::to_string(__id_);
+            return std::string(__v___table->name(__v___symbol));
+        }
+        // noSymbol for default-constructed vertices.
+        SymbolId symbol() const
+        {
+            return __v___symbol;
+        }
+        // Table of symbol(), nullptr for default-constructed objects.
+        const SymbolTable *symbolTable() const
+        {
+            return __v___table;
         }
-        GraphVertex(std::string vertexName) : __v___name{vertexName} {};
 
         bool operator<(const GraphVertex &other) const
         {
@@ -57,19 +79,34 @@ namespace Appledore
             return __id_ == other.__id_;
         }
     };
-    size_t Appledore::GraphVertex::nextId = 1;
     class GraphEdge
     {
     public:
         size_t __id_;
-        static size_t nextId;
-        std::string __e___name;
-        GraphEdge()
+        inline static std::atomic<size_t> nextId{1};
+        SymbolId __e___symbol = noSymbol;
+        const SymbolTable *__e___table = nullptr;
+        GraphEdge() : __id_(nextId.fetch_add(1, std::memory_order_relaxed)) {}
+        GraphEdge(std::string_view edge_name, SymbolTable &table = SymbolTable::global())
+            : __id_(nextId.fetch_add(1, std::memory_order_relaxed)),
+              __e___symbol{table.intern(edge_name)}, __e___table{&table} {};
+
+        std::string name() const
+        {
+            if (__e___symbol == noSymbol)
+                return "e" + std::to_string(__id_);
+            return std::string(__e___table->name(__e___symbol));
+        }
+        // noSymbol for default-constructed edges.
+        SymbolId symbol() const
+        {
+            return __e___symbol;
+        }
+        // Table of symbol(), nullptr for default-constructed objects.
+        const SymbolTable *symbolTable() const
         {
-            __id_ = nextId++;
-            __e___name = __generate_vertex_name();
+            return __e___table;
         }
-        GraphEdge(std::string edge_name): __e___name{edge_name}{};
 
         bool operator<(const GraphEdge &other) const
         {
@@ -84,16 +121,583 @@ namespace Appledore
             return __id_ == other.__id_;
         }
     };
-    size_t Appledore::GraphEdge::nextId = 1;
-    template<typename VertexType, typename EdgeType>
+    // Reference to a vertex that bypasses the vertex map, from handleOf(). It names a slot
+    // that keeps pointing at the vertex while other vertices are removed and indices move,
+    // and the slot's generation when the handle was taken. Removing the vertex bumps the
+    // generation, so handles to it become detectably stale even once the slot is reused.
+    // Handles stay valid in copies of the graph.
+    struct VertexHandle
+    {
+        uint32_t slot = std::numeric_limits<uint32_t>::max();
+        uint32_t generation = 0;
+
+        bool operator==(const VertexHandle &) const = default;
+    };
+
+    namespace detail
+    {
+        // Index of the vertex in a live slot; in a free slot, the next free slot.
+        struct VertexSlot
+        {
+            uint32_t index;
+            uint32_t generation;
+        };
+
+        template <typename VertexType>
+        concept NamedVertex = std::derived_from<VertexType, GraphVertex>;
+
+        // Name lookup of graphs whose vertices derive from GraphVertex: the graph's own
+        // SymbolTable, shared by copies of the graph, and the handle of the vertex bound to
+        // each of its symbols. Removed vertices leave a stale handle behind.
+        template <typename Storage>
+        struct VertexNameIndex
+        {
+            std::shared_ptr<SymbolTable> symbols = std::make_shared<SymbolTable>();
+            typename Storage::template Vector<VertexHandle> handles;
+
+            VertexNameIndex() = default;
+            explicit VertexNameIndex(std::pmr::memory_resource *resource) : handles(resource) {}
+
+            // Names from other tables are interned in this one, default names as formatted.
+            // Takes the base, derived vertex types may declare members of the same names.
+            void bind(const GraphVertex &vertex, VertexHandle handle)
+            {
+                SymbolId id;
+                if (vertex.symbolTable() == symbols.get())
+                    id = vertex.symbol();
+                else if (vertex.symbolTable())
+                    id = symbols->intern(vertex.symbolTable()->name(vertex.symbol()));
+                else
+                    id = symbols->intern(vertex.name());
+                while (handles.size() <= id)
+                    handles.push_back(VertexHandle{});
+                handles[id] = handle;
+            }
+
+            VertexHandle find(std::string_view name) const
+            {
+                std::optional<SymbolId> id = symbols->find(name);
+                if (!id || *id >= handles.size())
+                    return {};
+                return handles[*id];
+            }
+        };
+
+        struct NoVertexNameIndex
+        {
+            NoVertexNameIndex() = default;
+            explicit NoVertexNameIndex(std::pmr::memory_resource *) {}
+        };
+    }
+
+    // Index level query surface shared by GraphMatrix, MixedGraphMatrix, StaticGraphMatrix
+    // and GraphFileView, for algorithms written once against any of them. Vertices are the
+    // indices [0, getNumVertices()), degrees follow the semantics of the graph's own
+    // outdegree/indegree and getNeighborsAt lists out-neighbor indices in increasing order.
+    template <typename Graph>
+    concept AdjacencyMatrixGraph = requires(const Graph &graph, size_t index) {
+        { graph.getNumVertices() } -> std::convertible_to<size_t>;
+        { graph.hasEdgeAt(index, index) } -> std::convertible_to<bool>;
+        { graph.outdegreeAt(index) } -> std::convertible_to<size_t>;
+        { graph.indegreeAt(index) } -> std::convertible_to<size_t>;
+        { graph.getNeighborsAt(index) } -> std::ranges::range;
+        requires std::convertible_to<std::ranges::range_value_t<decltype(graph.getNeighborsAt(index))>, size_t>;
+    };
+
+    // CRTP base of GraphMatrix and MixedGraphMatrix. It owns the vertex set and its index
+    // mapping, and implements vertex insertion and removal, index level access, row and
+    // column scans and neighbor iteration once for both classes. The derived class owns
+    // the edge cells and provides
+    //
+    //   bool cellAt(size_t src, size_t dest) const          an edge is stored at (src, dest)
+    //   void growCells(size_t oldNumVertices)               make room for appended vertices
+    //   void selectCells(const std::vector<size_t> &order)  keep vertex order[i] as index i
+    //   void cellMemory(MemoryUsage &usage) const           fill adjacency and edgeData
+    //   void shrinkCells()                                  release slack of the edge cells
+    //
+    // It may also replace the generic kernels below with faster ones for its layout, by
+    // declaring a member of the same name: forEachInRow, rowCount, columnCount and
+    // swapRemoveCells. Hooks are called through derived(), so they can stay private
+    // when the base is a friend.
+    //
+    // With an Instrumented<...> storage policy the base also keeps the statistics that the
+    // derived class records through timeOp and countStat, see GraphStats.hpp.
+    template <typename Derived, typename VertexType, typename EdgeType, typename Storage = DenseStorage>
     class MatrixRepresentation
     {
-        // common methods.
+    public:
+        template <typename... Vertices>
+        void addVertex(Vertices &&...vertices)
+        {
+            auto timer = timeOp(GraphOp::AddVertex);
+            size_t oldNumVertices = numVertices;
+            (appendVertex(std::forward<Vertices>(vertices)), ...);
+            growTo(oldNumVertices);
+        }
+
+        // Bulk insertion: all new vertices are appended first and the cells are laid out once.
+        template <typename Range>
+        void addVertices(const Range &vertices)
+        {
+            auto timer = timeOp(GraphOp::AddVertex);
+            size_t oldNumVertices = numVertices;
+            for (const auto &vertex : vertices)
+            {
+                appendVertex(vertex);
+            }
+            growTo(oldNumVertices);
+        }
+
+        void addVertices(std::initializer_list<VertexType> vertices)
+        {
+            addVertices<std::initializer_list<VertexType>>(vertices);
+        }
+
+        // The last vertex takes the index of the removed one.
+        void removeVertex(const VertexType &vertex)
+        {
+            auto timer = timeOp(GraphOp::RemoveVertex);
+            if (!vertexToIndex.count(vertex))
+            {
+                throw std::invalid_argument("Vertex does not exist in the graph.");
+            }
+            removeVertexAt(vertexToIndex.at(vertex));
+        }
+
+        // Handles of the other vertices stay valid.
+        void removeVertex(VertexHandle vertex)
+        {
+            auto timer = timeOp(GraphOp::RemoveVertex);
+            removeVertexAt(getIndexOf(vertex));
+        }
+
+        // Remove several vertices at once. The surviving index mapping is computed once and
+        // the cells are compacted in a single pass, so deleting k vertices costs one O(V^2)
+        // pass instead of k. Surviving vertices keep their relative order.
+        template <typename Range>
+        void removeVertices(const Range &vertices)
+        {
+            auto timer = timeOp(GraphOp::RemoveVertex);
+            std::vector<bool> removed(numVertices, false);
+            size_t removedCount = 0;
+
+            for (const auto &vertex : vertices)
+            {
+                auto it = std::as_const(vertexToIndex).find(vertex);
+                if (it == std::as_const(vertexToIndex).end())
+                {
+                    throw std::invalid_argument("Vertex does not exist in the graph.");
+                }
+                if (!removed[it->second])
+                {
+                    removed[it->second] = true;
+                    ++removedCount;
+                }
+            }
+
+            if (removedCount == 0)
+                return;
+
+            size_t newNumVertices = numVertices - removedCount;
+            std::vector<size_t> newIndex(numVertices);
+            std::vector<size_t> kept;
+            kept.reserve(newNumVertices);
+            for (size_t i = 0; i < numVertices; ++i)
+            {
+                newIndex[i] = removed[i] ? newNumVertices : kept.size();
+                if (!removed[i])
+                    kept.push_back(i);
+            }
+            derived().selectCells(kept);
+
+            for (size_t i = 0; i < numVertices; ++i)
+            {
+                if (removed[i])
+                {
+                    releaseSlot(indexToSlot[i]);
+                }
+                else if (newIndex[i] != i)
+                {
+                    indexToVertex[newIndex[i]] = std::move(indexToVertex[i]);
+                    uint32_t slot = indexToSlot[i];
+                    indexToSlot[newIndex[i]] = slot;
+                    slots[slot].index = static_cast<uint32_t>(newIndex[i]);
+                }
+            }
+            indexToVertex.erase(indexToVertex.begin() + newNumVertices, indexToVertex.end());
+            indexToSlot.erase(indexToSlot.begin() + newNumVertices, indexToSlot.end());
+
+            for (auto it = vertexToIndex.begin(); it != vertexToIndex.end();)
+            {
+                if (removed[it->second])
+                {
+                    it = vertexToIndex.erase(it);
+                }
+                else
+                {
+                    it->second = newIndex[it->second];
+                    ++it;
+                }
+            }
+            numVertices = newNumVertices;
+        }
+
+        void removeVertices(std::initializer_list<VertexType> vertices)
+        {
+            removeVertices<std::initializer_list<VertexType>>(vertices);
+        }
+
+        // A std::vector, or a std::pmr::vector for PmrStorage.
+        decltype(auto) getVertices() const
+        {
+            if constexpr (detail::PmrStoragePolicy<Storage>)
+                return static_cast<const std::pmr::vector<VertexType> &>(indexToVertex);
+            else
+                return static_cast<const std::vector<VertexType> &>(indexToVertex);
+        }
+
+        // Index level access. Indices are dense in [0, getNumVertices()) and follow the
+        // order of getVertices(); they change when vertices are removed.
+        [[nodiscard]] size_t getNumVertices() const
+        {
+            return numVertices;
+        }
+
+        [[nodiscard]] size_t getIndexOf(const VertexType &vertex) const
+        {
+            auto it = std::as_const(vertexToIndex).find(vertex);
+            if (it == std::as_const(vertexToIndex).end())
+            {
+                throw std::invalid_argument("Vertex does not exist in the graph");
+            }
+            return it->second;
+        }
+
+        GraphResult<size_t> tryGetIndexOf(const VertexType &vertex) const
+        {
+            const size_t *index = findIndex(vertex);
+            if (!index)
+                return GraphError::VertexNotFound;
+            return *index;
+        }
+
+        // Handles resolve to an index with two array reads instead of a map lookup; every
+        // query and mutation of the graphs has an overload taking them.
+        [[nodiscard]] VertexHandle handleOf(const VertexType &vertex) const
+        {
+            return handleAt(getIndexOf(vertex));
+        }
+
+        [[nodiscard]] VertexHandle handleAt(size_t index) const
+        {
+            checkIndex(index);
+            uint32_t slot = indexToSlot[index];
+            return {slot, slots[slot].generation};
+        }
+
+        // False once the vertex has been removed.
+        [[nodiscard]] bool isValid(VertexHandle handle) const
+        {
+            return handle.slot < slots.size() && slots[handle.slot].generation == handle.generation;
+        }
+
+        [[nodiscard]] size_t getIndexOf(VertexHandle handle) const
+        {
+            if (!isValid(handle))
+            {
+                throw std::invalid_argument("Vertex handle is stale");
+            }
+            return slots[handle.slot].index;
+        }
+
+        const VertexType &getVertex(VertexHandle handle) const
+        {
+            return indexToVertex[getIndexOf(handle)];
+        }
+
+        // Vertex named name, nullptr if there is none. One hash lookup in symbols() and no
+        // vertex map lookup. Names are expected to be unique: of vertices sharing a name,
+        // the one added last is found.
+        const VertexType *findByName(std::string_view name) const
+            requires detail::NamedVertex<VertexType>
+        {
+            std::optional<size_t> index = findIndex(vertexNames.find(name));
+            return index ? &indexToVertex[*index] : nullptr;
+        }
+
+        // Symbol table of the graph, shared by its copies. Vertices and edges constructed
+        // with it (GraphVertex(name, graph.symbols())) keep their names here instead of in
+        // SymbolTable::global(), so the names are released with the last copy of the graph;
+        // such objects must not outlive it.
+        SymbolTable &symbols() const
+            requires detail::NamedVertex<VertexType>
+        {
+            return *vertexNames.symbols;
+        }
+
+        const VertexType &getVertexAt(size_t index) const
+        {
+            checkIndex(index);
+            return indexToVertex[index];
+        }
+
+        [[nodiscard]] bool hasEdgeAt(size_t srcIndex, size_t destIndex) const
+        {
+            checkIndex(srcIndex);
+            checkIndex(destIndex);
+            return derived().cellAt(srcIndex, destIndex);
+        }
+
+        // Index level degrees, the same counts as outdegree() and indegree() of the derived
+        // class.
+        [[nodiscard]] size_t outdegreeAt(size_t index) const
+        {
+            auto timer = timeOp(GraphOp::Degree);
+            checkIndex(index);
+            return derived().rowCount(index);
+        }
+
+        [[nodiscard]] size_t indegreeAt(size_t index) const
+        {
+            auto timer = timeOp(GraphOp::Degree);
+            checkIndex(index);
+            return derived().columnCount(index);
+        }
+
+        // Out-neighbor indices of a vertex, in increasing order.
+        [[nodiscard]] std::vector<size_t> getNeighborsAt(size_t index) const
+        {
+            auto timer = timeOp(GraphOp::Neighbors);
+            std::vector<size_t> neighbors;
+            forEachOutNeighborAt(index, [&](size_t destIndex)
+                                 { neighbors.push_back(destIndex); });
+            return neighbors;
+        }
+
+        // Calls func(destIndex) for every cell of row srcIndex that holds an edge, in index
+        // order: the out-neighbors of srcIndex.
+        template <typename Func>
+        void forEachOutNeighborAt(size_t srcIndex, Func &&func) const
+        {
+            checkIndex(srcIndex);
+            derived().forEachInRow(srcIndex, func);
+        }
+
+        // Bytes held by the graph, broken down by structure (see GraphMemory.hpp). Tree node
+        // and allocator overheads are estimates for libstdc++ and glibc malloc. Walks the
+        // vertices, and the cells as well when edge values own heap memory.
+        [[nodiscard]] MemoryUsage memoryUsage() const
+        {
+            MemoryUsage usage;
+            usage.object = {sizeof(Derived), sizeof(Derived)};
+            derived().cellMemory(usage);
+            usage.vertexToIndex = detail::containerMemory(vertexToIndex);
+            usage.indexToVertex = detail::containerMemory(indexToVertex);
+            MemoryBlock vertexHeap = detail::elementHeap<VertexType>(indexToVertex);
+            usage.vertexData = {2 * vertexHeap.used, 2 * vertexHeap.capacity};
+            usage.handles = detail::containerMemory(slots);
+            usage.handles += detail::containerMemory(indexToSlot);
+            if constexpr (detail::NamedVertex<VertexType>)
+                usage.handles += detail::containerMemory(vertexNames.handles);
+            return usage;
+        }
+
+        // Releases capacity left behind by vertex removals and edge churn. The vertex map is
+        // node based and frees its nodes on erase already.
+        void shrinkToFit()
+        {
+            detail::shrinkContainer(indexToVertex);
+            detail::shrinkContainer(indexToSlot);
+            derived().shrinkCells();
+        }
+
+        // Per-operation call counts and latency histograms plus algorithm counters, only
+        // for graphs with an Instrumented storage policy.
+        [[nodiscard]] GraphStats stats() const
+            requires detail::InstrumentedStorage<Storage>
+        {
+            return statsRecorder.snapshot();
+        }
+
+        void resetStats()
+            requires detail::InstrumentedStorage<Storage>
+        {
+            statsRecorder.reset();
+        }
+
+        // Resource the containers of a PmrStorage graph allocate from.
+        [[nodiscard]] std::pmr::memory_resource *memoryResource() const
+            requires detail::PmrStoragePolicy<Storage>
+        {
+            return indexToVertex.get_allocator().resource();
+        }
+
+    protected:
+        MatrixRepresentation() = default;
+        explicit MatrixRepresentation(std::pmr::memory_resource *resource)
+            requires detail::PmrStoragePolicy<Storage>
+            : vertexToIndex(resource), indexToVertex(resource), slots(resource), indexToSlot(resource),
+              vertexNames(resource)
+        {
+        }
+
+        typename Storage::template Map<VertexType, size_t> vertexToIndex;
+        typename Storage::template Vector<VertexType> indexToVertex;
+        // Handle slots, see VertexHandle. Free slots form a list through VertexSlot::index.
+        typename Storage::template Vector<detail::VertexSlot> slots;
+        typename Storage::template Vector<uint32_t> indexToSlot;
+        uint32_t freeSlot = noSlot;
+        [[no_unique_address]] std::conditional_t<detail::NamedVertex<VertexType>, detail::VertexNameIndex<Storage>,
+                                                  detail::NoVertexNameIndex> vertexNames;
+        size_t numVertices = 0;
+        [[no_unique_address]] detail::StatsRecorderFor<Storage> statsRecorder;
+
+        // Times the enclosing public call until the returned guard goes out of scope.
+        [[nodiscard]] auto timeOp(GraphOp op) const { return statsRecorder.time(op); }
+        void countStat(GraphCounter counter, uint64_t amount = 1) const { statsRecorder.add(counter, amount); }
+
+        Derived &derived() { return static_cast<Derived &>(*this); }
+        const Derived &derived() const { return static_cast<const Derived &>(*this); }
+
+        // Index of vertex, nullptr if it is not in the graph. One map lookup.
+        const size_t *findIndex(const VertexType &vertex) const
+        {
+            auto it = std::as_const(vertexToIndex).find(vertex);
+            return it == std::as_const(vertexToIndex).end() ? nullptr : &it->second;
+        }
+
+        // Index behind handle, std::nullopt if it is stale. No map lookup.
+        std::optional<size_t> findIndex(VertexHandle handle) const
+        {
+            if (!isValid(handle))
+                return std::nullopt;
+            return slots[handle.slot].index;
+        }
+
+        void checkIndex(size_t index) const
+        {
+            if (index >= numVertices)
+            {
+                throw std::out_of_range("Vertex index out of range");
+            }
+        }
+
+        // Default kernels, one derived().cellAt call per cell of the row or column; layouts
+        // with a faster scan (MixedGraphMatrix's bitmap words) override them.
+        template <typename Func>
+        void forEachInRow(size_t row, Func &&func) const
+        {
+            countStat(GraphCounter::RowsScanned);
+            for (size_t col = 0; col < numVertices; ++col)
+            {
+                if (derived().cellAt(row, col))
+                    func(col);
+            }
+        }
+
+        [[nodiscard]] size_t rowCount(size_t row) const
+        {
+            countStat(GraphCounter::RowsScanned);
+            size_t count = 0;
+            for (size_t col = 0; col < numVertices; ++col)
+            {
+                count += derived().cellAt(row, col);
+            }
+            return count;
+        }
+
+        [[nodiscard]] size_t columnCount(size_t col) const
+        {
+            countStat(GraphCounter::ColumnsScanned);
+            size_t count = 0;
+            for (size_t row = 0; row < numVertices; ++row)
+            {
+                count += derived().cellAt(row, col);
+            }
+            return count;
+        }
+
+        // Called before the bookkeeping of removeVertex, with the old vertex count.
+        void swapRemoveCells(size_t removedIndex, size_t lastIndex)
+        {
+            std::vector<size_t> order(lastIndex);
+            for (size_t i = 0; i < lastIndex; ++i)
+            {
+                order[i] = i == removedIndex ? lastIndex : i;
+            }
+            derived().selectCells(order);
+        }
+
+    private:
+        static constexpr uint32_t noSlot = std::numeric_limits<uint32_t>::max();
+
+        void appendVertex(const VertexType &vertex)
+        {
+            if (vertexToIndex.count(vertex))
+                return;
+            size_t newIndex = numVertices++;
+            vertexToIndex[vertex] = newIndex;
+            indexToVertex.push_back(vertex);
+
+            uint32_t slot = freeSlot;
+            if (slot != noSlot)
+            {
+                freeSlot = slots[slot].index;
+                slots[slot].index = static_cast<uint32_t>(newIndex);
+            }
+            else
+            {
+                slot = static_cast<uint32_t>(slots.size());
+                slots.push_back(detail::VertexSlot{static_cast<uint32_t>(newIndex), 0});
+            }
+            indexToSlot.push_back(slot);
+            if constexpr (detail::NamedVertex<VertexType>)
+                vertexNames.bind(vertex, VertexHandle{slot, slots[slot].generation});
+        }
+
+        // The last vertex takes the index of the removed one.
+        void removeVertexAt(size_t removedIndex)
+        {
+            size_t lastIndex = numVertices - 1;
+            derived().swapRemoveCells(removedIndex, lastIndex);
+
+            releaseSlot(indexToSlot[removedIndex]);
+            vertexToIndex.erase(indexToVertex[removedIndex]);
+            if (removedIndex != lastIndex)
+            {
+                // moved rather than copied, a copy of a pmr vertex would allocate from the
+                // default resource.
+                vertexToIndex[indexToVertex[lastIndex]] = removedIndex;
+                indexToVertex[removedIndex] = std::move(indexToVertex[lastIndex]);
+                uint32_t movedSlot = indexToSlot[lastIndex];
+                indexToSlot[removedIndex] = movedSlot;
+                slots[movedSlot].index = static_cast<uint32_t>(removedIndex);
+            }
+            indexToVertex.pop_back();
+            indexToSlot.pop_back();
+            --numVertices;
+        }
+
+        // Bumps the generation so that outstanding handles turn stale.
+        void releaseSlot(uint32_t slot)
+        {
+            ++slots[slot].generation;
+            slots[slot].index = freeSlot;
+            freeSlot = slot;
+        }
+
+        void growTo(size_t oldNumVertices)
+        {
+            if (oldNumVertices != numVertices)
+            {
+                derived().growCells(oldNumVertices);
+            }
+        }
     };
     template <typename EdgeType>
     struct EdgeInfo
     {
-        EdgeType value;
+        [[no_unique_address]] EdgeType value;
         bool isDirected;
 
         EdgeInfo() : value(), isDirected(false) {}
@@ -101,4 +705,32 @@ namespace Appledore
             : value(value), isDirected(isDirected) {}
     };
 
+    // Adjacency matrix cell of GraphMatrix: the edge value and whether the edge exists.
+    // The value takes no space for UnweightedG, so an unweighted cell is a single byte.
+    // An all zero cell is empty. Edge types that cannot be default constructed are kept
+    // in a std::optional instead, see MatrixCellFor.
+    template <typename EdgeType>
+    struct MatrixCell
+    {
+        [[no_unique_address]] EdgeType value{};
+        bool present = false;
+
+        MatrixCell() = default;
+        explicit MatrixCell(const EdgeType &value) : value(value), present(true) {}
+
+        MatrixCell &operator=(std::nullopt_t)
+        {
+            value = EdgeType{};
+            present = false;
+            return *this;
+        }
+
+        [[nodiscard]] bool has_value() const { return present; }
+        const EdgeType &operator*() const { return value; }
+    };
+
+    template <typename EdgeType>
+    using MatrixCellFor = std::conditional_t<std::is_default_constructible_v<EdgeType>,
+                                             MatrixCell<EdgeType>, std::optional<EdgeType>>;
+
 }
\ No newline at end of file
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <utility>
 #include <vector>
 #include <iostream>
 #include <stdexcept>
@@ -8,92 +13,571 @@
 #include "MatrixRep.hpp"
 namespace Appledore
 {
-    template <typename VertexType, typename EdgeType = bool>
-    class MixedGraphMatrix : public Appledore::MatrixRepresentation<VertexType, EdgeType>
+    namespace detail
     {
+        // Square bit matrix stored row by row, each row padded to whole 64-bit words so a
+        // row is scanned a word at a time. Words is std::vector<uint64_t> or its pmr
+        // counterpart; a resized or selected matrix keeps the allocator.
+        template <typename Words = std::vector<uint64_t>>
+        class BitMatrix
+        {
+        public:
+            BitMatrix() = default;
+            explicit BitMatrix(const typename Words::allocator_type &allocator) : words(allocator) {}
+
+            [[nodiscard]] bool test(size_t row, size_t col) const
+            {
+                return words[row * stride + col / 64] & bitOf(col);
+            }
+
+            void set(size_t row, size_t col)
+            {
+                words[row * stride + col / 64] |= bitOf(col);
+            }
+
+            void reset(size_t row, size_t col)
+            {
+                words[row * stride + col / 64] &= ~bitOf(col);
+            }
+
+            [[nodiscard]] const uint64_t *row(size_t row) const { return words.data() + row * stride; }
+            [[nodiscard]] size_t wordsPerRow() const { return stride; }
+
+            [[nodiscard]] size_t rowCount(size_t row) const
+            {
+                size_t count = 0;
+                for (size_t w = 0; w < stride; ++w)
+                {
+                    count += static_cast<size_t>(std::popcount(words[row * stride + w]));
+                }
+                return count;
+            }
+
+            // One word load and mask per row.
+            [[nodiscard]] size_t columnCount(size_t col) const
+            {
+                size_t count = 0;
+                const uint64_t mask = bitOf(col);
+                for (size_t r = 0, w = col / 64; r < size; ++r, w += stride)
+                {
+                    count += (words[w] & mask) != 0;
+                }
+                return count;
+            }
+
+            // Grows to newSize x newSize, every bit keeps its position.
+            void grow(size_t newSize)
+            {
+                size_t newStride = (newSize + 63) / 64;
+                if (newStride == stride)
+                {
+                    words.resize(newSize * stride, 0);
+                }
+                else
+                {
+                    Words newWords(newSize * newStride, 0, words.get_allocator());
+                    for (size_t r = 0; r < size; ++r)
+                    {
+                        std::copy_n(words.begin() + r * stride, stride, newWords.begin() + r * newStride);
+                    }
+                    words = std::move(newWords);
+                    stride = newStride;
+                }
+                size = newSize;
+            }
+
+            // Keeps the rows and columns listed in order: bit (i, j) of the result is bit
+            // (order[i], order[j]) of this matrix.
+            void select(const std::vector<size_t> &order)
+            {
+                BitMatrix result(words.get_allocator());
+                result.grow(order.size());
+                for (size_t i = 0; i < order.size(); ++i)
+                {
+                    for (size_t j = 0; j < order.size(); ++j)
+                    {
+                        if (test(order[i], order[j]))
+                            result.set(i, j);
+                    }
+                }
+                *this = std::move(result);
+            }
+
+            [[nodiscard]] MemoryBlock memoryUsage() const { return containerMemory(words); }
+            void shrinkToFit() { words.shrink_to_fit(); }
+
+        private:
+            Words words;
+            size_t size = 0;
+            size_t stride = 0;
+
+            static uint64_t bitOf(size_t col) { return uint64_t{1} << (col % 64); }
+        };
+
+        // Underlying undirected graph of a mixed graph as adjacency lists, one edge per vertex
+        // pair that has any edge, with the arcs usable across each pair. Built once in
+        // O(V^2 / 64 + E) and searched in O(V + E).
+        struct MixedSkeleton
+        {
+            static constexpr size_t none = std::numeric_limits<size_t>::max();
+
+            std::vector<std::pair<size_t, size_t>> pairs; // (a, b) with a < b
+            std::vector<uint8_t> arcs;                    // bit 1: a -> b usable, bit 2: b -> a
+            std::vector<bool> undirected;
+            std::vector<size_t> offsets; // edges at v: slotEdge[offsets[v] .. offsets[v + 1])
+            std::vector<size_t> slotEdge;
+
+            void addPair(size_t a, size_t b, uint8_t arcMask, bool isUndirected)
+            {
+                pairs.emplace_back(a, b);
+                arcs.push_back(arcMask);
+                undirected.push_back(isUndirected);
+            }
+
+            void buildAdjacency(size_t numVertices)
+            {
+                offsets.assign(numVertices + 1, 0);
+                for (const auto &[a, b] : pairs)
+                {
+                    ++offsets[a + 1];
+                    ++offsets[b + 1];
+                }
+                for (size_t v = 0; v < numVertices; ++v)
+                {
+                    offsets[v + 1] += offsets[v];
+                }
+                slotEdge.resize(2 * pairs.size());
+                std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+                for (size_t edge = 0; edge < pairs.size(); ++edge)
+                {
+                    slotEdge[fill[pairs[edge].first]++] = edge;
+                    slotEdge[fill[pairs[edge].second]++] = edge;
+                }
+            }
+
+            [[nodiscard]] size_t other(size_t edge, size_t v) const
+            {
+                return pairs[edge].first == v ? pairs[edge].second : pairs[edge].first;
+            }
+
+            [[nodiscard]] bool hasArc(size_t edge, size_t from) const
+            {
+                return arcs[edge] & (pairs[edge].first == from ? 1 : 2);
+            }
+
+            void setArc(size_t edge, size_t from)
+            {
+                arcs[edge] = pairs[edge].first == from ? 1 : 2;
+            }
+
+            // Breadth first over the arcs from root, backwards when reverse is set. Returns
+            // whether target was reached, or with target == none whether every vertex was.
+            [[nodiscard]] bool search(size_t root, bool reverse, size_t target = none) const
+            {
+                size_t numVertices = offsets.size() - 1;
+                std::vector<bool> visited(numVertices, false);
+                std::vector<size_t> queue{root};
+                visited[root] = true;
+                for (size_t head = 0; head < queue.size(); ++head)
+                {
+                    size_t v = queue[head];
+                    if (v == target)
+                        return true;
+                    for (size_t slot = offsets[v]; slot < offsets[v + 1]; ++slot)
+                    {
+                        size_t edge = slotEdge[slot];
+                        size_t w = other(edge, v);
+                        if (!visited[w] && hasArc(edge, reverse ? w : v))
+                        {
+                            visited[w] = true;
+                            queue.push_back(w);
+                        }
+                    }
+                }
+                return target == none && queue.size() == numVertices;
+            }
+
+            [[nodiscard]] bool stronglyConnected() const
+            {
+                return offsets.size() <= 2 || (search(0, false) && search(0, true));
+            }
+
+            // Low-link DFS returning the bridges of the underlying graph. With orient set,
+            // also orients the undirected edges as in the proof of Robbins' theorem: tree
+            // edges away from the root, the other edges towards the ancestor.
+            std::vector<size_t> dfsBridges(bool orient)
+            {
+                size_t numVertices = offsets.size() - 1;
+                std::vector<size_t> discovered(numVertices, none), low(numVertices);
+                std::vector<size_t> parentEdge(numVertices, none), next(numVertices);
+                std::vector<size_t> stack, bridges;
+                size_t time = 0;
+                for (size_t root = 0; root < numVertices; ++root)
+                {
+                    if (discovered[root] != none)
+                        continue;
+                    discovered[root] = low[root] = time++;
+                    next[root] = offsets[root];
+                    stack.push_back(root);
+                    while (!stack.empty())
+                    {
+                        size_t v = stack.back();
+                        if (next[v] == offsets[v + 1])
+                        {
+                            stack.pop_back();
+                            if (parentEdge[v] != none)
+                            {
+                                size_t parent = other(parentEdge[v], v);
+                                low[parent] = std::min(low[parent], low[v]);
+                                if (low[v] > discovered[parent])
+                                    bridges.push_back(parentEdge[v]);
+                            }
+                            continue;
+                        }
+
+                        size_t edge = slotEdge[next[v]++];
+                        if (edge == parentEdge[v])
+                            continue;
+                        size_t w = other(edge, v);
+                        if (discovered[w] == none)
+                        {
+                            discovered[w] = low[w] = time++;
+                            parentEdge[w] = edge;
+                            next[w] = offsets[w];
+                            stack.push_back(w);
+                            if (orient && undirected[edge])
+                                setArc(edge, v);
+                        }
+                        else if (discovered[w] < discovered[v])
+                        {
+                            low[v] = std::min(low[v], discovered[w]);
+                            if (orient && undirected[edge])
+                                setArc(edge, v);
+                        }
+                    }
+                }
+                return bridges;
+            }
+
+            // Strong orientation of the undirected edges in one search (Chung, Garey and
+            // Tarjan). A depth first search from vertex 0 follows arcs forward and undirected
+            // edges either way, orienting undirected edges as it walks them: tree edges away
+            // from the root, the others towards the ancestor. low[v] is the earliest vertex
+            // that the subtree of v reaches in one step; no component is ever closed, so
+            // every visited vertex counts. A subtree that reaches nothing earlier than its
+            // root would be a strong component of its own, and the undirected tree edge
+            // above it is turned around to lead out of it; the way in is then one of the arcs
+            // into the subtree, which exists when no undirected edge is a bridge. Callers
+            // check strong connectivity and bridges first; returns false if the search still
+            // closes a subtree below a directed tree edge or misses a vertex. O(V + E).
+            bool orientStrongly()
+            {
+                size_t numVertices = offsets.size() - 1;
+                if (numVertices == 0)
+                    return true;
+                std::vector<size_t> discovered(numVertices, none), low(numVertices);
+                std::vector<size_t> parentEdge(numVertices, none), next(numVertices);
+                std::vector<size_t> stack{0};
+                size_t time = 0;
+                discovered[0] = low[0] = time++;
+                next[0] = offsets[0];
+                while (!stack.empty())
+                {
+                    size_t v = stack.back();
+                    if (next[v] == offsets[v + 1])
+                    {
+                        stack.pop_back();
+                        if (parentEdge[v] == none)
+                            continue;
+                        size_t parent = other(parentEdge[v], v);
+                        if (low[v] == discovered[v])
+                        {
+                            if (!undirected[parentEdge[v]])
+                                return false;
+                            setArc(parentEdge[v], v);
+                            low[v] = discovered[parent];
+                        }
+                        low[parent] = std::min(low[parent], low[v]);
+                        continue;
+                    }
+
+                    size_t edge = slotEdge[next[v]++];
+                    size_t w = other(edge, v);
+                    if (undirected[edge])
+                    {
+                        // descendants orient the edge before the ancestor gets to it.
+                        if (edge == parentEdge[v] || (discovered[w] != none && discovered[w] > discovered[v]))
+                            continue;
+                        setArc(edge, v);
+                    }
+                    else if (!hasArc(edge, v))
+                    {
+                        continue;
+                    }
+
+                    if (discovered[w] == none)
+                    {
+                        discovered[w] = low[w] = time++;
+                        parentEdge[w] = edge;
+                        next[w] = offsets[w];
+                        stack.push_back(w);
+                    }
+                    else
+                    {
+                        low[v] = std::min(low[v], discovered[w]);
+                    }
+                }
+                return time == numVertices;
+            }
+        };
+    }
+
+    // Edges are kept in two bit matrices: presence, and whether the edge is directed. An
+    // undirected edge sets both (src, dest) and (dest, src) in presence and neither in
+    // directed. Edge values live in a separate array that is only allocated once an edge
+    // with a value is added, so a graph built with addEdge(src, dest, isDirected) costs
+    // two bits per vertex pair. Degrees are popcounts over rows and masked column scans,
+    // and forEachOutNeighborAt follows directed edges one way and undirected edges both.
+    //
+    // Storage selects the containers of the vertex maps (see GraphStorage.hpp); the edge
+    // bitmaps are always dense, allocated from the graph's resource under PmrStorage.
+    // Instrumented<DenseStorage> turns on stats().
+    template <typename VertexType, typename EdgeType = bool, typename Storage = DenseStorage>
+    class MixedGraphMatrix : public Appledore::MatrixRepresentation<MixedGraphMatrix<VertexType, EdgeType, Storage>, VertexType, EdgeType, Storage>
+    {
+        using Base = MatrixRepresentation<MixedGraphMatrix, VertexType, EdgeType, Storage>;
+        friend Base;
+        using Base::vertexToIndex;
+        using Base::indexToVertex;
+        using Base::numVertices;
+
     public:
-        template <typename... VertexArgs>
-        void addVertex(VertexArgs &&...vertices);
-        size_t getNumVertices() const;
-        const std::vector<VertexType> &getVertices() const;
         bool hasEdge(const VertexType &src, const VertexType &dest) const;
         EdgeType getEdgeValue(const VertexType &src, const VertexType &dest) const;
         std::vector<EdgeType> getEdges() const;
-        MixedGraphMatrix() : vertexToIndex(), indexToVertex(), adjacencyMatrix() {};
+        MixedGraphMatrix() : presence(), directed() {};
+        // With PmrStorage, the bitmaps, edge values and vertex maps allocate from
+        // resource, which must outlive the graph.
+        explicit MixedGraphMatrix(std::pmr::memory_resource *resource)
+            requires detail::PmrStoragePolicy<Storage>
+            : Base(resource), presence(resource), directed(resource), values(resource)
+        {
+        }
         void removeEdge(const VertexType &src, const VertexType &dest);
         void updateEdge(const VertexType &, const VertexType &, const EdgeType &);
         void addEdge(const VertexType &src, const VertexType &dest, std::optional<EdgeType> edgeValue, bool isDirected = false);
         void addEdge(const VertexType &src, const VertexType &dest, bool isDirected);
         void addEdge(const VertexType &src, const VertexType &dest, const EdgeType &edge);
         void addEdge(const VertexType &src, const VertexType &dest, const EdgeType &edge, bool isDirected);
-        void removeVertex(const VertexType &vert);
 
         [[nodiscard]] size_t indegree(const VertexType &vertex) const;
         [[nodiscard]] size_t outdegree(const VertexType &vertex) const;
         [[nodiscard]] size_t totalDegree(const VertexType &vertex) const;
 
+        // Non-throwing counterparts for probing workloads: a missing vertex or edge comes
+        // back as a GraphError (see GraphExceptions.hpp), no message is built. Edge
+        // references stay valid until the graph is modified.
+        GraphResult<bool> tryHasEdge(const VertexType &src, const VertexType &dest) const;
+        GraphResult<const EdgeType &> tryGetEdge(const VertexType &src, const VertexType &dest) const;
+        // nullptr when either vertex or the edge is missing.
+        const EdgeType *findEdge(const VertexType &src, const VertexType &dest) const;
+        // EdgeNotFound when there was no edge to remove, which removeEdge ignores.
+        GraphResult<> tryRemoveEdge(const VertexType &src, const VertexType &dest);
+        GraphResult<> tryUpdateEdge(const VertexType &src, const VertexType &dest, const EdgeType &newValue);
+        GraphResult<size_t> tryIndegree(const VertexType &vertex) const;
+        GraphResult<size_t> tryOutdegree(const VertexType &vertex) const;
+        GraphResult<size_t> tryTotalDegree(const VertexType &vertex) const;
+
+        // Overloads taking handles from handleOf(), which resolve both vertices without a map
+        // lookup. Stale handles throw std::invalid_argument, except in operator() and
+        // findEdge, which answer false and nullptr.
+        bool hasEdge(VertexHandle src, VertexHandle dest) const;
+        EdgeType getEdgeValue(VertexHandle src, VertexHandle dest) const;
+        const EdgeType *findEdge(VertexHandle src, VertexHandle dest) const;
+        void removeEdge(VertexHandle src, VertexHandle dest);
+        void updateEdge(VertexHandle src, VertexHandle dest, const EdgeType &newValue);
+        void addEdge(VertexHandle src, VertexHandle dest, std::optional<EdgeType> edgeValue, bool isDirected = false);
+        void addEdge(VertexHandle src, VertexHandle dest, bool isDirected);
+        void addEdge(VertexHandle src, VertexHandle dest, const EdgeType &edge);
+        void addEdge(VertexHandle src, VertexHandle dest, const EdgeType &edge, bool isDirected);
+        [[nodiscard]] size_t indegree(VertexHandle vertex) const;
+        [[nodiscard]] size_t outdegree(VertexHandle vertex) const;
+        [[nodiscard]] size_t totalDegree(VertexHandle vertex) const;
+
+        // Index level access, indices follow the order of getVertices().
+        const EdgeType &getEdgeAt(size_t srcIndex, size_t destIndex) const;
+        [[nodiscard]] bool isDirectedAt(size_t srcIndex, size_t destIndex) const;
+        // Bulk insertion of (srcIndex, destIndex, edge) tuples, all directed or all
+        // undirected, timed as one operation.
+        template <typename Range>
+        void addEdgesAt(const Range &edges, bool isDirected);
+
+        // Orientations are lists of (srcIndex, destIndex) pairs, one per undirected edge.
+
+        // True when the undirected edges can be oriented without creating a cycle, which is
+        // exactly when the directed edges are acyclic and there is no undirected self loop.
+        [[nodiscard]] bool isMixedAcyclic() const;
+        // Orients every undirected edge along a topological order of the directed edges,
+        // std::nullopt when isMixedAcyclic() is false. O(V^2 / 64 + E).
+        [[nodiscard]] std::optional<std::vector<std::pair<size_t, size_t>>> acyclicOrientation() const;
+        // Orientation of the undirected edges that leaves the graph strongly connected, or
+        // std::nullopt if there is none: the graph must be strongly connected with
+        // undirected edges usable both ways and no undirected edge may be a bridge
+        // (Robbins, Boesch-Tindell). Found with the linear time depth first search of
+        // Chung, Garey and Tarjan, O(V^2 / 64 + E) including the scan of the matrix.
+        [[nodiscard]] std::optional<std::vector<std::pair<size_t, size_t>>> strongOrientation() const;
+        // Bridges of the underlying undirected graph as (smaller, larger) index pairs.
+        [[nodiscard]] std::vector<std::pair<size_t, size_t>> bridges() const;
+
         const bool operator()(VertexType src, VertexType dest) const
         {
+            auto timer = this->timeOp(GraphOp::HasEdge);
             if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
             {
                 return false;
             }
             size_t srcIndex = vertexToIndex.at(src);
             size_t destIndex = vertexToIndex.at(dest);
-            size_t index = getIndex(srcIndex, destIndex);
-            return adjacencyMatrix[index].has_value();
+            return presence.test(srcIndex, destIndex);
+        }
+
+        bool operator()(VertexHandle src, VertexHandle dest) const
+        {
+            auto timer = this->timeOp(GraphOp::HasEdge);
+            std::optional<size_t> srcIndex = this->findIndex(src);
+            std::optional<size_t> destIndex = this->findIndex(dest);
+            return srcIndex && destIndex && presence.test(*srcIndex, *destIndex);
         }
 
     private:
-        std::map<VertexType, size_t> vertexToIndex;
-        std::vector<VertexType> indexToVertex;
-        std::vector<std::optional<EdgeInfo<EdgeType>>> adjacencyMatrix;
-        size_t numVertices = 0;
+        // wrapped so that bool values are not bit-packed by std::vector<bool>.
+        struct StoredValue
+        {
+            EdgeType value;
+        };
+
+        using Bits = detail::BitMatrix<detail::DenseVectorFor<Storage, uint64_t>>;
+        using ValueArray = detail::DenseVectorFor<Storage, StoredValue>;
+
+        Bits presence;
+        Bits directed;
+        ValueArray values;
         inline size_t getIndex(size_t src, size_t dest) const;
+
+        // MatrixRepresentation hooks, word-wide over the presence bitmap.
+        bool cellAt(size_t src, size_t dest) const { return presence.test(src, dest); }
+        size_t rowCount(size_t row) const
+        {
+            this->countStat(GraphCounter::RowsScanned);
+            return presence.rowCount(row);
+        }
+        size_t columnCount(size_t col) const
+        {
+            this->countStat(GraphCounter::ColumnsScanned);
+            return presence.columnCount(col);
+        }
+        template <typename Func>
+        void forEachInRow(size_t row, Func &&func) const;
+        void growCells(size_t oldSize);
+        void selectCells(const std::vector<size_t> &order);
+        void cellMemory(MemoryUsage &usage) const;
+        void shrinkCells();
+        void setValue(size_t srcIndex, size_t destIndex, const std::optional<EdgeType> &edgeValue);
+        bool isUndirectedPair(size_t srcIndex, size_t destIndex) const;
+        GraphResult<std::pair<size_t, size_t>> tryIndexPair(const VertexType &src, const VertexType &dest) const;
+        std::pair<size_t, size_t> handleIndices(VertexHandle src, VertexHandle dest) const;
+        void addEdgeAt(size_t srcIndex, size_t destIndex, const std::optional<EdgeType> &edgeValue, bool isDirected);
+        const EdgeType &valueAt(size_t srcIndex, size_t destIndex) const;
+        void removeEdgeAt(size_t srcIndex, size_t destIndex);
+        void updateEdgeAt(size_t srcIndex, size_t destIndex, const EdgeType &newValue);
+        size_t totalDegreeAt(size_t index) const;
+        std::optional<std::vector<size_t>> directedTopologicalRanks() const;
+        detail::MixedSkeleton skeleton() const;
     };
 
-    template <typename VertexType, typename EdgeType>
-    template <typename... Vertices>
-    void MixedGraphMatrix<VertexType, EdgeType>::addVertex(Vertices &&...vertices) {
-        auto add_single_vertex = [this](const VertexType &vertex) {
-          if (vertexToIndex.count(vertex)) {
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::growCells(size_t oldSize)
+    {
+        presence.grow(numVertices);
+        directed.grow(numVertices);
+        if (values.empty())
+        {
             return;
-          }
-          size_t newIndex = numVertices++;
-          vertexToIndex[vertex] = newIndex;
-          indexToVertex.push_back(vertex);
-        };
-    
-        size_t oldSize = numVertices;
-    
-        (add_single_vertex(std::forward<Vertices>(vertices)), ...);
-    
-        if (oldSize == numVertices) {
-          return;
         }
-    
-        std::vector<std::optional<EdgeInfo<EdgeType>>> newMatrix(
-            numVertices * numVertices, std::nullopt);
-    
-        for (size_t i = 0; i < oldSize; ++i) {
-          for (size_t j = 0; j < oldSize; ++j) {
-            newMatrix[i * numVertices + j] =
-                std::move(adjacencyMatrix[i * oldSize + j]);
-          }
+
+        ValueArray newValues(numVertices * numVertices, values.get_allocator());
+        for (size_t i = 0; i < oldSize; ++i)
+        {
+            for (size_t j = 0; j < oldSize; ++j)
+            {
+                newValues[i * numVertices + j] = std::move(values[i * oldSize + j]);
+            }
+        }
+        values = std::move(newValues);
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    // keeps the vertices listed in order, vertex order[i] becomes index i.
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::selectCells(const std::vector<size_t> &order)
+    {
+        presence.select(order);
+        directed.select(order);
+        if (!values.empty())
+        {
+            ValueArray newValues(order.size() * order.size(), values.get_allocator());
+            for (size_t i = 0; i < order.size(); ++i)
+            {
+                for (size_t j = 0; j < order.size(); ++j)
+                {
+                    newValues[i * order.size() + j] = std::move(values[getIndex(order[i], order[j])]);
+                }
+            }
+            values = std::move(newValues);
+        }
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::cellMemory(MemoryUsage &usage) const
+    {
+        usage.adjacency = presence.memoryUsage();
+        usage.adjacency += directed.memoryUsage();
+        usage.adjacency += detail::containerMemory(values);
+        if constexpr (!std::is_trivially_copyable_v<EdgeType>)
+        {
+            for (const StoredValue &stored : values)
+            {
+                usage.edgeData += HeapFootprint<EdgeType>::of(stored.value);
+            }
         }
-    
-        adjacencyMatrix = std::move(newMatrix);
-      }
+    }
 
-    template <typename VertexType, typename EdgeType>
-    size_t Appledore::MixedGraphMatrix<VertexType, EdgeType>::getNumVertices() const
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::shrinkCells()
     {
-        return numVertices;
+        presence.shrinkToFit();
+        directed.shrinkToFit();
+        values.shrink_to_fit();
     }
 
-    template <typename VertexType, typename EdgeType>
-    EdgeType MixedGraphMatrix<VertexType, EdgeType>::getEdgeValue(const VertexType &src, const VertexType &dest) const
+    template <typename VertexType, typename EdgeType, typename Storage>
+    // the value array is allocated on the first edge that carries a value.
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::setValue(size_t srcIndex, size_t destIndex, const std::optional<EdgeType> &edgeValue)
     {
+        if (values.empty())
+        {
+            if (!edgeValue.has_value())
+            {
+                return;
+            }
+            values.resize(numVertices * numVertices);
+        }
+        values[getIndex(srcIndex, destIndex)].value = edgeValue.value_or(EdgeType());
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    EdgeType MixedGraphMatrix<VertexType, EdgeType, Storage>::getEdgeValue(const VertexType &src, const VertexType &dest) const
+    {
+        auto timer = this->timeOp(GraphOp::GetEdge);
         if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
         {
             throw std::invalid_argument("One or both vertices do not exist");
@@ -102,85 +586,104 @@ namespace Appledore
         size_t srcIndex = vertexToIndex.at(src);
         size_t destIndex = vertexToIndex.at(dest);
 
-        size_t index = getIndex(srcIndex, destIndex);
-
-        if (!adjacencyMatrix[index].has_value())
-        {
-            throw std::runtime_error("Edge does not exist");
-        }
-
-        return adjacencyMatrix[index]->value;
+        return getEdgeAt(srcIndex, destIndex);
     }
 
-    template <typename VertexType, typename EdgeType>
-    inline size_t MixedGraphMatrix<VertexType, EdgeType>::getIndex(size_t src, size_t dest) const
+    template <typename VertexType, typename EdgeType, typename Storage>
+    inline size_t MixedGraphMatrix<VertexType, EdgeType, Storage>::getIndex(size_t src, size_t dest) const
     {
         return src * numVertices + dest;
     }
 
-    template <typename VertexType, typename EdgeType>
+    template <typename VertexType, typename EdgeType, typename Storage>
     // generic, being used by all overloads.
-    void MixedGraphMatrix<VertexType, EdgeType>::addEdge(const VertexType &src, const VertexType &dest, std::optional<EdgeType> edgeValue, bool isDirected)
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::addEdge(const VertexType &src, const VertexType &dest, std::optional<EdgeType> edgeValue, bool isDirected)
     {
+        auto timer = this->timeOp(GraphOp::AddEdge);
         if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
         {
             throw std::invalid_argument("One or both vertices do not exist");
         }
 
-        size_t srcIndex = vertexToIndex.at(src);
-        size_t destIndex = vertexToIndex.at(dest);
-
-        size_t index = getIndex(srcIndex, destIndex);
-        adjacencyMatrix[index] = EdgeInfo<EdgeType>(edgeValue.value_or(EdgeType()), isDirected);
+        addEdgeAt(vertexToIndex.at(src), vertexToIndex.at(dest), edgeValue, isDirected);
+    }
 
-        if (!isDirected)
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::addEdgeAt(size_t srcIndex, size_t destIndex, const std::optional<EdgeType> &edgeValue, bool isDirected)
+    {
+        presence.set(srcIndex, destIndex);
+        setValue(srcIndex, destIndex, edgeValue);
+        if (isDirected)
+        {
+            directed.set(srcIndex, destIndex);
+        }
+        else
         {
-            size_t reverseIndex = getIndex(destIndex, srcIndex);
-            adjacencyMatrix[reverseIndex] = EdgeInfo<EdgeType>(edgeValue.value_or(EdgeType()), isDirected);
+            directed.reset(srcIndex, destIndex);
+            presence.set(destIndex, srcIndex);
+            directed.reset(destIndex, srcIndex);
+            setValue(destIndex, srcIndex, edgeValue);
         }
     }
-    template <typename VertexType, typename EdgeType>
+    template <typename VertexType, typename EdgeType, typename Storage>
+    template <typename Range>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::addEdgesAt(const Range &edges, bool isDirected)
+    {
+        auto timer = this->timeOp(GraphOp::AddEdge);
+        for (const auto &[srcIndex, destIndex, edge] : edges)
+        {
+            this->checkIndex(srcIndex);
+            this->checkIndex(destIndex);
+            addEdgeAt(srcIndex, destIndex, edge, isDirected);
+        }
+    }
+    template <typename VertexType, typename EdgeType, typename Storage>
     // case 1: non weidghted, directed/undirected egde.
-    void MixedGraphMatrix<VertexType, EdgeType>::addEdge(const VertexType &src, const VertexType &dest, bool isDirected)
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::addEdge(const VertexType &src, const VertexType &dest, bool isDirected)
     {
         addEdge(src, dest, std::nullopt, isDirected);
     }
-    template <typename VertexType, typename EdgeType>
+    template <typename VertexType, typename EdgeType, typename Storage>
     // case 2: weighted, undirected egde.
-    void MixedGraphMatrix<VertexType, EdgeType>::addEdge(const VertexType &src, const VertexType &dest, const EdgeType &edge)
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::addEdge(const VertexType &src, const VertexType &dest, const EdgeType &edge)
     {
         addEdge(src, dest, edge, false);
     }
-    template <typename VertexType, typename EdgeType>
+    template <typename VertexType, typename EdgeType, typename Storage>
     // case 3: weighted, undirected egde.
-    void MixedGraphMatrix<VertexType, EdgeType>::addEdge(const VertexType &src, const VertexType &dest, const EdgeType &edge, bool isDirected)
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::addEdge(const VertexType &src, const VertexType &dest, const EdgeType &edge, bool isDirected)
     {
         addEdge(src, dest, std::optional<EdgeType>(edge), isDirected);
     }
 
-    template <typename VertexType, typename EdgeType>
-    void MixedGraphMatrix<VertexType, EdgeType>::removeEdge(const VertexType &src, const VertexType &dest)
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::removeEdge(const VertexType &src, const VertexType &dest)
     {
+        auto timer = this->timeOp(GraphOp::RemoveEdge);
         if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
         {
             throw std::invalid_argument("One or both vertices do not exist");
         }
 
-        size_t srcIndex = vertexToIndex[src];
-        size_t destIndex = vertexToIndex[dest];
+        removeEdgeAt(vertexToIndex.at(src), vertexToIndex.at(dest));
+    }
 
-        size_t index = getIndex(srcIndex, destIndex);
-        adjacencyMatrix[index] = std::nullopt;
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::removeEdgeAt(size_t srcIndex, size_t destIndex)
+    {
+        presence.reset(srcIndex, destIndex);
+        directed.reset(srcIndex, destIndex);
 
-        if (!adjacencyMatrix[getIndex(destIndex, srcIndex)].value_or(EdgeInfo<EdgeType>()).isDirected)
+        if (!directed.test(destIndex, srcIndex))
         {
-            adjacencyMatrix[getIndex(destIndex, srcIndex)] = std::nullopt;
+            presence.reset(destIndex, srcIndex);
         }
     }
 
-    template <typename VertexType, typename EdgeType>
-    bool MixedGraphMatrix<VertexType, EdgeType>::hasEdge(const VertexType &src, const VertexType &dest) const
+    template <typename VertexType, typename EdgeType, typename Storage>
+    bool MixedGraphMatrix<VertexType, EdgeType, Storage>::hasEdge(const VertexType &src, const VertexType &dest) const
     {
+        auto timer = this->timeOp(GraphOp::HasEdge);
         if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
         {
             throw std::invalid_argument("One or both vertices do not exist");
@@ -189,11 +692,12 @@ namespace Appledore
         size_t srcIndex = vertexToIndex.at(src);
         size_t destIndex = vertexToIndex.at(dest);
 
-        return adjacencyMatrix[getIndex(srcIndex, destIndex)].has_value();
+        return presence.test(srcIndex, destIndex);
     }
-    template <typename VertexType, typename EdgeType>
-    void MixedGraphMatrix<VertexType, EdgeType>::updateEdge(const VertexType &src, const VertexType &dest, const EdgeType &newValue)
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::updateEdge(const VertexType &src, const VertexType &dest, const EdgeType &newValue)
     {
+        auto timer = this->timeOp(GraphOp::UpdateEdge);
         if (!vertexToIndex.count(src) || !vertexToIndex.count(dest))
         {
             throw std::invalid_argument("One or both vertices do not exist");
@@ -202,183 +706,518 @@ namespace Appledore
         size_t srcIndex = vertexToIndex.at(src);
         size_t destIndex = vertexToIndex.at(dest);
 
-        size_t index = getIndex(srcIndex, destIndex);
-
-        if (!adjacencyMatrix[index].has_value())
+        if (!presence.test(srcIndex, destIndex))
         {
             throw std::runtime_error("Edge does not exist");
         }
 
-        adjacencyMatrix[index]->value = newValue;
+        updateEdgeAt(srcIndex, destIndex, newValue);
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::updateEdgeAt(size_t srcIndex, size_t destIndex, const EdgeType &newValue)
+    {
+        setValue(srcIndex, destIndex, newValue);
 
         // If the edge is undirected, update the reverse edge too
-        if (!adjacencyMatrix[index]->isDirected)
+        if (!directed.test(srcIndex, destIndex))
         {
-            size_t reverseIndex = getIndex(destIndex, srcIndex);
-            adjacencyMatrix[reverseIndex]->value = newValue;
+            setValue(destIndex, srcIndex, newValue);
         }
     }
 
-    template <typename VertexType, typename EdgeType>
-    const std::vector<VertexType> &MixedGraphMatrix<VertexType, EdgeType>::getVertices() const
-    {
-        return indexToVertex;
-    }
-
-    template <typename VertexType, typename EdgeType>
-    std::vector<EdgeType> MixedGraphMatrix<VertexType, EdgeType>::getEdges() const
+    template <typename VertexType, typename EdgeType, typename Storage>
+    std::vector<EdgeType> MixedGraphMatrix<VertexType, EdgeType, Storage>::getEdges() const
     {
+        auto timer = this->timeOp(GraphOp::GetEdges);
         std::vector<EdgeType> edges;
 
+        // directed edges, and undirected edges from their upper triangle cell (src <= dest).
+        this->countStat(GraphCounter::RowsScanned, numVertices);
         for (size_t src = 0; src < numVertices; ++src)
         {
-            for (size_t dest = 0; dest < numVertices; ++dest)
+            const uint64_t *present = presence.row(src);
+            const uint64_t *oneWay = directed.row(src);
+            for (size_t w = 0; w < presence.wordsPerRow(); ++w)
             {
-                size_t index = src * numVertices + dest;
-
-                if (adjacencyMatrix[index].has_value())
+                size_t first = w * 64;
+                uint64_t upper = src <= first ? ~uint64_t{0} : src - first < 64 ? ~uint64_t{0} << (src - first) : 0;
+                for (uint64_t bits = present[w] & (oneWay[w] | upper); bits; bits &= bits - 1)
                 {
-                    if (adjacencyMatrix[index]->isDirected)
-                    {
-                        edges.push_back(adjacencyMatrix[index]->value);
-                    }
-                    else if (src <= dest)
-                    {
-                        edges.push_back(adjacencyMatrix[index]->value);
-                    }
+                    size_t dest = first + static_cast<size_t>(std::countr_zero(bits));
+                    edges.push_back(values.empty() ? EdgeType() : values[getIndex(src, dest)].value);
                 }
             }
         }
         return edges;
     }
 
-    template <typename VertexType, typename EdgeType>
-    void MixedGraphMatrix<VertexType, EdgeType>::removeVertex(const VertexType &vert)
+    template <typename VertexType, typename EdgeType, typename Storage>
+    size_t MixedGraphMatrix<VertexType, EdgeType, Storage>::indegree(const VertexType &vertex) const
+    {
+        auto timer = this->timeOp(GraphOp::Degree);
+        return columnCount(this->getIndexOf(vertex));
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    size_t MixedGraphMatrix<VertexType, EdgeType, Storage>::outdegree(const VertexType &vertex) const
     {
+        auto timer = this->timeOp(GraphOp::Degree);
+        return rowCount(this->getIndexOf(vertex));
+    }
 
-        if (!vertexToIndex.count(vert))
+    template <typename VertexType, typename EdgeType, typename Storage>
+    size_t MixedGraphMatrix<VertexType, EdgeType, Storage>::totalDegree(const VertexType &vertex) const
+    {
+        auto timer = this->timeOp(GraphOp::Degree);
+        return totalDegreeAt(this->getIndexOf(vertex));
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    size_t MixedGraphMatrix<VertexType, EdgeType, Storage>::totalDegreeAt(size_t index) const
+    {
+        // every edge leaving the vertex, plus the directed edges entering it; an undirected
+        // edge is already counted in the row.
+        this->countStat(GraphCounter::ColumnsScanned);
+        return rowCount(index) + directed.columnCount(index);
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    GraphResult<std::pair<size_t, size_t>> MixedGraphMatrix<VertexType, EdgeType, Storage>::tryIndexPair(const VertexType &src, const VertexType &dest) const
+    {
+        const size_t *srcIndex = this->findIndex(src);
+        if (!srcIndex)
+        {
+            return GraphError::SourceNotFound;
+        }
+        const size_t *destIndex = this->findIndex(dest);
+        if (!destIndex)
         {
-            throw std::invalid_argument("Vertex does not exist in the graph.");
+            return GraphError::TargetNotFound;
         }
+        return std::pair{*srcIndex, *destIndex};
+    }
 
-        size_t remIdx = vertexToIndex[vert];
-        size_t lastIdx = numVertices - 1;
+    template <typename VertexType, typename EdgeType, typename Storage>
+    GraphResult<bool> MixedGraphMatrix<VertexType, EdgeType, Storage>::tryHasEdge(const VertexType &src, const VertexType &dest) const
+    {
+        auto timer = this->timeOp(GraphOp::HasEdge);
+        auto indices = tryIndexPair(src, dest);
+        if (!indices)
+        {
+            return indices.error();
+        }
+        return presence.test(indices->first, indices->second);
+    }
 
-        if (remIdx != lastIdx)
+    template <typename VertexType, typename EdgeType, typename Storage>
+    GraphResult<const EdgeType &> MixedGraphMatrix<VertexType, EdgeType, Storage>::tryGetEdge(const VertexType &src, const VertexType &dest) const
+    {
+        auto timer = this->timeOp(GraphOp::GetEdge);
+        auto indices = tryIndexPair(src, dest);
+        if (!indices)
         {
-            for (size_t c = 0; c < numVertices; ++c)
-            {
-                std::swap(adjacencyMatrix[getIndex(remIdx, c)], adjacencyMatrix[getIndex(lastIdx, c)]);
-            }
-            for (size_t r = 0; r < numVertices; ++r)
-            {
-                std::swap(adjacencyMatrix[getIndex(r, remIdx)], adjacencyMatrix[getIndex(r, lastIdx)]);
-            }
+            return indices.error();
+        }
+        if (!presence.test(indices->first, indices->second))
+        {
+            return GraphError::EdgeNotFound;
+        }
+        return valueAt(indices->first, indices->second);
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    const EdgeType *MixedGraphMatrix<VertexType, EdgeType, Storage>::findEdge(const VertexType &src, const VertexType &dest) const
+    {
+        GraphResult<const EdgeType &> edge = tryGetEdge(src, dest);
+        return edge ? &*edge : nullptr;
+    }
 
-            VertexType movedVertex = indexToVertex[lastIdx];
-            vertexToIndex[movedVertex] = remIdx;
-            indexToVertex[remIdx] = movedVertex;
+    template <typename VertexType, typename EdgeType, typename Storage>
+    GraphResult<> MixedGraphMatrix<VertexType, EdgeType, Storage>::tryRemoveEdge(const VertexType &src, const VertexType &dest)
+    {
+        auto timer = this->timeOp(GraphOp::RemoveEdge);
+        auto indices = tryIndexPair(src, dest);
+        if (!indices)
+        {
+            return indices.error();
+        }
+        if (!presence.test(indices->first, indices->second))
+        {
+            return GraphError::EdgeNotFound;
         }
+        removeEdgeAt(indices->first, indices->second);
+        return {};
+    }
 
-        vertexToIndex.erase(vert);
-        indexToVertex.pop_back();
+    template <typename VertexType, typename EdgeType, typename Storage>
+    GraphResult<> MixedGraphMatrix<VertexType, EdgeType, Storage>::tryUpdateEdge(const VertexType &src, const VertexType &dest, const EdgeType &newValue)
+    {
+        auto timer = this->timeOp(GraphOp::UpdateEdge);
+        auto indices = tryIndexPair(src, dest);
+        if (!indices)
+        {
+            return indices.error();
+        }
+        if (!presence.test(indices->first, indices->second))
+        {
+            return GraphError::EdgeNotFound;
+        }
+        updateEdgeAt(indices->first, indices->second, newValue);
+        return {};
+    }
 
-        size_t newSize = (numVertices - 1) * (numVertices - 1);
-        std::vector<std::optional<EdgeInfo<EdgeType>>> newMatrix(newSize);
+    template <typename VertexType, typename EdgeType, typename Storage>
+    GraphResult<size_t> MixedGraphMatrix<VertexType, EdgeType, Storage>::tryIndegree(const VertexType &vertex) const
+    {
+        auto timer = this->timeOp(GraphOp::Degree);
+        const size_t *index = this->findIndex(vertex);
+        if (!index)
+        {
+            return GraphError::VertexNotFound;
+        }
+        return columnCount(*index);
+    }
 
-        for (size_t r = 0; r < numVertices - 1; ++r)
+    template <typename VertexType, typename EdgeType, typename Storage>
+    GraphResult<size_t> MixedGraphMatrix<VertexType, EdgeType, Storage>::tryOutdegree(const VertexType &vertex) const
+    {
+        auto timer = this->timeOp(GraphOp::Degree);
+        const size_t *index = this->findIndex(vertex);
+        if (!index)
         {
-            for (size_t c = 0; c < numVertices - 1; ++c)
-            {
-                newMatrix[r * (numVertices - 1) + c] = adjacencyMatrix[getIndex(r, c)];
-            }
+            return GraphError::VertexNotFound;
         }
+        return rowCount(*index);
+    }
 
-        adjacencyMatrix = std::move(newMatrix);
+    template <typename VertexType, typename EdgeType, typename Storage>
+    GraphResult<size_t> MixedGraphMatrix<VertexType, EdgeType, Storage>::tryTotalDegree(const VertexType &vertex) const
+    {
+        auto timer = this->timeOp(GraphOp::Degree);
+        const size_t *index = this->findIndex(vertex);
+        if (!index)
+        {
+            return GraphError::VertexNotFound;
+        }
+        return totalDegreeAt(*index);
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    std::pair<size_t, size_t> MixedGraphMatrix<VertexType, EdgeType, Storage>::handleIndices(VertexHandle src, VertexHandle dest) const
+    {
+        return {this->getIndexOf(src), this->getIndexOf(dest)};
+    }
 
-        --numVertices;
+    template <typename VertexType, typename EdgeType, typename Storage>
+    bool MixedGraphMatrix<VertexType, EdgeType, Storage>::hasEdge(VertexHandle src, VertexHandle dest) const
+    {
+        auto timer = this->timeOp(GraphOp::HasEdge);
+        auto [srcIndex, destIndex] = handleIndices(src, dest);
+        return presence.test(srcIndex, destIndex);
     }
 
-    template <typename VertexType, typename EdgeType>
-    size_t MixedGraphMatrix<VertexType, EdgeType>::indegree(const VertexType &vertex) const
+    template <typename VertexType, typename EdgeType, typename Storage>
+    EdgeType MixedGraphMatrix<VertexType, EdgeType, Storage>::getEdgeValue(VertexHandle src, VertexHandle dest) const
     {
-        if (!vertexToIndex.count(vertex))
+        auto timer = this->timeOp(GraphOp::GetEdge);
+        auto [srcIndex, destIndex] = handleIndices(src, dest);
+        return getEdgeAt(srcIndex, destIndex);
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    const EdgeType *MixedGraphMatrix<VertexType, EdgeType, Storage>::findEdge(VertexHandle src, VertexHandle dest) const
+    {
+        auto timer = this->timeOp(GraphOp::GetEdge);
+        std::optional<size_t> srcIndex = this->findIndex(src);
+        std::optional<size_t> destIndex = this->findIndex(dest);
+        if (!srcIndex || !destIndex || !presence.test(*srcIndex, *destIndex))
         {
-            throw std::invalid_argument("Vertex does not exist");
+            return nullptr;
         }
+        return &valueAt(*srcIndex, *destIndex);
+    }
 
-        size_t vertexIndex = vertexToIndex.at(vertex);
-        size_t inDegreeCount = 0;
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::removeEdge(VertexHandle src, VertexHandle dest)
+    {
+        auto timer = this->timeOp(GraphOp::RemoveEdge);
+        auto [srcIndex, destIndex] = handleIndices(src, dest);
+        removeEdgeAt(srcIndex, destIndex);
+    }
 
-        for (size_t src = 0; src < numVertices; ++src)
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::updateEdge(VertexHandle src, VertexHandle dest, const EdgeType &newValue)
+    {
+        auto timer = this->timeOp(GraphOp::UpdateEdge);
+        auto [srcIndex, destIndex] = handleIndices(src, dest);
+        if (!presence.test(srcIndex, destIndex))
         {
-            if (adjacencyMatrix[getIndex(src, vertexIndex)].has_value())
-            {
-                ++inDegreeCount;
-            }
+            throw std::runtime_error("Edge does not exist");
         }
+        updateEdgeAt(srcIndex, destIndex, newValue);
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::addEdge(VertexHandle src, VertexHandle dest, std::optional<EdgeType> edgeValue, bool isDirected)
+    {
+        auto timer = this->timeOp(GraphOp::AddEdge);
+        auto [srcIndex, destIndex] = handleIndices(src, dest);
+        addEdgeAt(srcIndex, destIndex, edgeValue, isDirected);
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::addEdge(VertexHandle src, VertexHandle dest, bool isDirected)
+    {
+        addEdge(src, dest, std::nullopt, isDirected);
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::addEdge(VertexHandle src, VertexHandle dest, const EdgeType &edge)
+    {
+        addEdge(src, dest, edge, false);
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::addEdge(VertexHandle src, VertexHandle dest, const EdgeType &edge, bool isDirected)
+    {
+        addEdge(src, dest, std::optional<EdgeType>(edge), isDirected);
+    }
 
-        return inDegreeCount;
+    template <typename VertexType, typename EdgeType, typename Storage>
+    size_t MixedGraphMatrix<VertexType, EdgeType, Storage>::indegree(VertexHandle vertex) const
+    {
+        auto timer = this->timeOp(GraphOp::Degree);
+        return columnCount(this->getIndexOf(vertex));
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    size_t MixedGraphMatrix<VertexType, EdgeType, Storage>::outdegree(VertexHandle vertex) const
+    {
+        auto timer = this->timeOp(GraphOp::Degree);
+        return rowCount(this->getIndexOf(vertex));
     }
 
-    template <typename VertexType, typename EdgeType>
-    size_t MixedGraphMatrix<VertexType, EdgeType>::outdegree(const VertexType &vertex) const
+    template <typename VertexType, typename EdgeType, typename Storage>
+    size_t MixedGraphMatrix<VertexType, EdgeType, Storage>::totalDegree(VertexHandle vertex) const
     {
-        if (!vertexToIndex.count(vertex))
+        auto timer = this->timeOp(GraphOp::Degree);
+        return totalDegreeAt(this->getIndexOf(vertex));
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    const EdgeType &MixedGraphMatrix<VertexType, EdgeType, Storage>::getEdgeAt(size_t srcIndex, size_t destIndex) const
+    {
+        if (!this->hasEdgeAt(srcIndex, destIndex))
         {
-            throw std::invalid_argument("Vertex does not exist");
+            throw std::runtime_error("Edge does not exist");
         }
+        return valueAt(srcIndex, destIndex);
+    }
 
-        size_t vertexIndex = vertexToIndex.at(vertex);
-        size_t outDegreeCount = 0;
+    template <typename VertexType, typename EdgeType, typename Storage>
+    // edges added without a value read as EdgeType().
+    const EdgeType &MixedGraphMatrix<VertexType, EdgeType, Storage>::valueAt(size_t srcIndex, size_t destIndex) const
+    {
+        if (values.empty())
+        {
+            static const EdgeType noValue{};
+            return noValue;
+        }
+        return values[getIndex(srcIndex, destIndex)].value;
+    }
 
-        for (size_t dest = 0; dest < numVertices; ++dest)
+    template <typename VertexType, typename EdgeType, typename Storage>
+    bool MixedGraphMatrix<VertexType, EdgeType, Storage>::isDirectedAt(size_t srcIndex, size_t destIndex) const
+    {
+        if (!this->hasEdgeAt(srcIndex, destIndex))
         {
-            if (adjacencyMatrix[getIndex(vertexIndex, dest)].has_value())
+            throw std::runtime_error("Edge does not exist");
+        }
+        return directed.test(srcIndex, destIndex);
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    template <typename Func>
+    void MixedGraphMatrix<VertexType, EdgeType, Storage>::forEachInRow(size_t srcIndex, Func &&func) const
+    {
+        this->countStat(GraphCounter::RowsScanned);
+        const uint64_t *row = presence.row(srcIndex);
+        for (size_t w = 0; w < presence.wordsPerRow(); ++w)
+        {
+            for (uint64_t bits = row[w]; bits; bits &= bits - 1)
             {
-                ++outDegreeCount;
+                func(w * 64 + static_cast<size_t>(std::countr_zero(bits)));
             }
         }
+    }
 
-        return outDegreeCount;
+    template <typename VertexType, typename EdgeType, typename Storage>
+    // both cells present and neither directed; any other present cell is a directed edge.
+    bool MixedGraphMatrix<VertexType, EdgeType, Storage>::isUndirectedPair(size_t srcIndex, size_t destIndex) const
+    {
+        return presence.test(srcIndex, destIndex) && !directed.test(srcIndex, destIndex) &&
+               presence.test(destIndex, srcIndex) && !directed.test(destIndex, srcIndex);
     }
 
-    template <typename VertexType, typename EdgeType>
-    size_t MixedGraphMatrix<VertexType, EdgeType>::totalDegree(const VertexType &vertex) const
+    template <typename VertexType, typename EdgeType, typename Storage>
+    // Kahn's algorithm over the directed edges: rank[v] is the position of v in a topological
+    // order, std::nullopt if the directed edges contain a cycle.
+    std::optional<std::vector<size_t>> MixedGraphMatrix<VertexType, EdgeType, Storage>::directedTopologicalRanks() const
     {
-        if (!vertexToIndex.count(vertex))
+        std::vector<size_t> remaining(numVertices, 0);
+        for (size_t src = 0; src < numVertices; ++src)
         {
-            throw std::invalid_argument("Vertex does not exist");
+            forEachInRow(src, [&](size_t dest)
+                         {
+                             if (!isUndirectedPair(src, dest))
+                                 ++remaining[dest]; });
         }
 
-        size_t vertexIndex = vertexToIndex.at(vertex);
-        size_t totalDegreeCount = 0;
+        std::vector<size_t> order;
+        order.reserve(numVertices);
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            if (remaining[v] == 0)
+                order.push_back(v);
+        }
+        for (size_t head = 0; head < order.size(); ++head)
+        {
+            size_t src = order[head];
+            this->countStat(GraphCounter::NodesExpanded);
+            forEachInRow(src, [&](size_t dest)
+                         {
+                             if (!isUndirectedPair(src, dest) && --remaining[dest] == 0)
+                                 order.push_back(dest); });
+        }
+        if (order.size() != numVertices)
+        {
+            return std::nullopt;
+        }
 
-        for (size_t other = 0; other < numVertices; ++other)
+        std::vector<size_t> rank(numVertices);
+        for (size_t i = 0; i < numVertices; ++i)
         {
-            auto forwardIndex = getIndex(vertexIndex, other);
-            auto backwardIndex = getIndex(other, vertexIndex);
+            rank[order[i]] = i;
+        }
+        return rank;
+    }
 
-            if (adjacencyMatrix[forwardIndex].has_value())
-            {
-                if (adjacencyMatrix[forwardIndex]->isDirected)
-                {
-                    ++totalDegreeCount;
-                }
-                else
-                {
-                    ++totalDegreeCount;
-                }
-            }
+    template <typename VertexType, typename EdgeType, typename Storage>
+    bool MixedGraphMatrix<VertexType, EdgeType, Storage>::isMixedAcyclic() const
+    {
+        auto timer = this->timeOp(GraphOp::CycleCheck);
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            if (isUndirectedPair(v, v))
+                return false;
+        }
+        return directedTopologicalRanks().has_value();
+    }
 
-            if (adjacencyMatrix[backwardIndex].has_value() &&
-                adjacencyMatrix[backwardIndex]->isDirected)
-            {
-                ++totalDegreeCount;
-            }
+    template <typename VertexType, typename EdgeType, typename Storage>
+    std::optional<std::vector<std::pair<size_t, size_t>>> MixedGraphMatrix<VertexType, EdgeType, Storage>::acyclicOrientation() const
+    {
+        auto timer = this->timeOp(GraphOp::Orientation);
+        if (!isMixedAcyclic())
+        {
+            return std::nullopt;
         }
+        std::vector<size_t> rank = *directedTopologicalRanks();
+        std::vector<std::pair<size_t, size_t>> orientation;
+        for (size_t src = 0; src < numVertices; ++src)
+        {
+            forEachInRow(src, [&](size_t dest)
+                         {
+                             if (src < dest && isUndirectedPair(src, dest))
+                             {
+                                 if (rank[src] < rank[dest])
+                                     orientation.emplace_back(src, dest);
+                                 else
+                                     orientation.emplace_back(dest, src);
+                             } });
+        }
+        return orientation;
+    }
 
-        return totalDegreeCount;
+    template <typename VertexType, typename EdgeType, typename Storage>
+    detail::MixedSkeleton MixedGraphMatrix<VertexType, EdgeType, Storage>::skeleton() const
+    {
+        detail::MixedSkeleton skeleton;
+        for (size_t src = 0; src < numVertices; ++src)
+        {
+            forEachInRow(src, [&](size_t dest)
+                         {
+                             // each pair once, from its smaller end or from the only present cell.
+                             if (src == dest || (src > dest && presence.test(dest, src)))
+                                 return;
+                             size_t a = std::min(src, dest), b = std::max(src, dest);
+                             if (isUndirectedPair(a, b))
+                             {
+                                 skeleton.addPair(a, b, 3, true);
+                             }
+                             else
+                             {
+                                 uint8_t arcs = (presence.test(a, b) ? 1 : 0) | (presence.test(b, a) ? 2 : 0);
+                                 skeleton.addPair(a, b, arcs, false);
+                             } });
+        }
+        skeleton.buildAdjacency(numVertices);
+        return skeleton;
+    }
+
+    template <typename VertexType, typename EdgeType, typename Storage>
+    std::vector<std::pair<size_t, size_t>> MixedGraphMatrix<VertexType, EdgeType, Storage>::bridges() const
+    {
+        auto timer = this->timeOp(GraphOp::Bridges);
+        detail::MixedSkeleton underlying = skeleton();
+        std::vector<std::pair<size_t, size_t>> result;
+        for (size_t edge : underlying.dfsBridges(false))
+        {
+            result.push_back(underlying.pairs[edge]);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
     }
 
+    template <typename VertexType, typename EdgeType, typename Storage>
+    std::optional<std::vector<std::pair<size_t, size_t>>> MixedGraphMatrix<VertexType, EdgeType, Storage>::strongOrientation() const
+    {
+        auto timer = this->timeOp(GraphOp::Orientation);
+        detail::MixedSkeleton underlying = skeleton();
+        if (!underlying.stronglyConnected())
+        {
+            return std::nullopt;
+        }
+        for (size_t edge : underlying.dfsBridges(false))
+        {
+            if (underlying.undirected[edge])
+                return std::nullopt;
+        }
+        if (!underlying.orientStrongly())
+        {
+            return std::nullopt;
+        }
+
+        std::vector<std::pair<size_t, size_t>> orientation;
+        for (size_t edge = 0; edge < underlying.pairs.size(); ++edge)
+        {
+            if (!underlying.undirected[edge])
+                continue;
+            auto [a, b] = underlying.pairs[edge];
+            if (underlying.arcs[edge] == 1)
+                orientation.emplace_back(a, b);
+            else
+                orientation.emplace_back(b, a);
+        }
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            if (isUndirectedPair(v, v))
+                orientation.emplace_back(v, v);
+        }
+        return orientation;
+    }
+
+
+    static_assert(AdjacencyMatrixGraph<MixedGraphMatrix<int, int>>);
 };
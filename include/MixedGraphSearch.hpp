@@ -0,0 +1,273 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "MixedGraph.hpp"
+
+namespace Appledore
+{
+    // Default edge weight for shortest paths: the edge value itself, or one hop per edge
+    // for bool (unweighted) edges.
+    struct EdgeValueWeight
+    {
+        template <typename EdgeType>
+        auto operator()(const EdgeType &value) const
+        {
+            if constexpr (std::is_same_v<EdgeType, bool>)
+                return size_t{1};
+            else
+                return value;
+        }
+    };
+
+    template <typename Distance>
+    struct ShortestPath
+    {
+        Distance distance;
+        std::vector<size_t> vertices; // source first, target last
+    };
+
+    namespace detail
+    {
+        // Visitors may return void, or bool where false stops the search.
+        template <typename Visit, typename... Args>
+        bool visitAndContinue(Visit &visit, Args... args)
+        {
+            if constexpr (std::is_same_v<std::invoke_result_t<Visit &, Args...>, bool>)
+            {
+                return visit(args...);
+            }
+            else
+            {
+                visit(args...);
+                return true;
+            }
+        }
+    }
+
+    // BFS, DFS, reachability and Dijkstra over a MixedGraphMatrix, by vertex index. A
+    // directed edge is followed from src to dest only, an undirected edge both ways.
+    //
+    // The searcher keeps its queue, stack, heap and per-vertex arrays between queries, so
+    // repeated queries on the same graph do not allocate once the buffers have grown.
+    // Visited marks are generation stamps, a query does not clear O(V) state up front.
+    // It holds a reference to the graph, which must outlive it; the graph may change
+    // between queries but not during one.
+    //
+    //   MixedGraphSearch search(flights, [](const FlightRoute &r) { return r.duration; });
+    //   auto route = search.shortestPath(flights.getIndexOf("New York"), flights.getIndexOf("Tokyo"));
+    template <typename VertexType, typename EdgeType, typename Weight = EdgeValueWeight, typename Storage = DenseStorage>
+    class MixedGraphSearch
+    {
+    public:
+        using Distance = std::decay_t<std::invoke_result_t<const Weight &, const EdgeType &>>;
+        static constexpr Distance unreachable = std::numeric_limits<Distance>::max();
+
+        explicit MixedGraphSearch(const MixedGraphMatrix<VertexType, EdgeType, Storage> &graph, Weight weight = Weight())
+            : graph(graph), weight(std::move(weight)) {}
+
+        // Breadth first from source, calling visit(index, depth) once per reachable vertex
+        // in order of increasing depth.
+        template <typename Visit>
+        void bfs(size_t source, Visit &&visit)
+        {
+            start(source);
+            queue.clear();
+            queue.push_back(source);
+            mark(source);
+            size_t depth = 0;
+            for (size_t head = 0, levelEnd = 1; head < queue.size(); ++depth, levelEnd = queue.size())
+            {
+                for (; head < levelEnd; ++head)
+                {
+                    size_t vertex = queue[head];
+                    if (!detail::visitAndContinue(visit, vertex, depth))
+                        return;
+                    graph.forEachOutNeighborAt(vertex, [this](size_t next)
+                                               {
+                                                   if (!marked(next))
+                                                   {
+                                                       mark(next);
+                                                       queue.push_back(next);
+                                                   } });
+                }
+            }
+        }
+
+        // Depth first preorder from source, calling visit(index). Neighbors are explored in
+        // index order, as a recursive DFS would, without recursion.
+        template <typename Visit>
+        void dfs(size_t source, Visit &&visit)
+        {
+            start(source);
+            stack.clear();
+            stack.push_back(source);
+            while (!stack.empty())
+            {
+                size_t vertex = stack.back();
+                stack.pop_back();
+                if (marked(vertex))
+                    continue;
+                mark(vertex);
+                if (!detail::visitAndContinue(visit, vertex))
+                    return;
+
+                size_t first = stack.size();
+                graph.forEachOutNeighborAt(vertex, [this](size_t next)
+                                           {
+                                               if (!marked(next))
+                                                   stack.push_back(next); });
+                std::reverse(stack.begin() + first, stack.end());
+            }
+        }
+
+        [[nodiscard]] bool reachable(size_t source, size_t target)
+        {
+            checkIndex(target);
+            bool found = false;
+            bfs(source, [&found, target](size_t vertex, size_t)
+                {
+                    found = vertex == target;
+                    return !found; });
+            return found;
+        }
+
+        // Cheapest path from source to target, or std::nullopt if target is unreachable.
+        // Stops as soon as target is settled. Throws std::invalid_argument on a negative
+        // edge weight. With an integral Distance, a target whose distance does not fit in it
+        // counts as unreachable.
+        std::optional<ShortestPath<Distance>> shortestPath(size_t source, size_t target)
+        {
+            checkIndex(target);
+            dijkstra(source, target);
+            if (!marked(target))
+                return std::nullopt;
+
+            ShortestPath<Distance> path{distance[target], {}};
+            for (size_t vertex = target; vertex != source; vertex = parent[vertex])
+            {
+                path.vertices.push_back(vertex);
+            }
+            path.vertices.push_back(source);
+            std::reverse(path.vertices.begin(), path.vertices.end());
+            return path;
+        }
+
+        // Distances from source to every vertex, unreachable where there is no path. The
+        // reference stays valid until the next query.
+        const std::vector<Distance> &shortestDistances(size_t source)
+        {
+            dijkstra(source, graph.getNumVertices());
+            for (size_t vertex = 0; vertex < graph.getNumVertices(); ++vertex)
+            {
+                if (!marked(vertex))
+                    distance[vertex] = unreachable;
+            }
+            return distance;
+        }
+
+    private:
+        const MixedGraphMatrix<VertexType, EdgeType, Storage> &graph;
+        Weight weight;
+
+        std::vector<uint32_t> stamps;
+        uint32_t generation = 0;
+        std::vector<size_t> queue;
+        std::vector<size_t> stack;
+        std::vector<Distance> distance;
+        std::vector<size_t> parent;
+        std::vector<std::pair<Distance, size_t>> heap;
+
+        void checkIndex(size_t index) const
+        {
+            if (index >= graph.getNumVertices())
+            {
+                throw std::out_of_range("Vertex index out of range");
+            }
+        }
+
+        // Starts a new query: every vertex becomes unmarked by moving to a new generation.
+        void start(size_t source)
+        {
+            checkIndex(source);
+            size_t n = graph.getNumVertices();
+            if (stamps.size() < n)
+            {
+                stamps.resize(n, generation);
+            }
+            if (++generation == 0)
+            {
+                std::fill(stamps.begin(), stamps.end(), 0);
+                generation = 1;
+            }
+        }
+
+        bool marked(size_t vertex) const { return stamps[vertex] == generation; }
+        void mark(size_t vertex) { stamps[vertex] = generation; }
+
+        // Lazy-deletion Dijkstra. A vertex is marked once its distance is first set, and
+        // distance/parent are only meaningful for marked vertices. Stops when target is
+        // popped; pass the vertex count to settle everything reachable.
+        void dijkstra(size_t source, size_t target)
+        {
+            start(source);
+            size_t n = graph.getNumVertices();
+            if (distance.size() < n)
+            {
+                distance.resize(n);
+                parent.resize(n);
+            }
+            auto later = [](const std::pair<Distance, size_t> &a, const std::pair<Distance, size_t> &b)
+            {
+                return a.first > b.first;
+            };
+
+            heap.clear();
+            mark(source);
+            distance[source] = Distance{};
+            parent[source] = source;
+            heap.emplace_back(Distance{}, source);
+            while (!heap.empty())
+            {
+                std::pop_heap(heap.begin(), heap.end(), later);
+                auto [dist, vertex] = heap.back();
+                heap.pop_back();
+                if (dist > distance[vertex])
+                    continue;
+                if (vertex == target)
+                    return;
+
+                graph.forEachOutNeighborAt(vertex, [&, vertex = vertex, dist = dist](size_t next)
+                                           {
+                                               Distance step = weight(graph.getEdgeAt(vertex, next));
+                                               if (step < Distance{})
+                                               {
+                                                   throw std::invalid_argument("Edge weights must be non-negative");
+                                               }
+                                               // integral distances saturate: a path longer than
+                                               // unreachable is left unreachable instead of overflowing.
+                                               if constexpr (std::is_integral_v<Distance>)
+                                               {
+                                                   if (step > unreachable - dist)
+                                                       return;
+                                               }
+                                               Distance candidate = dist + step;
+                                               if (!marked(next) || candidate < distance[next])
+                                               {
+                                                   mark(next);
+                                                   distance[next] = candidate;
+                                                   parent[next] = vertex;
+                                                   heap.emplace_back(candidate, next);
+                                                   std::push_heap(heap.begin(), heap.end(), later);
+                                               } });
+            }
+        }
+    };
+}
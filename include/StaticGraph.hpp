@@ -0,0 +1,325 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include "MatrixRep.hpp"
+
+namespace Appledore
+{
+    // Fixed capacity list of vertex indices, returned by StaticGraphMatrix queries so that
+    // they stay usable in constant expressions.
+    template <size_t N>
+    struct StaticVertexList
+    {
+        std::array<size_t, N> items{};
+        size_t count = 0;
+
+        constexpr void push_back(size_t vertex) { items[count++] = vertex; }
+        constexpr size_t size() const { return count; }
+        constexpr size_t operator[](size_t i) const { return items[i]; }
+        constexpr auto begin() const { return items.begin(); }
+        constexpr auto end() const { return items.begin() + count; }
+    };
+
+    // Graph over the vertices 0 .. N-1 whose storage is sized at compile time: one row of
+    // 64-bit presence words per vertex, a value table for weighted graphs and degree
+    // counters. Nothing is allocated and every member is constexpr, so a graph can be
+    // built and checked while compiling:
+    //
+    //   constexpr StaticGraphMatrix<4, int, DirectedG> stages{{0, 1, 5}, {1, 2, 3}, {2, 3, 1}};
+    //   static_assert(!stages.isCyclic());
+    //   constexpr auto order = stages.topologicalSort(); // a cycle fails to compile
+    //
+    // Out of range vertices throw std::out_of_range, which is a compile error in a
+    // constant expression. operator() reads a presence bit without any check.
+    template <size_t N, typename EdgeType, typename Direction>
+    class StaticGraphMatrix
+    {
+        static constexpr bool directed = std::is_same_v<Direction, DirectedG>;
+        static constexpr bool weighted = !std::is_same_v<EdgeType, UnweightedG>;
+        static constexpr size_t wordsPerRow = (N + 63) / 64;
+
+    public:
+        struct Edge
+        {
+            size_t src;
+            size_t dest;
+            EdgeType value{};
+        };
+
+        constexpr StaticGraphMatrix() = default;
+
+        constexpr StaticGraphMatrix(std::initializer_list<Edge> edges)
+        {
+            for (const Edge &edge : edges)
+            {
+                addEdge(edge.src, edge.dest, edge.value);
+            }
+        }
+
+        static constexpr size_t getNumVertices() { return N; }
+        [[nodiscard]] constexpr size_t getNumEdges() const { return numEdges; }
+
+        constexpr void addEdge(size_t src, size_t dest, const EdgeType &value = EdgeType{})
+        {
+            checkVertices(src, dest);
+            if constexpr (weighted)
+            {
+                values[valueIndex(src, dest)] = value;
+            }
+            if (bit(src, dest))
+                return;
+
+            setBit(src, dest, true);
+            ++outDegrees[src];
+            ++inDegrees[dest];
+            if constexpr (!directed)
+            {
+                if (src != dest)
+                {
+                    setBit(dest, src, true);
+                    ++outDegrees[dest];
+                    ++inDegrees[src];
+                }
+            }
+            ++numEdges;
+        }
+
+        constexpr void removeEdge(size_t src, size_t dest)
+        {
+            checkVertices(src, dest);
+            if (!bit(src, dest))
+                return;
+
+            setBit(src, dest, false);
+            --outDegrees[src];
+            --inDegrees[dest];
+            if constexpr (!directed)
+            {
+                if (src != dest)
+                {
+                    setBit(dest, src, false);
+                    --outDegrees[dest];
+                    --inDegrees[src];
+                }
+            }
+            if constexpr (weighted)
+            {
+                values[valueIndex(src, dest)] = EdgeType{};
+            }
+            --numEdges;
+        }
+
+        constexpr void updateEdge(size_t src, size_t dest, const EdgeType &value)
+        {
+            static_assert(weighted, "Cannot update an edge in an unweighted graph.");
+            if (!hasEdge(src, dest))
+            {
+                throw std::runtime_error("No edge exists between the specified vertices.");
+            }
+            values[valueIndex(src, dest)] = value;
+        }
+
+        // Unchecked presence test, src and dest must be below N.
+        constexpr bool operator()(size_t src, size_t dest) const
+        {
+            return bit(src, dest);
+        }
+
+        [[nodiscard]] constexpr bool hasEdge(size_t src, size_t dest) const
+        {
+            checkVertices(src, dest);
+            return bit(src, dest);
+        }
+
+        constexpr const EdgeType &getEdge(size_t src, size_t dest) const
+        {
+            static_assert(weighted, "Unweighted graphs have no edge values.");
+            if (!hasEdge(src, dest))
+            {
+                throw std::runtime_error("No Edge exists between the given vertices.");
+            }
+            return values[valueIndex(src, dest)];
+        }
+
+        // For undirected graphs all three are the vertex degree, a self loop counting once.
+        [[nodiscard]] constexpr size_t outdegree(size_t vertex) const
+        {
+            checkVertex(vertex);
+            return outDegrees[vertex];
+        }
+
+        [[nodiscard]] constexpr size_t indegree(size_t vertex) const
+        {
+            checkVertex(vertex);
+            return inDegrees[vertex];
+        }
+
+        [[nodiscard]] constexpr size_t totalDegree(size_t vertex) const
+        {
+            checkVertex(vertex);
+            return directed ? inDegrees[vertex] + outDegrees[vertex] : outDegrees[vertex];
+        }
+
+        [[nodiscard]] constexpr StaticVertexList<N> getNeighbors(size_t vertex) const
+        {
+            checkVertex(vertex);
+            StaticVertexList<N> neighbors;
+            for (size_t w = 0; w < wordsPerRow; ++w)
+            {
+                for (uint64_t word = rows[vertex][w]; word; word &= word - 1)
+                {
+                    neighbors.push_back(w * 64 + static_cast<size_t>(std::countr_zero(word)));
+                }
+            }
+            return neighbors;
+        }
+
+        // The same queries under the index level names of AdjacencyMatrixGraph; the vertices
+        // of a static graph are their own indices.
+        [[nodiscard]] constexpr bool hasEdgeAt(size_t src, size_t dest) const { return hasEdge(src, dest); }
+        [[nodiscard]] constexpr size_t outdegreeAt(size_t vertex) const { return outdegree(vertex); }
+        [[nodiscard]] constexpr size_t indegreeAt(size_t vertex) const { return indegree(vertex); }
+        [[nodiscard]] constexpr StaticVertexList<N> getNeighborsAt(size_t vertex) const { return getNeighbors(vertex); }
+
+        [[nodiscard]] constexpr double density() const
+        {
+            if (N <= 1)
+                return 0.0;
+            double possible = static_cast<double>(N) * (N - 1);
+            return (directed ? 1.0 : 2.0) * static_cast<double>(numEdges) / possible;
+        }
+
+        // Directed graphs: Kahn's algorithm leaves vertices unprocessed exactly when there is
+        // a cycle. Undirected graphs: union-find, an edge inside one component (or a self
+        // loop) closes a cycle.
+        [[nodiscard]] constexpr bool isCyclic() const
+        {
+            if constexpr (directed)
+            {
+                return kahn().size() != N;
+            }
+            else
+            {
+                std::array<size_t, N> parent{};
+                for (size_t v = 0; v < N; ++v)
+                    parent[v] = v;
+                auto find = [&parent](size_t v)
+                {
+                    while (parent[v] != v)
+                    {
+                        parent[v] = parent[parent[v]];
+                        v = parent[v];
+                    }
+                    return v;
+                };
+                for (size_t src = 0; src < N; ++src)
+                {
+                    for (size_t dest = src; dest < N; ++dest)
+                    {
+                        if (!bit(src, dest))
+                            continue;
+                        size_t a = find(src), b = find(dest);
+                        if (a == b)
+                            return true;
+                        parent[a] = b;
+                    }
+                }
+                return false;
+            }
+        }
+
+        // Vertices in dependency order, ties broken by the smaller index. Throws
+        // std::logic_error for cyclic or undirected graphs.
+        [[nodiscard]] constexpr StaticVertexList<N> topologicalSort() const
+        {
+            if constexpr (!directed)
+            {
+                throw std::logic_error("Topological sort requires a directed graph.");
+            }
+            StaticVertexList<N> order = kahn();
+            if (order.size() != N)
+            {
+                throw std::logic_error("Graph contains a cycle, no topological order exists.");
+            }
+            return order;
+        }
+
+    private:
+        std::array<std::array<uint64_t, wordsPerRow>, N> rows{};
+        std::array<EdgeType, weighted ? N * N : 0> values{};
+        std::array<size_t, N> outDegrees{};
+        std::array<size_t, N> inDegrees{};
+        size_t numEdges = 0;
+
+        constexpr bool bit(size_t src, size_t dest) const
+        {
+            return (rows[src][dest / 64] >> (dest % 64)) & 1;
+        }
+
+        constexpr void setBit(size_t src, size_t dest, bool set)
+        {
+            uint64_t mask = uint64_t{1} << (dest % 64);
+            rows[src][dest / 64] = set ? rows[src][dest / 64] | mask : rows[src][dest / 64] & ~mask;
+        }
+
+        // undirected edges keep their value in the (min, max) cell.
+        static constexpr size_t valueIndex(size_t src, size_t dest)
+        {
+            if (!directed && src > dest)
+                return dest * N + src;
+            return src * N + dest;
+        }
+
+        static constexpr void checkVertex(size_t vertex)
+        {
+            if (vertex >= N)
+            {
+                throw std::out_of_range("Vertex index out of range");
+            }
+        }
+
+        static constexpr void checkVertices(size_t src, size_t dest)
+        {
+            if (src >= N || dest >= N)
+            {
+                throw std::out_of_range("Vertex index out of range");
+            }
+        }
+
+        // Repeatedly takes the smallest vertex with no remaining incoming edges.
+        constexpr StaticVertexList<N> kahn() const
+        {
+            std::array<size_t, N> remaining = inDegrees;
+            std::array<bool, N> done{};
+            StaticVertexList<N> order;
+            for (size_t round = 0; round < N; ++round)
+            {
+                size_t next = N;
+                for (size_t v = 0; v < N; ++v)
+                {
+                    if (!done[v] && remaining[v] == 0)
+                    {
+                        next = v;
+                        break;
+                    }
+                }
+                if (next == N)
+                    break;
+                done[next] = true;
+                order.push_back(next);
+                for (size_t dest : getNeighbors(next))
+                {
+                    --remaining[dest];
+                }
+            }
+            return order;
+        }
+    };
+
+    static_assert(AdjacencyMatrixGraph<StaticGraphMatrix<1, int, DirectedG>>);
+}
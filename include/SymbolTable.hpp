@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Appledore
+{
+    using SymbolId = std::uint32_t;
+    inline constexpr SymbolId noSymbol = std::numeric_limits<SymbolId>::max();
+
+    // String interning table. Every distinct name is stored exactly once in an append-only
+    // arena and identified by a dense SymbolId, so objects only carry a 4 byte id.
+    // Both directions are O(1): name(id) indexes a vector and find(name) hashes the
+    // std::string_view directly, without building a std::string for the query.
+    // Interned names are never released; views returned by name() stay valid for the
+    // lifetime of the table. All member functions are safe to call concurrently.
+    class SymbolTable
+    {
+    public:
+        SymbolTable() = default;
+        SymbolTable(const SymbolTable &) = delete;
+        SymbolTable &operator=(const SymbolTable &) = delete;
+
+        // Returns the id of name, adding it to the table if it is not present yet.
+        SymbolId intern(std::string_view name)
+        {
+            {
+                std::shared_lock lock(mutex);
+                auto it = ids.find(name);
+                if (it != ids.end())
+                    return it->second;
+            }
+
+            std::unique_lock lock(mutex);
+            auto it = ids.find(name);
+            if (it != ids.end())
+                return it->second;
+
+            if (names.size() >= noSymbol)
+                throw std::length_error("SymbolTable is full.");
+
+            std::string_view stored = store(name);
+            SymbolId id = static_cast<SymbolId>(names.size());
+            names.push_back(stored);
+            ids.emplace(stored, id);
+            return id;
+        }
+
+        [[nodiscard]] std::optional<SymbolId> find(std::string_view name) const
+        {
+            std::shared_lock lock(mutex);
+            auto it = ids.find(name);
+            if (it == ids.end())
+                return std::nullopt;
+            return it->second;
+        }
+
+        [[nodiscard]] std::string_view name(SymbolId id) const
+        {
+            std::shared_lock lock(mutex);
+            if (id >= names.size())
+                throw std::out_of_range("Unknown symbol id.");
+            return names[id];
+        }
+
+        [[nodiscard]] size_t size() const
+        {
+            std::shared_lock lock(mutex);
+            return names.size();
+        }
+
+        // Table the named GraphVertex/GraphEdge constructors use when they are not given
+        // one. It lives until the process exits; graphs own a table of their own
+        // (symbols()) whose names are released with the graph.
+        static SymbolTable &global()
+        {
+            static SymbolTable table;
+            return table;
+        }
+
+    private:
+        static constexpr size_t blockSize = 64 * 1024;
+
+        mutable std::shared_mutex mutex;
+        std::vector<std::unique_ptr<char[]>> blocks;
+        std::vector<std::unique_ptr<char[]>> largeNames;
+        size_t blockUsed = blockSize;
+        std::vector<std::string_view> names;
+        std::unordered_map<std::string_view, SymbolId> ids;
+
+        std::string_view store(std::string_view name)
+        {
+            if (name.empty())
+                return std::string_view{};
+
+            char *dest;
+            if (name.size() > blockSize / 4)
+            {
+                // long names get an allocation of their own so they don't waste the tail of a block.
+                largeNames.push_back(std::make_unique<char[]>(name.size()));
+                dest = largeNames.back().get();
+            }
+            else
+            {
+                if (blockSize - blockUsed < name.size())
+                {
+                    blocks.push_back(std::make_unique<char[]>(blockSize));
+                    blockUsed = 0;
+                }
+                dest = blocks.back().get() + blockUsed;
+                blockUsed += name.size();
+            }
+            std::memcpy(dest, name.data(), name.size());
+            return std::string_view(dest, name.size());
+        }
+    };
+}
@@ -1,3 +1,4 @@
+#pragma once
 #include <iostream>
 #include <random>
 #include <vector>
@@ -20,6 +21,14 @@ namespace Appledore {
         std::cout << colorCode << text << ANSI_COLOR_RESET << '\n';
     }
 
+    // Prints the result line of a test, failure is empty when it passed.
+    inline void reportTest(const std::string& test, const std::string& failure) {
+        if (failure.empty())
+            printColoredText("✔ " + test + "() PASSED!", ANSI_COLOR_GREEN);
+        else
+            printColoredText("✘ " + test + "() FAILED! \n\t" + failure, ANSI_COLOR_RED);
+    }
+
     template <typename T>
     class custom_vertex_1 : public GraphVertex {
         T vertex_name;
@@ -1,20 +1,66 @@
 #include "../include/GraphMatrix.hpp"
 #include <iostream>
 #include "tests_GraphMatrix.hpp"
+#include "tests_Concurrent.hpp"
+#include "tests_Serialization.hpp"
+#include "tests_EdgeList.hpp"
+#include "tests_MixedGraph.hpp"
+#include "tests_Storage.hpp"
+#include "tests_K2Tree.hpp"
+#include "tests_Lookups.hpp"
 
 int main(int argc, char *argv[])
 {
-    if (argc > 1 && std::string(argv[1]) == "graph-matrix")
+    std::string suite = argc > 1 ? argv[1] : "";
+    if (suite == "graph-matrix" || suite == "all")
     {
         Appledore::C_TestGraphMatrix tester;
         tester.create_graph();
         tester.init_tests();
-        tester.show_vertex_data();
+        if (suite == "graph-matrix")
+            tester.show_vertex_data();
     }
-    else
+    if (suite == "concurrent" || suite == "all")
     {
-        std::cout << "Usage: " << argv[0] << " graph-matrix" << std::endl;
+        Appledore::C_TestConcurrent tester;
+        tester.init_tests();
+    }
+    if (suite == "serialization" || suite == "all")
+    {
+        Appledore::C_TestSerialization tester;
+        tester.init_tests();
+    }
+    if (suite == "edge-list" || suite == "all")
+    {
+        Appledore::C_TestEdgeList tester;
+        tester.init_tests();
+    }
+    if (suite == "mixed-graph" || suite == "all")
+    {
+        Appledore::C_TestMixedGraph tester;
+        tester.init_tests();
+    }
+    if (suite == "storage" || suite == "all")
+    {
+        Appledore::C_TestStorage tester;
+        tester.init_tests();
+    }
+    if (suite == "k2-tree" || suite == "all")
+    {
+        Appledore::C_TestK2Tree tester;
+        tester.init_tests();
+    }
+    if (suite == "lookups" || suite == "all")
+    {
+        Appledore::C_TestLookups tester;
+        tester.init_tests();
+    }
+    if (suite != "graph-matrix" && suite != "concurrent" && suite != "serialization" && suite != "edge-list" && suite != "mixed-graph" &&
+        suite != "storage" && suite != "k2-tree" && suite != "lookups" &&
+        suite != "all")
+    {
+        std::cout << "Usage: " << argv[0] << " graph-matrix|concurrent|serialization|edge-list|mixed-graph|storage|k2-tree|lookups|all" << std::endl;
     }
 
     return 0;
-}
\ No newline at end of file
+}
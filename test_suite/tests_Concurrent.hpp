@@ -0,0 +1,201 @@
+#pragma once
+#include <atomic>
+#include <format>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../include/ConcurrentGraph.hpp"
+#include "../include/ConcurrentIngest.hpp"
+#include "graph_types.hpp"
+
+namespace Appledore
+{
+    // tests for the concurrent graph front ends.
+    class C_TestConcurrent
+    {
+    public:
+        static constexpr int numThreads = 4;
+
+        void test_ingestParallel()
+        {
+            std::vector<int> vertices;
+            for (int i = 0; i < 130; ++i)
+                vertices.push_back(i);
+            ConcurrentIngestGraph<int> graph(vertices);
+
+            // every thread adds the same edges, only one insert of each may succeed.
+            std::vector<size_t> inserted(numThreads, 0);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < numThreads; ++t)
+                threads.emplace_back([&, t]
+                                     {
+                                         for (size_t src = 0; src < 130; ++src)
+                                             for (size_t dest = src % 3; dest < 130; dest += 3)
+                                                 inserted[t] += graph.addEdgeAt(src, dest); });
+            for (auto &thread : threads)
+                thread.join();
+
+            size_t total = 0;
+            for (size_t count : inserted)
+                total += count;
+            size_t expected = 0;
+            for (size_t src = 0; src < 130; ++src)
+                expected += (130 - src % 3 + 2) / 3;
+            if (total != expected || graph.getNumEdges() != expected)
+                return reportTest("test_ingestParallel", std::format("Expected {} edges, inserted {}, counted {}", expected, total, graph.getNumEdges()));
+            if (graph.outdegree(64) != 43 || graph.indegree(0) != 44 || !graph.hasEdge(1, 127) || graph.hasEdge(1, 128))
+                return reportTest("test_ingestParallel", "Degrees or edges wrong after parallel ingestion");
+            reportTest("test_ingestParallel", "");
+        }
+
+        void test_ingestToGraphMatrix()
+        {
+            ConcurrentIngestGraph<int> graph({10, 20, 30, 40});
+            graph.addEdge(10, 20);
+            graph.addEdge(20, 40);
+            graph.addEdge(40, 10);
+            bool duplicate = graph.addEdge(10, 20);
+            bool removed = graph.removeEdge(20, 40);
+            bool removedTwice = graph.removeEdge(20, 40);
+            if (duplicate || !removed || removedTwice || graph.getNumEdges() != 2)
+                return reportTest("test_ingestToGraphMatrix", "addEdge/removeEdge did not report whether the edge changed");
+
+            auto matrix = graph.toGraphMatrix();
+            if (matrix.getVertices() != std::vector<int>{10, 20, 30, 40} || !matrix.hasEdge(10, 20) || !matrix.hasEdge(40, 10) ||
+                matrix.hasEdge(20, 40) || matrix.hasEdge(20, 10) || matrix.outdegree(10) != 1 || matrix.indegree(10) != 1)
+                return reportTest("test_ingestToGraphMatrix", "Converted GraphMatrix differs from the ingested edges");
+            reportTest("test_ingestToGraphMatrix", "");
+        }
+
+        // writers add disjoint edges while readers query; every edge must land once.
+        void test_sharedMutexMode()
+        {
+            GraphMatrix<int, int, DirectedG> base;
+            for (int i = 0; i < 100; ++i)
+                base.addVertex(i);
+            ConcurrentGraph<GraphMatrix<int, int, DirectedG>> graph(base);
+
+            std::atomic<bool> done{false};
+            std::atomic<size_t> inconsistent{0};
+            std::thread reader([&]
+                               {
+                                   while (!done.load())
+                                   {
+                                       // an edge i -> i + 1 is always added after i -> i.
+                                       graph.read([&](const auto &g)
+                                                  {
+                                                      for (int i = 0; i + 1 < 100; ++i)
+                                                          if (g.hasEdge(i, i + 1) && !g.hasEdge(i, i))
+                                                              ++inconsistent; });
+                                   } });
+            std::vector<std::thread> writers;
+            for (int t = 0; t < numThreads; ++t)
+                writers.emplace_back([&, t]
+                                     {
+                                         for (int i = t; i + 1 < 100; i += numThreads)
+                                             graph.write([i](auto &g)
+                                                         {
+                                                             g.addEdge(i, i, i);
+                                                             g.addEdge(i, i + 1, i); }); });
+            for (auto &writer : writers)
+                writer.join();
+            done = true;
+            reader.join();
+
+            size_t edges = graph.read([](const auto &g)
+                                      { return g.getAllEdges().size(); });
+            if (edges != 2 * 99 || inconsistent != 0)
+                return reportTest("test_sharedMutexMode", std::format("Expected 198 edges and no torn writes, got {} and {}", edges, inconsistent.load()));
+            reportTest("test_sharedMutexMode", "");
+        }
+
+        // a snapshot keeps the version it was taken from, through later writes and removals.
+        void test_snapshotIsolation()
+        {
+            GraphMatrix<int, int, DirectedG> base;
+            base.addVertices({1, 2, 3, 4});
+            base.addEdge(1, 2, 12);
+            base.addEdge(3, 4, 34);
+            ConcurrentGraph<GraphMatrix<int, int, DirectedG>, SnapshotMode> graph(base);
+
+            auto before = graph.snapshot();
+            graph.addEdge(2, 3, 23);
+            graph.updateEdge(1, 2, 120);
+            auto afterWrites = graph.snapshot();
+            graph.removeVertex(1);
+            auto afterRemoval = graph.snapshot();
+
+            if (before.versionNumber() != 0 || afterWrites.versionNumber() != 2 || afterRemoval.versionNumber() != 3 ||
+                graph.versionNumber() != 3)
+                return reportTest("test_snapshotIsolation", "Version numbers do not count the writes");
+            if (before->hasEdge(2, 3) || before->getEdge(1, 2) != 12 || before->getVertices().size() != 4)
+                return reportTest("test_snapshotIsolation", "Snapshot changed after later writes");
+            if (!afterWrites->hasEdge(2, 3) || afterWrites->getEdge(1, 2) != 120 || afterWrites->getVertices().size() != 4)
+                return reportTest("test_snapshotIsolation", "Snapshot changed after removeVertex");
+            if (afterRemoval->getVertices().size() != 3 || !afterRemoval->hasEdge(2, 3) || !afterRemoval->hasEdge(3, 4))
+                return reportTest("test_snapshotIsolation", "Snapshot after removeVertex is wrong");
+
+            // a throwing write publishes nothing.
+            try
+            {
+                graph.write([](auto &g)
+                            {
+                                g.addEdge(2, 4, 24);
+                                g.addEdge(2, 99, 0); });
+            }
+            catch (const std::invalid_argument &)
+            {
+            }
+            if (graph.versionNumber() != 3 || graph.hasEdge(2, 4))
+                return reportTest("test_snapshotIsolation", "A failed write was published");
+            reportTest("test_snapshotIsolation", "");
+        }
+
+        // readers running alongside writers only ever see whole versions.
+        void test_snapshotReaders()
+        {
+            GraphMatrix<int, int, DirectedG> base;
+            for (int i = 0; i < 70; ++i)
+                base.addVertex(i);
+            ConcurrentGraph<GraphMatrix<int, int, DirectedG>, SnapshotMode> graph(base);
+
+            std::atomic<bool> done{false};
+            std::atomic<size_t> torn{0};
+            std::vector<std::thread> readers;
+            for (int t = 0; t < numThreads; ++t)
+                readers.emplace_back([&]
+                                     {
+                                         uint64_t last = 0;
+                                         while (!done.load())
+                                         {
+                                             auto snapshot = graph.snapshot();
+                                             // version n holds exactly the edges 0 -> 1 .. 0 -> n.
+                                             uint64_t n = snapshot.versionNumber();
+                                             if (n < last || snapshot->outdegree(0) != n)
+                                                 ++torn;
+                                             last = n;
+                                             graph.read([&](const auto &g)
+                                                        {
+                                                            if (g.outdegree(0) < n)
+                                                                ++torn; });
+                                         } });
+            for (int i = 1; i < 70; ++i)
+                graph.addEdge(0, i, i);
+            done = true;
+            for (auto &reader : readers)
+                reader.join();
+            if (torn != 0 || graph.snapshot()->outdegree(0) != 69)
+                return reportTest("test_snapshotReaders", std::format("{} reads saw a partial or older version", torn.load()));
+            reportTest("test_snapshotReaders", "");
+        }
+
+        void init_tests()
+        {
+            test_ingestParallel();
+            test_ingestToGraphMatrix();
+            test_sharedMutexMode();
+            test_snapshotIsolation();
+            test_snapshotReaders();
+        }
+    };
+}
@@ -0,0 +1,309 @@
+#pragma once
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../include/EdgeListLoader.hpp"
+#include "../include/GraphExport.hpp"
+#include "graph_types.hpp"
+
+namespace Appledore
+{
+    // tests for loading and exporting edge lists.
+    class C_TestEdgeList
+    {
+    public:
+        std::string path = (std::filesystem::temp_directory_path() / "appledore_test_suite.edges").string();
+
+        void writeFile(const std::string &contents)
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file << contents;
+        }
+
+        // Flattens list into "src dest value" triples, in file order.
+        template <typename VertexType, typename EdgeType>
+        static std::vector<std::string> records(const EdgeList<VertexType, EdgeType> &list)
+        {
+            std::vector<std::string> result;
+            for (const auto &edge : list.edges)
+            {
+                std::ostringstream record;
+                record << edge.src << ' ' << edge.dest << ' ' << edge.value;
+                result.push_back(record.str());
+            }
+            return result;
+        }
+
+        void test_parseFormats()
+        {
+            // comments, blank lines, tabs and a missing weight, which reads as 1.
+            writeFile("# SNAP style\n1 2 0.5\n\n% another comment\n2\t3\n  3 1 -2.25  \n");
+            auto whitespace = readEdgeList<int, double>(path);
+            if (records(whitespace) != std::vector<std::string>{"1 2 0.5", "2 3 1", "3 1 -2.25"} ||
+                whitespace.vertices != std::vector<int>{1, 2, 3} || whitespace.symmetric)
+                return reportTest("test_parseFormats", "Whitespace list parsed wrong");
+
+            // a first line that is not numeric is a header, and is only skipped once.
+            writeFile("source,target,weight\n10,20,1.5\n20, 30 ,+2\n");
+            auto csv = readEdgeList<int, double>(path);
+            if (records(csv) != std::vector<std::string>{"10 20 1.5", "20 30 2"} || csv.vertices != std::vector<int>{10, 20, 30})
+                return reportTest("test_parseFormats", "CSV header was not skipped");
+            writeFile("10,20,1.5\n20,30,2\n");
+            if (records(readEdgeList<int, double>(path, {EdgeListFormat::CSV, 1})) != std::vector<std::string>{"10 20 1.5", "20 30 2"})
+                return reportTest("test_parseFormats", "CSV without header lost its first record");
+            writeFile("a,b\nb,c\n");
+            auto names = readEdgeList<std::string, UnweightedG>(path);
+            if (names.edges.size() != 2 || names.vertices != std::vector<std::string>{"a", "b", "c"})
+                return reportTest("test_parseFormats", "CSV of names was taken to have a header");
+
+            // symmetric Matrix Market: the size line is skipped and entries stand for both directions.
+            writeFile("%%MatrixMarket matrix coordinate real symmetric\n% comment\n3 3 3\n2 1 4.5\n3 1 1e2\n3 3 7\n");
+            auto market = readEdgeList<int, double>(path);
+            if (!market.symmetric || records(market) != std::vector<std::string>{"2 1 4.5", "3 1 100", "3 3 7"})
+                return reportTest("test_parseFormats", "Symmetric Matrix Market parsed wrong");
+            GraphMatrix<int, double, DirectedG> graph;
+            addEdgeList(graph, market);
+            if (graph.getEdge(1, 2) != 4.5 || graph.getEdge(2, 1) != 4.5 || graph.getEdge(1, 3) != 100 || graph.getEdge(3, 3) != 7)
+                return reportTest("test_parseFormats", "Symmetric Matrix Market was not added both ways");
+            writeFile("%%MatrixMarket matrix coordinate pattern general\n2 2 1\n1 2\n");
+            auto pattern = readEdgeList<int, int>(path);
+            if (pattern.symmetric || records(pattern) != std::vector<std::string>{"1 2 1"})
+                return reportTest("test_parseFormats", "Pattern Matrix Market parsed wrong");
+            reportTest("test_parseFormats", "");
+        }
+
+        void test_rejectMalformed()
+        {
+            const char *files[] = {
+                "1 2 0.5\n2 x 1\n",
+                "1,2,abc\n",
+                "1 2 3.5garbage\n",
+                "%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n4\n",
+            };
+            for (const char *contents : files)
+            {
+                writeFile(contents);
+                try
+                {
+                    (void)readEdgeList<int, double>(path);
+                    return reportTest("test_rejectMalformed", std::format("Accepted \"{}\"", contents));
+                }
+                catch (const std::runtime_error &)
+                {
+                }
+            }
+            reportTest("test_rejectMalformed", "");
+        }
+
+        // a file large enough to be split gives the same list on any number of threads.
+        void test_parseChunks()
+        {
+            std::ostringstream contents;
+            contents << "# header comment\n";
+            for (int i = 0; i < 300000; ++i)
+                contents << i % 5003 << ' ' << (i * 31) % 7919 << ' ' << i << '\n';
+            writeFile(contents.str());
+            auto single = readEdgeList<int, int>(path, {EdgeListFormat::Auto, 1});
+            auto parallel = readEdgeList<int, int>(path, {EdgeListFormat::Auto, 4});
+            if (single.edges.size() != 300000 || single.edges[299999].value != 299999 || single.vertices.size() != 7919)
+                return reportTest("test_parseChunks", "Single threaded parse is wrong");
+            if (records(parallel) != records(single) || parallel.vertices != single.vertices)
+                return reportTest("test_parseChunks", "Parallel parse differs from the single threaded one");
+            reportTest("test_parseChunks", "");
+        }
+
+        // Export a graph with write, load it back and compare every vertex pair; vertex v of
+        // graph is expected as loadedVertex(v).
+        template <typename Graph, typename Loaded, typename Write, typename LoadedVertex>
+        std::string roundTripFailure(const Graph &graph, Loaded &loaded, Write write, LoadedVertex loadedVertex)
+        {
+            {
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                write(graph, file);
+            }
+            loadEdgeList(loaded, path);
+            for (const auto &src : graph.getVertices())
+                for (const auto &dest : graph.getVertices())
+                {
+                    bool present = graph.hasEdge(src, dest);
+                    if (loaded.hasEdge(loadedVertex(src), loadedVertex(dest)) != present)
+                        return std::format("edge {} -> {} present: {}", src, dest, !present);
+                    if constexpr (detail::weightedGraph<Graph>)
+                        if (present && loaded.getEdgeAt(loaded.getIndexOf(loadedVertex(src)), loaded.getIndexOf(loadedVertex(dest))) !=
+                                           graph.getEdgeAt(graph.getIndexOf(src), graph.getIndexOf(dest)))
+                            return std::format("edge {} -> {} changed its value", src, dest);
+                }
+            return "";
+        }
+
+        void test_exportRoundTrip()
+        {
+            auto writeEdges = [](const auto &graph, std::ostream &out)
+            { writeEdgeList(graph, out); };
+            auto writeMarket = [](const auto &graph, std::ostream &out)
+            { writeMatrixMarket(graph, out); };
+            auto same = [](int v)
+            { return v; };
+            // Matrix Market rows are 1-based positions in getVertices(), which is 0, 1, ... here.
+            auto oneBased = [](int v)
+            { return v + 1; };
+
+            // values that only survive with shortest round trip formatting.
+            GraphMatrix<int, double, DirectedG> directed;
+            for (int i = 0; i < 70; ++i)
+                directed.addVertex(i);
+            for (int i = 0; i < 70; ++i)
+            {
+                directed.addEdge(i, (i * 11 + 5) % 70, i / 3.0);
+                directed.addEdge(i, (i * 17 + 1) % 70, -1e-300 * i);
+            }
+            GraphMatrix<int, double, DirectedG> fromEdges, fromMarket;
+            if (std::string failure = roundTripFailure(directed, fromEdges, writeEdges, same); !failure.empty())
+                return reportTest("test_exportRoundTrip", "directed edge list: " + failure);
+            if (std::string failure = roundTripFailure(directed, fromMarket, writeMarket, oneBased); !failure.empty())
+                return reportTest("test_exportRoundTrip", "directed Matrix Market: " + failure);
+
+            // undirected graphs are written once per edge, as a symmetric Matrix Market file.
+            GraphMatrix<int, int, UndirectedG> undirected;
+            for (int i = 0; i < 40; ++i)
+                undirected.addVertex(i);
+            for (int i = 0; i < 40; ++i)
+                undirected.addEdge(i, (i * 7) % 40, i + 1);
+            GraphMatrix<int, int, UndirectedG> undirectedEdges, undirectedMarket;
+            if (std::string failure = roundTripFailure(undirected, undirectedEdges, writeEdges, same); !failure.empty())
+                return reportTest("test_exportRoundTrip", "undirected edge list: " + failure);
+            if (std::string failure = roundTripFailure(undirected, undirectedMarket, writeMarket, oneBased); !failure.empty())
+                return reportTest("test_exportRoundTrip", "undirected Matrix Market: " + failure);
+            if (!readEdgeList<int, int>(path).symmetric)
+                return reportTest("test_exportRoundTrip", "Undirected graph was not written as symmetric");
+
+            // unweighted graphs become pattern files, string vertices stay names.
+            GraphMatrix<std::string, UnweightedG, DirectedG> pattern;
+            pattern.addVertices({"a", "b", "c"});
+            pattern.addEdge("a", "b");
+            pattern.addEdge("c", "a");
+            pattern.addEdge("c", "c");
+            GraphMatrix<std::string, UnweightedG, DirectedG> names;
+            if (std::string failure = roundTripFailure(pattern, names, writeEdges, [](const std::string &v)
+                                                       { return v; });
+                !failure.empty())
+                return reportTest("test_exportRoundTrip", "unweighted edge list: " + failure);
+            GraphMatrix<int, UnweightedG, DirectedG> positions;
+            if (std::string failure = roundTripFailure(pattern, positions, writeMarket, [&](const std::string &v)
+                                                       { return static_cast<int>(pattern.getIndexOf(v)) + 1; });
+                !failure.empty())
+                return reportTest("test_exportRoundTrip", "pattern Matrix Market: " + failure);
+
+            // undirected edges of a mixed graph come back in both directions.
+            MixedGraphMatrix<int, int> mixed;
+            mixed.addVertices({1, 2, 3});
+            mixed.addEdge(1, 2, 12, true);
+            mixed.addEdge(2, 3, 23, false);
+            GraphMatrix<int, int, DirectedG> fromMixed;
+            if (std::string failure = roundTripFailure(mixed, fromMixed, writeEdges, same); !failure.empty())
+                return reportTest("test_exportRoundTrip", "mixed edge list: " + failure);
+            reportTest("test_exportRoundTrip", "");
+        }
+
+        void test_exportEscaping()
+        {
+            GraphMatrix<std::string, std::string, DirectedG> graph;
+            graph.addVertices({"a<b & \"c\"", "back\\slash"});
+            graph.addEdge("a<b & \"c\"", "back\\slash", "it's");
+            std::ostringstream graphML, dot;
+            writeGraphML(graph, graphML);
+            writeDot(graph, dot);
+            if (graphML.str().find(">a&lt;b &amp; &quot;c&quot;</data>") == std::string::npos ||
+                graphML.str().find(">it&apos;s</data>") == std::string::npos)
+                return reportTest("test_exportEscaping", "GraphML labels are not escaped");
+            if (dot.str().find("[label=\"a<b & \\\"c\\\"\"]") == std::string::npos ||
+                dot.str().find("[label=\"back\\\\slash\"]") == std::string::npos || dot.str().find("n0 -> n1") == std::string::npos)
+                return reportTest("test_exportEscaping", "DOT labels are not escaped");
+            reportTest("test_exportEscaping", "");
+        }
+
+        // A mixed pair with one directed and one undirected half is written as two edges.
+        void test_exportHalfUndirected()
+        {
+            MixedGraphMatrix<int, int> graph;
+            graph.addVertices({0, 1, 2, 3});
+            graph.addEdge(0, 1, 5, false);
+            graph.addEdge(0, 1, 7, true);
+            graph.addEdge(3, 2, 23, false);
+            graph.addEdge(3, 2, 8, true);
+            std::ostringstream graphML, dot;
+            writeGraphML(graph, graphML);
+            writeDot(graph, dot);
+            for (const char *edge : {"n0 -> n1 [label=\"7\"];", "n1 -> n0 [label=\"5\", dir=none];", "n3 -> n2 [label=\"8\"];",
+                                     "n2 -> n3 [label=\"23\", dir=none];"})
+                if (dot.str().find(edge) == std::string::npos)
+                    return reportTest("test_exportHalfUndirected", std::format("DOT lacks {}", edge));
+            for (const char *edge : {"source=\"n0\" target=\"n1\"><data key=\"weight\">7<",
+                                     "source=\"n1\" target=\"n0\" directed=\"false\"><data key=\"weight\">5<",
+                                     "source=\"n2\" target=\"n3\" directed=\"false\"><data key=\"weight\">23<"})
+                if (graphML.str().find(edge) == std::string::npos)
+                    return reportTest("test_exportHalfUndirected", std::format("GraphML lacks {}", edge));
+
+            // the edge list, with both directions of undirected edges, keeps all four cells.
+            GraphMatrix<int, int, DirectedG> loaded;
+            if (std::string failure = roundTripFailure(graph, loaded, [](const auto &g, std::ostream &out)
+                                                       { writeEdgeList(g, out); },
+                                                       [](int v)
+                                                       { return v; });
+                !failure.empty())
+                return reportTest("test_exportHalfUndirected", "edge list: " + failure);
+            reportTest("test_exportHalfUndirected", "");
+        }
+
+        void test_addEdgeList()
+        {
+            EdgeList<int, double> list;
+            list.vertices = {1, 5, 9, 70};
+            list.edges = {{1, 5, 1.5}, {9, 70, 9.5}, {70, 1, 70.5}};
+
+            // 5 is already in the graph with another index than in the list.
+            GraphMatrix<int, double, DirectedG> graph;
+            graph.addVertices({100, 5});
+            graph.addEdge(100, 5, 0.5);
+            addEdgeList(graph, list);
+            if (graph.getVertices() != std::vector<int>{100, 5, 1, 9, 70} || graph.getEdge(1, 5) != 1.5 ||
+                graph.getEdge(9, 70) != 9.5 || graph.getEdge(70, 1) != 70.5 || graph.getEdge(100, 5) != 0.5 ||
+                graph.hasEdge(5, 1) || graph.outdegree(5) != 0)
+                return reportTest("test_addEdgeList", "Edges were added between the wrong vertices");
+
+            list.symmetric = true;
+            GraphMatrix<int, double, DirectedG> symmetric;
+            addEdgeList(symmetric, list);
+            if (symmetric.getEdge(5, 1) != 1.5 || symmetric.getEdge(1, 70) != 70.5 || symmetric.outdegree(70) != 2)
+                return reportTest("test_addEdgeList", "Symmetric list was not added in both directions");
+
+            MixedGraphMatrix<int, double> mixed;
+            mixed.addVertex(9);
+            addEdgeList(mixed, list);
+            if (mixed.getEdgeValue(70, 9) != 9.5 || mixed.isDirectedAt(mixed.getIndexOf(9), mixed.getIndexOf(70)))
+                return reportTest("test_addEdgeList", "Symmetric list was not added as undirected edges");
+            list.symmetric = false;
+            MixedGraphMatrix<int, double> directed;
+            addEdgeList(directed, list);
+            if (!directed.hasEdge(1, 5) || directed.hasEdge(5, 1))
+                return reportTest("test_addEdgeList", "Non symmetric list was not added as directed edges");
+            reportTest("test_addEdgeList", "");
+        }
+
+        void init_tests()
+        {
+            test_parseFormats();
+            test_rejectMalformed();
+            test_parseChunks();
+            test_addEdgeList();
+            test_exportRoundTrip();
+            test_exportEscaping();
+            test_exportHalfUndirected();
+            std::filesystem::remove(path);
+        }
+    };
+}
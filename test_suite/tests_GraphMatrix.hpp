@@ -1,5 +1,6 @@
 #include <iostream>
 #include <random>
+#include <set>
 #include <vector>
 #include "../include/GraphMatrix.hpp"
 #include "graph_types.hpp"
@@ -116,12 +117,119 @@ namespace Appledore
             }
             printColoredText("✔ test_getVertices() PASSED!", ANSI_COLOR_GREEN);
         }
+        void test_removeVertices()
+        {
+            auto graph = ggraph;
+            graph.removeVertices(std::vector<custom_vertex_1<std::string>>{v3, v8});
+
+            std::vector<custom_vertex_1<std::string>> true_remaining = {v1, v2, v4, v5, v6, v7};
+            if (graph.getVertices() != true_remaining)
+            {
+                printColoredText("✘ test_removeVertices() FAILED! \n\tUnexpected surviving vertices", ANSI_COLOR_RED);
+                return;
+            }
+            if (!graph.hasEdge(v1, v2) || !graph.hasEdge(v6, v7) || graph.hasEdge(v2, v7) || graph.getEdge(v1, v4) != 19)
+            {
+                printColoredText("✘ test_removeVertices() FAILED! \n\tEdges between surviving vertices were not preserved", ANSI_COLOR_RED);
+                return;
+            }
+            if (graph.totalDegree(v5) != 0 || graph.totalDegree(v1) != 2)
+            {
+                printColoredText("✘ test_removeVertices() FAILED! \n\tEdges to removed vertices still present", ANSI_COLOR_RED);
+                return;
+            }
+            printColoredText("✔ test_removeVertices() PASSED!", ANSI_COLOR_GREEN);
+        }
+        void test_addVertexKeepsEdges()
+        {
+            auto graph = ggraph;
+            custom_vertex_1<std::string> v9("vertex_9");
+            graph.addVertex(v9);
+            for (const auto &edge : true_edges)
+            {
+                if (!graph.hasEdge(edge.first, edge.second))
+                {
+                    printColoredText(std::format("✘ test_addVertexKeepsEdges() FAILED! \n\tLost edge: {} -> {}", edge.first.get_vertex_name(), edge.second.get_vertex_name()), ANSI_COLOR_RED);
+                    return;
+                }
+            }
+            if (graph.getEdge(v8, v6) != 92 || graph.getEdge(v1, v4) != 19 || graph.totalDegree(v9) != 0)
+            {
+                printColoredText("✘ test_addVertexKeepsEdges() FAILED! \n\tEdges moved when the matrix grew", ANSI_COLOR_RED);
+                return;
+            }
+            printColoredText("✔ test_addVertexKeepsEdges() PASSED!", ANSI_COLOR_GREEN);
+        }
+        void test_updateEdge()
+        {
+            auto graph = ggraph;
+            graph.updateEdge(v8, v6, 7);
+            if (graph.getEdge(v8, v6) != 7 || graph.getEdge(v6, v8) != 7)
+            {
+                printColoredText(std::format("✘ test_updateEdge() FAILED! \n\t Expected: 7 both ways, Got: {} and {}", graph.getEdge(v8, v6), graph.getEdge(v6, v8)), ANSI_COLOR_RED);
+                return;
+            }
+            printColoredText("✔ test_updateEdge() PASSED!", ANSI_COLOR_GREEN);
+        }
+        void test_findByName()
+        {
+            auto graph = ggraph;
+            const auto *found = graph.findByName(v3.name());
+            if (!found || !(*found == v3) || graph.findByName("no_such_vertex"))
+            {
+                printColoredText("✘ test_findByName() FAILED! \n\tName lookup did not return the vertex", ANSI_COLOR_RED);
+                return;
+            }
+            graph.removeVertices(std::vector<custom_vertex_1<std::string>>{v3});
+            if (graph.findByName(v3.name()) || !graph.findByName(v8.name()) || !(*graph.findByName(v8.name()) == v8))
+            {
+                printColoredText("✘ test_findByName() FAILED! \n\tName lookup wrong after vertex removal", ANSI_COLOR_RED);
+                return;
+            }
+            printColoredText("✔ test_findByName() PASSED!", ANSI_COLOR_GREEN);
+        }
+        // AdjacencyMatrixGraph queries must agree with the vertex level ones.
+        template <AdjacencyMatrixGraph Graph>
+        static bool indexQueriesMatch(const Graph &graph)
+        {
+            for (size_t i = 0; i < graph.getNumVertices(); ++i)
+            {
+                const auto &vertex = graph.getVertexAt(i);
+                std::set<size_t> neighbors;
+                for (const auto &neighbor : graph.getNeighbors(vertex))
+                    neighbors.insert(graph.getIndexOf(neighbor));
+                std::vector<size_t> listed = graph.getNeighborsAt(i);
+                if (graph.outdegreeAt(i) != graph.outdegree(vertex) || graph.indegreeAt(i) != graph.indegree(vertex) ||
+                    listed != std::vector<size_t>(neighbors.begin(), neighbors.end()))
+                    return false;
+            }
+            return true;
+        }
+        void test_indexQueries()
+        {
+            GraphMatrix<int, int, DirectedG> directed;
+            directed.addVertices({1, 2, 3, 4});
+            directed.addEdge(1, 2, 1);
+            directed.addEdge(3, 2, 1);
+            directed.addEdge(4, 4, 1);
+            if (!indexQueriesMatch(ggraph) || !indexQueriesMatch(directed))
+            {
+                printColoredText("✘ test_indexQueries() FAILED! \n\tIndex level degrees or neighbors differ", ANSI_COLOR_RED);
+                return;
+            }
+            printColoredText("✔ test_indexQueries() PASSED!", ANSI_COLOR_GREEN);
+        }
         void init_tests()
         {
             test_totalDegree();
             test_getNeighbors();
             test_hasEdge();
             test_getVertices();
+            test_removeVertices();
+            test_addVertexKeepsEdges();
+            test_updateEdge();
+            test_findByName();
+            test_indexQueries();
         }
         void show_vertex_data()
         {
@@ -0,0 +1,143 @@
+#pragma once
+#include <format>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../include/GraphMatrix.hpp"
+#include "../include/K2Tree.hpp"
+#include "graph_types.hpp"
+
+namespace Appledore
+{
+    // tests for K2TreeGraph against the GraphMatrix it was built from.
+    class C_TestK2Tree
+    {
+    public:
+        // Empty when tree answers every query as graph does, otherwise the first difference.
+        template <typename Tree, typename Graph>
+        static std::string compare(const Tree &tree, const Graph &graph)
+        {
+            size_t n = graph.getNumVertices();
+            if (tree.getNumVertices() != n || tree.getVertices() != graph.getVertices())
+                return "vertex lists differ";
+            size_t edges = 0;
+            for (size_t src = 0; src < n; ++src)
+            {
+                std::vector<size_t> out, in;
+                for (size_t other = 0; other < n; ++other)
+                {
+                    if (tree.hasEdgeAt(src, other) != graph.hasEdgeAt(src, other))
+                        return std::format("hasEdgeAt({}, {}) differs", src, other);
+                    if (graph.hasEdgeAt(src, other))
+                        out.push_back(other);
+                    if (graph.hasEdgeAt(other, src))
+                        in.push_back(other);
+                }
+                edges += out.size();
+                const auto &vertex = graph.getVertexAt(src);
+                if (tree.getOutNeighborsAt(src) != out || tree.getInNeighborsAt(src) != in || tree.outdegree(vertex) != out.size() ||
+                    tree.indegree(vertex) != in.size() || tree.getIndexOf(vertex) != src)
+                    return std::format("neighbors of {} differ", src);
+            }
+            if (tree.getNumEdges() != edges)
+                return std::format("{} edges, source graph has {}", tree.getNumEdges(), edges);
+            return "";
+        }
+
+        // Random directed graph of n vertices with about degree edges per vertex, denser
+        // near the diagonal like the clustered graphs the tree is meant for.
+        static GraphMatrix<int, int, DirectedG> randomGraph(int n, int degree, unsigned seed)
+        {
+            GraphMatrix<int, int, DirectedG> graph;
+            for (int v = 0; v < n; ++v)
+                graph.addVertex(v * 3);
+            std::mt19937 rng(seed);
+            for (int e = 0; n > 0 && e < n * degree; ++e)
+            {
+                int src = static_cast<int>(rng() % n);
+                int dest = rng() % 2 ? static_cast<int>(rng() % n) : (src + static_cast<int>(rng() % 5)) % n;
+                graph.addEdge(src * 3, dest * 3, e);
+            }
+            return graph;
+        }
+
+        template <unsigned K>
+        std::string sizesFailure()
+        {
+            // sizes below, at and past powers of K, and an empty graph.
+            for (int n : {0, 1, 2, 3, 8, 9, 17, 64, 65, 130})
+            {
+                auto graph = randomGraph(n, 3, 36 + n);
+                if (std::string failure = compare(K2TreeGraph<int, K>(graph), graph); !failure.empty())
+                    return std::format("K = {}, {} vertices: {}", K, n, failure);
+            }
+            return "";
+        }
+
+        void test_matchesSource()
+        {
+            for (std::string failure : {sizesFailure<2>(), sizesFailure<3>(), sizesFailure<4>()})
+                if (!failure.empty())
+                    return reportTest("test_matchesSource", failure);
+
+            // undirected graphs keep each edge in both directions.
+            GraphMatrix<std::string, UnweightedG, UndirectedG> undirected;
+            undirected.addVertices({"a", "b", "c", "d", "e"});
+            undirected.addEdge("a", "b");
+            undirected.addEdge("c", "b");
+            undirected.addEdge("d", "d");
+            K2TreeGraph<std::string> tree(undirected);
+            if (std::string failure = compare(tree, undirected); !failure.empty())
+                return reportTest("test_matchesSource", "undirected: " + failure);
+            if (tree.getInNeighbors("b") != std::vector<std::string>{"a", "c"} || tree.getOutNeighbors("e").size() != 0)
+                return reportTest("test_matchesSource", "Undirected neighbors by vertex are wrong");
+            reportTest("test_matchesSource", "");
+        }
+
+        void test_edgeStream()
+        {
+            // duplicates are merged, the order of the stream does not matter.
+            K2TreeGraph<int, 3> tree({10, 20, 30, 40}, {{3, 0}, {0, 1}, {3, 0}, {1, 1}, {0, 1}, {2, 3}});
+            if (tree.getNumEdges() != 4 || !tree.hasEdge(40, 10) || !tree.hasEdge(20, 20) || tree.hasEdge(10, 40) ||
+                tree.getOutNeighborsAt(0) != std::vector<size_t>{1} || tree.getInNeighborsAt(0) != std::vector<size_t>{3})
+                return reportTest("test_edgeStream", "Tree built from an edge stream is wrong");
+
+            bool duplicateVertex = false, badIndex = false, badQuery = false;
+            try
+            {
+                K2TreeGraph<int> duplicate({1, 1}, {});
+            }
+            catch (const std::invalid_argument &)
+            {
+                duplicateVertex = true;
+            }
+            try
+            {
+                K2TreeGraph<int> outside({1, 2}, {{0, 2}});
+            }
+            catch (const std::out_of_range &)
+            {
+                badIndex = true;
+            }
+            try
+            {
+                (void)tree.hasEdgeAt(0, 4);
+            }
+            catch (const std::out_of_range &)
+            {
+                badQuery = true;
+            }
+            if (!duplicateVertex || !badIndex || !badQuery)
+                return reportTest("test_edgeStream", "Invalid vertices or indices were accepted");
+            reportTest("test_edgeStream", "");
+        }
+
+        void init_tests()
+        {
+            test_matchesSource();
+            test_edgeStream();
+        }
+    };
+}
@@ -0,0 +1,307 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../include/GraphExceptions.hpp"
+#include "../include/GraphMatrix.hpp"
+#include "../include/MixedGraph.hpp"
+#include "graph_types.hpp"
+
+namespace Appledore
+{
+    // tests for the non-throwing lookups and for vertex handles.
+    class C_TestLookups
+    {
+    public:
+        // graph holds the vertices 1, 2, 3 and only the edge 1 -> 2 with value 12; 8 and 9
+        // are not vertices. Empty when every try* member answers as documented.
+        template <typename Graph>
+        static std::string tryFailure(Graph &graph)
+        {
+            if (!graph.tryHasEdge(1, 2) || !*graph.tryHasEdge(1, 2) || *graph.tryHasEdge(1, 3))
+                return "tryHasEdge on existing vertices";
+            if (graph.tryHasEdge(9, 2).error() != GraphError::SourceNotFound || graph.tryHasEdge(1, 9).error() != GraphError::TargetNotFound ||
+                graph.tryHasEdge(8, 9).error() != GraphError::SourceNotFound)
+                return "tryHasEdge on missing vertices";
+
+            // the reference points at the stored value, as findEdge does.
+            auto edge = graph.tryGetEdge(1, 2);
+            if (!edge || *edge != 12 || &*edge != graph.findEdge(1, 2) || graph.tryGetEdge(2, 3).error() != GraphError::EdgeNotFound ||
+                graph.tryGetEdge(2, 9).error() != GraphError::TargetNotFound || graph.tryGetEdge(2, 3).value_or(-1) != -1)
+                return "tryGetEdge";
+            if (graph.findEdge(2, 3) || graph.findEdge(9, 1) || graph.findEdge(1, 9))
+                return "findEdge of a missing edge or vertex is not nullptr";
+
+            if (graph.tryUpdateEdge(2, 3, 5).error() != GraphError::EdgeNotFound || graph.tryUpdateEdge(9, 3, 5).error() != GraphError::SourceNotFound ||
+                !graph.tryUpdateEdge(1, 2, 120) || *graph.findEdge(1, 2) != 120)
+                return "tryUpdateEdge";
+
+            if (*graph.tryOutdegree(1) != graph.outdegree(1) || *graph.tryIndegree(2) != graph.indegree(2) ||
+                *graph.tryTotalDegree(3) != graph.totalDegree(3) || graph.tryOutdegree(9).error() != GraphError::VertexNotFound ||
+                graph.tryIndegree(9).error() != GraphError::VertexNotFound || graph.tryTotalDegree(9).error() != GraphError::VertexNotFound)
+                return "try degrees";
+            if (*graph.tryGetIndexOf(3) != graph.getIndexOf(3) || graph.tryGetIndexOf(9).error() != GraphError::VertexNotFound)
+                return "tryGetIndexOf";
+
+            // removing twice reports the second time, where removeEdge would stay silent.
+            if (graph.tryRemoveEdge(1, 9).error() != GraphError::TargetNotFound || !graph.tryRemoveEdge(1, 2) ||
+                graph.tryRemoveEdge(1, 2).error() != GraphError::EdgeNotFound || graph.hasEdge(1, 2))
+                return "tryRemoveEdge";
+            return "";
+        }
+
+        void test_tryLookups()
+        {
+            GraphMatrix<int, int, DirectedG> directed;
+            directed.addVertices({1, 2, 3});
+            directed.addEdge(1, 2, 12);
+            if (std::string failure = tryFailure(directed); !failure.empty())
+                return reportTest("test_tryLookups", "directed GraphMatrix: " + failure);
+            if (*directed.tryIndegree(1) != 0)
+                return reportTest("test_tryLookups", "directed GraphMatrix: tryIndegree counts out edges");
+
+            // tryHasEdge(2, 1) finds the undirected edge stored once.
+            GraphMatrix<int, int, UndirectedG> undirected;
+            undirected.addVertices({1, 2, 3});
+            undirected.addEdge(2, 1, 12);
+            if (!*undirected.tryHasEdge(2, 1))
+                return reportTest("test_tryLookups", "undirected GraphMatrix: edge not found in reverse");
+            if (std::string failure = tryFailure(undirected); !failure.empty())
+                return reportTest("test_tryLookups", "undirected GraphMatrix: " + failure);
+
+            MixedGraphMatrix<int, int> mixed;
+            mixed.addVertices({1, 2, 3});
+            mixed.addEdge(1, 2, 12, true);
+            if (std::string failure = tryFailure(mixed); !failure.empty())
+                return reportTest("test_tryLookups", "MixedGraphMatrix: " + failure);
+            reportTest("test_tryLookups", "");
+        }
+
+        // The error codes turn into the same exceptions and messages as the throwing API.
+        void test_graphErrors()
+        {
+            if (graphErrorMessage(GraphError::SourceNotFound, 4, 5) != "Vertex not found: 4" ||
+                graphErrorMessage(GraphError::TargetNotFound, 4, 5) != "Vertex not found: 5" ||
+                graphErrorMessage(GraphError::EdgeNotFound, 4, 5) != "Edge not found between vertices: 4 -> 5" ||
+                graphErrorMessage(GraphError::VertexNotFound, std::string("v")) != "Vertex not found: v")
+                return reportTest("test_graphErrors", "graphErrorMessage formats the wrong message");
+
+            bool vertexThrown = false, edgeThrown = false;
+            try
+            {
+                throwGraphError(GraphError::TargetNotFound, std::string("a"), std::string("b"));
+            }
+            catch (const VertexNotFoundException &error)
+            {
+                vertexThrown = error.message() == "Vertex not found: b";
+            }
+            try
+            {
+                throwGraphError(GraphError::EdgeNotFound, 1, 2);
+            }
+            catch (const EdgeNotFoundException &error)
+            {
+                edgeThrown = error.sourceId() == "1" && error.targetId() == "2";
+            }
+            if (!vertexThrown || !edgeThrown)
+                return reportTest("test_graphErrors", "throwGraphError throws the wrong exception");
+            reportTest("test_graphErrors", "");
+        }
+
+        // Message of the std::invalid_argument thrown by func, empty if none is thrown.
+        template <typename Func>
+        static std::string invalidMessage(Func func)
+        {
+            try
+            {
+                func();
+            }
+            catch (const std::invalid_argument &error)
+            {
+                return error.what();
+            }
+            return "";
+        }
+
+        // Both graphs report a missing vertex through the shared getIndexOf.
+        void test_missingVertex()
+        {
+            GraphMatrix<int, int, DirectedG> directed;
+            GraphMatrix<int, int, UndirectedG> undirected;
+            MixedGraphMatrix<int, int> mixed;
+            const std::string expected = invalidMessage([&]
+                                                        { (void)directed.getIndexOf(9); });
+            const std::string messages[] = {
+                invalidMessage([&]
+                               { (void)directed.indegree(9); }),
+                invalidMessage([&]
+                               { (void)directed.totalDegree(9); }),
+                invalidMessage([&]
+                               { (void)undirected.outdegree(9); }),
+                invalidMessage([&]
+                               { (void)undirected.getNeighbors(9); }),
+                invalidMessage([&]
+                               { (void)mixed.getIndexOf(9); }),
+                invalidMessage([&]
+                               { (void)mixed.indegree(9); }),
+                invalidMessage([&]
+                               { (void)mixed.outdegree(9); }),
+                invalidMessage([&]
+                               { (void)mixed.totalDegree(9); }),
+            };
+            if (expected.empty())
+                return reportTest("test_missingVertex", "getIndexOf did not throw std::invalid_argument");
+            for (const std::string &message : messages)
+                if (message != expected)
+                    return reportTest("test_missingVertex", std::format("\"{}\" instead of \"{}\"", message, expected));
+            reportTest("test_missingVertex", "");
+        }
+
+        template <typename Func>
+        static bool throwsInvalid(Func func)
+        {
+            try
+            {
+                func();
+            }
+            catch (const std::invalid_argument &)
+            {
+                return true;
+            }
+            return false;
+        }
+
+        // Empty when every live handle resolves to its vertex and agrees with the by-vertex
+        // queries on every pair.
+        template <typename Graph>
+        static std::string handlesFailure(const Graph &graph, const std::vector<int> &vertices, const std::vector<VertexHandle> &handles)
+        {
+            for (size_t i = 0; i < handles.size(); ++i)
+            {
+                if (!graph.isValid(handles[i]) || graph.getVertex(handles[i]) != vertices[i] ||
+                    graph.getIndexOf(handles[i]) != graph.getIndexOf(vertices[i]) || graph.handleOf(vertices[i]) != handles[i])
+                    return std::format("handle of {} does not resolve to it", vertices[i]);
+                for (size_t j = 0; j < handles.size(); ++j)
+                    if (graph.hasEdge(handles[i], handles[j]) != graph.hasEdge(vertices[i], vertices[j]) ||
+                        graph(handles[i], handles[j]) != graph.hasEdge(vertices[i], vertices[j]))
+                        return std::format("edge {} -> {} differs by handle", vertices[i], vertices[j]);
+            }
+            return "";
+        }
+
+        // Empty when every handle overload rejects the stale handle.
+        template <typename Graph>
+        static std::string staleFailure(Graph &graph, VertexHandle stale, VertexHandle live)
+        {
+            if (graph.isValid(stale) || graph(stale, live) || graph(live, stale) || graph.findEdge(stale, live) || graph.findEdge(live, stale))
+                return "stale handle answered a query";
+            if (!throwsInvalid([&]
+                               { (void)graph.getIndexOf(stale); }) ||
+                !throwsInvalid([&]
+                               { (void)graph.hasEdge(live, stale); }) ||
+                !throwsInvalid([&]
+                               { graph.addEdge(stale, live, 1); }) ||
+                !throwsInvalid([&]
+                               { graph.removeEdge(live, stale); }) ||
+                !throwsInvalid([&]
+                               { graph.updateEdge(stale, live, 1); }) ||
+                !throwsInvalid([&]
+                               { (void)graph.outdegree(stale); }) ||
+                !throwsInvalid([&]
+                               { (void)graph.totalDegree(stale); }) ||
+                !throwsInvalid([&]
+                               { graph.removeVertex(stale); }))
+                return "stale handle was accepted by a throwing overload";
+            return "";
+        }
+
+        void test_staleHandles()
+        {
+            GraphMatrix<int, int, DirectedG> graph;
+            std::vector<int> vertices;
+            std::vector<VertexHandle> handles;
+            for (int v = 0; v < 70; ++v)
+            {
+                graph.addVertex(v);
+                vertices.push_back(v);
+                handles.push_back(graph.handleOf(v));
+            }
+            for (size_t i = 0; i < 70; ++i)
+                graph.addEdge(handles[i], handles[(i * 5 + 1) % 70], static_cast<int>(i));
+
+            // the last vertex moves into the removed index, its handle follows it.
+            VertexHandle removed = handles[10];
+            graph.removeVertex(removed);
+            vertices.erase(vertices.begin() + 10);
+            handles.erase(handles.begin() + 10);
+            if (graph.getIndexOf(handles.back()) != 10)
+                return reportTest("test_staleHandles", "removeVertex did not move the last vertex");
+            if (std::string failure = handlesFailure(graph, vertices, handles); !failure.empty())
+                return reportTest("test_staleHandles", "after removeVertex: " + failure);
+            if (std::string failure = staleFailure(graph, removed, handles[0]); !failure.empty())
+                return reportTest("test_staleHandles", "after removeVertex: " + failure);
+
+            // a new vertex reuses the slot under a new generation.
+            graph.addVertex(1000);
+            VertexHandle reused = graph.handleOf(1000);
+            if (reused.slot != removed.slot || reused == removed || !graph.isValid(reused))
+                return reportTest("test_staleHandles", "Slot was not reused under a new generation");
+            if (std::string failure = staleFailure(graph, removed, reused); !failure.empty())
+                return reportTest("test_staleHandles", "after slot reuse: " + failure);
+
+            // bulk removal compacts the rest, and stales every removed handle.
+            auto snapshot = graph.snapshot();
+            std::vector<int> victims{0, 63, 64, 65, 69};
+            graph.removeVertices(victims);
+            std::vector<VertexHandle> stale;
+            for (size_t i = vertices.size(); i-- > 0;)
+                if (std::find(victims.begin(), victims.end(), vertices[i]) != victims.end())
+                {
+                    stale.push_back(handles[i]);
+                    vertices.erase(vertices.begin() + static_cast<std::ptrdiff_t>(i));
+                    handles.erase(handles.begin() + static_cast<std::ptrdiff_t>(i));
+                }
+            if (std::string failure = handlesFailure(graph, vertices, handles); !failure.empty())
+                return reportTest("test_staleHandles", "after removeVertices: " + failure);
+            for (VertexHandle handle : stale)
+                if (std::string failure = staleFailure(graph, handle, reused); !failure.empty())
+                    return reportTest("test_staleHandles", "after removeVertices: " + failure);
+
+            // copies share the slot numbering, and keep their own generations.
+            if (!snapshot.isValid(stale[0]) || snapshot.getVertex(stale[0]) != 69 || snapshot.isValid(removed) ||
+                snapshot.getVertex(reused) != 1000)
+                return reportTest("test_staleHandles", "Snapshot does not resolve the handles of its vertices");
+            reportTest("test_staleHandles", "");
+        }
+
+        void test_staleMixedHandles()
+        {
+            MixedGraphMatrix<int, int> graph;
+            graph.addVertices({1, 2, 3});
+            VertexHandle one = graph.handleOf(1), two = graph.handleOf(2), three = graph.handleOf(3);
+            graph.addEdge(one, two, 12, false);
+            graph.addEdge(three, two, 32, true);
+            if (!graph.hasEdge(two, one) || graph.getEdgeValue(two, one) != 12 || graph.indegree(two) != 2 || graph(two, three))
+                return reportTest("test_staleMixedHandles", "Handle queries do not follow the edge directions");
+
+            graph.removeVertex(one);
+            if (graph.getIndexOf(three) != 0 || graph.getEdgeValue(three, two) != 32)
+                return reportTest("test_staleMixedHandles", "Moved vertex lost its handle or edges");
+            if (std::string failure = staleFailure(graph, one, two); !failure.empty())
+                return reportTest("test_staleMixedHandles", failure);
+            reportTest("test_staleMixedHandles", "");
+        }
+
+        void init_tests()
+        {
+            test_tryLookups();
+            test_graphErrors();
+            test_missingVertex();
+            test_staleHandles();
+            test_staleMixedHandles();
+        }
+    };
+}
@@ -0,0 +1,362 @@
+#pragma once
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <map>
+#include <optional>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../include/MixedGraph.hpp"
+#include "../include/MixedGraphSearch.hpp"
+#include "graph_types.hpp"
+
+namespace Appledore
+{
+    // tests for MixedGraphMatrix.
+    class C_TestMixedGraph
+    {
+    public:
+        using Orientation = std::vector<std::pair<size_t, size_t>>;
+
+        // The directed edges of graph plus the oriented undirected ones reach every vertex
+        // from every vertex, and orientation covers each undirected edge exactly once.
+        template <typename Graph>
+        static bool isStrongOrientation(const Graph &graph, const Orientation &orientation)
+        {
+            size_t n = graph.getNumVertices();
+            std::vector<std::vector<bool>> arc(n, std::vector<bool>(n, false));
+            size_t undirectedEdges = 0;
+            for (size_t a = 0; a < n; ++a)
+                for (size_t b = 0; b < n; ++b)
+                {
+                    if (!graph.hasEdgeAt(a, b))
+                        continue;
+                    if (graph.isDirectedAt(a, b))
+                        arc[a][b] = true;
+                    else if (a <= b)
+                        ++undirectedEdges;
+                }
+            for (auto [a, b] : orientation)
+            {
+                if (graph.isDirectedAt(a, b) || arc[a][b])
+                    return false;
+                arc[a][b] = true;
+            }
+            if (orientation.size() != undirectedEdges)
+                return false;
+
+            for (size_t source = 0; source < n; ++source)
+            {
+                std::vector<bool> seen(n, false);
+                std::vector<size_t> stack{source};
+                seen[source] = true;
+                size_t reached = 1;
+                while (!stack.empty())
+                {
+                    size_t v = stack.back();
+                    stack.pop_back();
+                    for (size_t w = 0; w < n; ++w)
+                        if (arc[v][w] && !seen[w])
+                        {
+                            seen[w] = true;
+                            ++reached;
+                            stack.push_back(w);
+                        }
+                }
+                if (reached != n)
+                    return false;
+            }
+            return true;
+        }
+
+        void test_strongOrientation()
+        {
+            // each spoke 0 - v has to point out of v, its only way back is through w: the
+            // orientation of Robbins' proof alone fails here.
+            MixedGraphMatrix<int, int> hub;
+            hub.addVertex(0);
+            for (int i = 0; i < 40; ++i)
+            {
+                int v = 2 * i + 1, w = 2 * i + 2;
+                hub.addVertices({v, w});
+                hub.addEdge(0, v, std::nullopt, false);
+                hub.addEdge(0, w, std::nullopt, true);
+                hub.addEdge(w, v, std::nullopt, true);
+                hub.addEdge(w, 0, std::nullopt, true);
+            }
+            auto orientation = hub.strongOrientation();
+            if (!orientation || !isStrongOrientation(hub, *orientation))
+                return reportTest("test_strongOrientation", "No valid orientation for the hub graph");
+
+            // undirected cycle with backward directed chords, across the 64-bit word boundary.
+            MixedGraphMatrix<int, int> ring;
+            for (int i = 0; i < 70; ++i)
+                ring.addVertex(i);
+            for (int i = 0; i < 70; ++i)
+                ring.addEdge(i, (i + 1) % 70, std::nullopt, false);
+            for (int i = 0; i + 3 < 70; i += 5)
+                ring.addEdge(i + 3, i, std::nullopt, true);
+            orientation = ring.strongOrientation();
+            if (!orientation || !isStrongOrientation(ring, *orientation))
+                return reportTest("test_strongOrientation", "No valid orientation for the ring graph");
+
+            // an undirected bridge, and a graph that is not strongly connected.
+            MixedGraphMatrix<int, int> bridged;
+            bridged.addVertices({1, 2, 3, 4});
+            bridged.addEdge(1, 2, std::nullopt, false);
+            bridged.addEdge(2, 3, std::nullopt, false);
+            bridged.addEdge(3, 1, std::nullopt, false);
+            bridged.addEdge(3, 4, std::nullopt, false);
+            MixedGraphMatrix<int, int> oneWay;
+            oneWay.addVertices({1, 2, 3, 4});
+            oneWay.addEdge(1, 2, std::nullopt, true);
+            oneWay.addEdge(2, 3, std::nullopt, false);
+            oneWay.addEdge(3, 4, std::nullopt, false);
+            oneWay.addEdge(4, 2, std::nullopt, false);
+            if (bridged.strongOrientation() || oneWay.strongOrientation())
+                return reportTest("test_strongOrientation", "Orientation reported for a graph that has none");
+            reportTest("test_strongOrientation", "");
+        }
+
+        // Cell by cell model of the original MixedGraphMatrix, one optional {value,
+        // isDirected} per ordered vertex pair, keyed by vertex so that it does not depend on
+        // the index order after removals.
+        struct BaselineMixed
+        {
+            struct Cell
+            {
+                int value;
+                bool isDirected;
+            };
+            std::vector<int> vertices;
+            std::map<std::pair<int, int>, Cell> cells;
+
+            void addEdge(int src, int dest, int value, bool isDirected)
+            {
+                cells[{src, dest}] = {value, isDirected};
+                if (!isDirected)
+                    cells[{dest, src}] = {value, false};
+            }
+            void removeEdge(int src, int dest)
+            {
+                cells.erase({src, dest});
+                auto reverse = cells.find({dest, src});
+                if (reverse != cells.end() && !reverse->second.isDirected)
+                    cells.erase(reverse);
+            }
+            void updateEdge(int src, int dest, int value)
+            {
+                Cell &cell = cells.at({src, dest});
+                cell.value = value;
+                if (!cell.isDirected)
+                    cells.at({dest, src}).value = value;
+            }
+            void removeVertex(int vertex)
+            {
+                std::erase(vertices, vertex);
+                std::erase_if(cells, [vertex](const auto &entry)
+                              { return entry.first.first == vertex || entry.first.second == vertex; });
+            }
+            size_t outdegree(int v) const
+            {
+                return std::count_if(cells.begin(), cells.end(), [v](const auto &e)
+                                     { return e.first.first == v; });
+            }
+            size_t indegree(int v) const
+            {
+                return std::count_if(cells.begin(), cells.end(), [v](const auto &e)
+                                     { return e.first.second == v; });
+            }
+            size_t totalDegree(int v) const
+            {
+                return outdegree(v) + std::count_if(cells.begin(), cells.end(), [v](const auto &e)
+                                                    { return e.first.second == v && e.second.isDirected; });
+            }
+            std::vector<int> edges() const
+            {
+                std::vector<int> values;
+                for (const auto &[pair, cell] : cells)
+                    if (cell.isDirected || pair.first <= pair.second)
+                        values.push_back(cell.value);
+                std::sort(values.begin(), values.end());
+                return values;
+            }
+        };
+
+        // Empty when graph and model agree on every pair, otherwise what differs.
+        static std::string compare(const MixedGraphMatrix<int, int> &graph, const BaselineMixed &model)
+        {
+            std::vector<int> vertices = graph.getVertices();
+            if (std::set<int>(vertices.begin(), vertices.end()) != std::set<int>(model.vertices.begin(), model.vertices.end()))
+                return "vertex sets differ";
+            for (int src : model.vertices)
+            {
+                if (graph.outdegree(src) != model.outdegree(src) || graph.indegree(src) != model.indegree(src) ||
+                    graph.totalDegree(src) != model.totalDegree(src))
+                    return std::format("degrees of {}: {}/{}/{}, baseline {}/{}/{}", src, graph.outdegree(src), graph.indegree(src),
+                                       graph.totalDegree(src), model.outdegree(src), model.indegree(src), model.totalDegree(src));
+                for (int dest : model.vertices)
+                {
+                    auto cell = model.cells.find({src, dest});
+                    bool present = cell != model.cells.end();
+                    if (graph.hasEdge(src, dest) != present)
+                        return std::format("edge {} -> {} present: {}, baseline {}", src, dest, !present, present);
+                    if (present && (graph.getEdgeValue(src, dest) != cell->second.value ||
+                                    graph.isDirectedAt(graph.getIndexOf(src), graph.getIndexOf(dest)) != cell->second.isDirected))
+                        return std::format("edge {} -> {} differs in value or direction", src, dest);
+                }
+            }
+            std::vector<int> edges = graph.getEdges();
+            std::sort(edges.begin(), edges.end());
+            if (edges != model.edges())
+                return std::format("getEdges returned {} values, baseline {}", edges.size(), model.edges().size());
+            return "";
+        }
+
+        // One edge added undirected and then directed keeps its reverse cell undirected, as
+        // the original per cell layout did.
+        void test_halfUndirected()
+        {
+            MixedGraphMatrix<int, int> graph;
+            BaselineMixed model;
+            graph.addVertices({1, 2, 3});
+            model.vertices = {1, 2, 3};
+            graph.addEdge(1, 2, 12, false);
+            model.addEdge(1, 2, 12, false);
+            graph.addEdge(1, 2, 21, true);
+            model.addEdge(1, 2, 21, true);
+            if (std::string failure = compare(graph, model); !failure.empty())
+                return reportTest("test_halfUndirected", "after adding the directed half: " + failure);
+
+            // the undirected half still carries its value both ways when updated.
+            graph.updateEdge(2, 1, 7);
+            model.updateEdge(2, 1, 7);
+            if (std::string failure = compare(graph, model); !failure.empty())
+                return reportTest("test_halfUndirected", "after updating the undirected half: " + failure);
+
+            // removing the directed half leaves the undirected one, removing that clears both.
+            graph.removeEdge(1, 2);
+            model.removeEdge(1, 2);
+            graph.addEdge(2, 3, 23, true);
+            model.addEdge(2, 3, 23, true);
+            graph.removeEdge(3, 2);
+            model.removeEdge(3, 2);
+            if (std::string failure = compare(graph, model); !failure.empty())
+                return reportTest("test_halfUndirected", "after removals: " + failure);
+            reportTest("test_halfUndirected", "");
+        }
+
+        // Random edits on both sides of the 64 and 128 bit row boundaries, including vertex
+        // removals that move rows and columns across words.
+        void test_matchesBaseline()
+        {
+            MixedGraphMatrix<int, int> graph;
+            BaselineMixed model;
+            for (int v = 0; v < 140; ++v)
+            {
+                graph.addVertex(v);
+                model.vertices.push_back(v);
+            }
+            std::mt19937 rng(40);
+            int nextValue = 1;
+            auto pick = [&]
+            { return model.vertices[rng() % model.vertices.size()]; };
+            for (int step = 0; step < 3000; ++step)
+            {
+                int src = pick(), dest = pick();
+                switch (rng() % 8)
+                {
+                case 0:
+                case 1:
+                case 2:
+                {
+                    bool isDirected = rng() % 3 != 0;
+                    graph.addEdge(src, dest, nextValue, isDirected);
+                    model.addEdge(src, dest, nextValue++, isDirected);
+                    break;
+                }
+                case 3:
+                    graph.removeEdge(src, dest);
+                    model.removeEdge(src, dest);
+                    break;
+                case 4:
+                    if (model.cells.count({src, dest}))
+                    {
+                        graph.updateEdge(src, dest, nextValue);
+                        model.updateEdge(src, dest, nextValue++);
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+            if (std::string failure = compare(graph, model); !failure.empty())
+                return reportTest("test_matchesBaseline", "after edge edits: " + failure);
+
+            // single removals swap the last vertex in, bulk removals compact in order.
+            for (int v : {63, 64, 139, 0})
+            {
+                graph.removeVertex(v);
+                model.removeVertex(v);
+            }
+            if (std::string failure = compare(graph, model); !failure.empty())
+                return reportTest("test_matchesBaseline", "after removeVertex: " + failure);
+            std::vector<int> victims{1, 62, 65, 66, 127, 128, 129};
+            graph.removeVertices(victims);
+            for (int v : victims)
+                model.removeVertex(v);
+            if (std::string failure = compare(graph, model); !failure.empty())
+                return reportTest("test_matchesBaseline", "after removeVertices: " + failure);
+
+            // the matrix grows again past the word boundary it shrank below.
+            for (int v = 200; v < 210; ++v)
+            {
+                graph.addVertex(v);
+                model.vertices.push_back(v);
+                graph.addEdge(v, 2, nextValue, v % 2 == 0);
+                model.addEdge(v, 2, nextValue++, v % 2 == 0);
+            }
+            if (std::string failure = compare(graph, model); !failure.empty())
+                return reportTest("test_matchesBaseline", "after regrowing: " + failure);
+            reportTest("test_matchesBaseline", "");
+        }
+
+        // Paths whose length does not fit in an integral distance are unreachable, shorter
+        // ones next to them are still found.
+        void test_shortestPathOverflow()
+        {
+            const int big = std::numeric_limits<int>::max() - 5;
+            MixedGraphMatrix<int, int> graph;
+            graph.addVertices({0, 1, 2, 3, 4});
+            graph.addEdge(0, 1, big, true);
+            graph.addEdge(1, 2, 10, false);
+            graph.addEdge(0, 3, 6, true);
+            graph.addEdge(3, 2, big, true);
+            graph.addEdge(3, 4, 2, false);
+            MixedGraphSearch<int, int> search(graph);
+            const auto &distances = search.shortestDistances(0);
+            if (distances[1] != big || distances[2] != decltype(search)::unreachable || distances[3] != 6 || distances[4] != 8)
+                return reportTest("test_shortestPathOverflow", std::format("Distances {} {} {} {}", distances[1], distances[2], distances[3], distances[4]));
+            if (search.shortestPath(0, 2) || !search.shortestPath(3, 2) || search.shortestPath(3, 2)->distance != big)
+                return reportTest("test_shortestPathOverflow", "Overflowing path was returned, or a fitting one was not");
+
+            // unsigned distances would wrap around to a short path instead.
+            MixedGraphSearch unsignedSearch(graph, [](const int &value)
+                                            { return value == big ? std::numeric_limits<size_t>::max() - 1 : size_t(value); });
+            if (unsignedSearch.shortestPath(0, 2) || unsignedSearch.shortestDistances(0)[4] != 8)
+                return reportTest("test_shortestPathOverflow", "Unsigned distances wrapped around");
+            reportTest("test_shortestPathOverflow", "");
+        }
+
+        void init_tests()
+        {
+            test_halfUndirected();
+            test_matchesBaseline();
+            test_strongOrientation();
+            test_shortestPathOverflow();
+        }
+    };
+}
@@ -0,0 +1,223 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "../include/GraphSerialization.hpp"
+#include "graph_types.hpp"
+#include "tests_MixedGraph.hpp"
+
+namespace Appledore
+{
+    // tests for the binary graph file format.
+    class C_TestSerialization
+    {
+    public:
+        std::string path = (std::filesystem::temp_directory_path() / "appledore_test_suite.graph").string();
+
+        // Overwrites a header field of the saved file.
+        void patchHeader(size_t offset, uint64_t value)
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(offset);
+            file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+
+        GraphFileHeader readHeader()
+        {
+            GraphFileHeader header{};
+            std::ifstream file(path, std::ios::binary);
+            file.read(reinterpret_cast<char *>(&header), sizeof(header));
+            return header;
+        }
+
+        template <typename View>
+        bool rejects()
+        {
+            try
+            {
+                View view(path);
+            }
+            catch (const std::runtime_error &)
+            {
+                return true;
+            }
+            return false;
+        }
+
+        void test_saveViewLoad()
+        {
+            GraphMatrix<std::string, double, DirectedG> graph;
+            for (int i = 0; i < 70; ++i)
+                graph.addVertex("v" + std::to_string(i));
+            for (int i = 0; i < 70; ++i)
+                graph.addEdge("v" + std::to_string(i), "v" + std::to_string((i * 7 + 3) % 70), i + 0.5);
+            graph.addEdge("v0", "v69", 100.0);
+            saveGraph(graph, path);
+
+            GraphFileView<std::string, double> view(path);
+            if (view.getNumVertices() != 70 || view.getNumEdges() != graph.getAllEdges().size() || !view.isDirected() || view.isMixed())
+                return reportTest("test_saveViewLoad", "View header does not match the saved graph");
+            for (size_t src = 0; src < 70; ++src)
+            {
+                const std::string &vertex = graph.getVertexAt(src);
+                std::set<std::string> neighbors;
+                for (size_t dest : view.getNeighborsAt(src))
+                {
+                    neighbors.insert(view.getVertexAt(dest));
+                    if (view.getEdgeAt(src, dest) != graph.getEdgeAt(src, dest))
+                        return reportTest("test_saveViewLoad", std::format("Edge value differs at ({}, {})", src, dest));
+                }
+                if (view.getVertexAt(src) != vertex || view.getIndexOf(vertex) != src || neighbors != graph.getNeighbors(vertex) ||
+                    view.indegreeAt(src) != graph.indegree(vertex) || view.outdegreeAt(src) != graph.outdegree(vertex))
+                    return reportTest("test_saveViewLoad", std::format("View differs from the graph at vertex {}", src));
+            }
+
+            auto loaded = loadGraph<GraphMatrix<std::string, double, DirectedG>>(path);
+            if (loaded.getVertices() != graph.getVertices() || loaded.getAllEdges().size() != graph.getAllEdges().size() ||
+                loaded.getEdge("v0", "v69") != 100.0 || loaded.getEdge("v9", "v66") != 9.5 || loaded.hasEdge("v69", "v0"))
+                return reportTest("test_saveViewLoad", "Loaded graph differs from the saved graph");
+            reportTest("test_saveViewLoad", "");
+        }
+
+        void test_saveLoadMixed()
+        {
+            MixedGraphMatrix<int, int> graph;
+            graph.addVertices({1, 2, 3, 4});
+            graph.addEdge(1, 2, 12, true);
+            graph.addEdge(2, 3, 23, false);
+            graph.addEdge(4, 1, 41, true);
+            saveGraph(graph, path);
+
+            GraphFileView<int, int> view(path);
+            if (!view.isMixed() || !view.isDirectedAt(0, 1) || view.isDirectedAt(1, 2) || view.isDirectedAt(2, 1) ||
+                view.getEdgeAt(2, 1) != 23 || view.hasEdgeAt(1, 0))
+                return reportTest("test_saveLoadMixed", "View does not keep the edge directions");
+
+            auto loaded = loadGraph<MixedGraphMatrix<int, int>>(path);
+            if (loaded.getEdgeValue(1, 2) != 12 || loaded.getEdgeValue(3, 2) != 23 || loaded.getEdgeValue(4, 1) != 41 || loaded.hasEdge(2, 1) ||
+                !loaded.isDirectedAt(0, 1) || loaded.isDirectedAt(1, 2))
+                return reportTest("test_saveLoadMixed", "Loaded mixed graph differs from the saved graph");
+            // half undirected pairs, the directed half before and after the undirected one.
+            MixedGraphMatrix<int, int> halves;
+            C_TestMixedGraph::BaselineMixed model;
+            halves.addVertices({1, 2, 3, 4});
+            model.vertices = {1, 2, 3, 4};
+            for (auto [src, dest] : {std::pair{1, 2}, std::pair{4, 3}})
+            {
+                halves.addEdge(src, dest, 10 * src + dest, false);
+                model.addEdge(src, dest, 10 * src + dest, false);
+                halves.addEdge(src, dest, 7, true);
+                model.addEdge(src, dest, 7, true);
+            }
+            saveGraph(halves, path);
+            if (std::string failure = C_TestMixedGraph::compare(loadGraph<MixedGraphMatrix<int, int>>(path), model); !failure.empty())
+                return reportTest("test_saveLoadMixed", "Half undirected pairs did not survive: " + failure);
+
+            bool wrongKind = false;
+            try
+            {
+                (void)loadGraph<GraphMatrix<int, int, DirectedG>>(path);
+            }
+            catch (const std::runtime_error &)
+            {
+                wrongKind = true;
+            }
+            if (!wrongKind)
+                return reportTest("test_saveLoadMixed", "Loading a mixed graph file as GraphMatrix did not throw");
+            reportTest("test_saveLoadMixed", "");
+        }
+
+        void test_saveLoadGraphVertex()
+        {
+            GraphMatrix<GraphVertex, UnweightedG, UndirectedG> graph;
+            GraphVertex a("Oslo"), b("Bergen"), c("Tromso");
+            graph.addVertices({a, b, c});
+            graph.addEdge(a, b);
+            graph.addEdge(b, c);
+            saveGraph(graph, path);
+
+            // names are stored, ids are not: the view hands out fresh vertices and finds them by name.
+            GraphFileView<GraphVertex, UnweightedG> view(path);
+            if (view.getVertexAt(2).name() != "Tromso" || view.getVertexAt(2) == c || view.getIndexOf(GraphVertex("Bergen")) != 1)
+                return reportTest("test_saveLoadGraphVertex", "View does not restore vertex names");
+
+            auto loaded = loadGraph<GraphMatrix<GraphVertex, UnweightedG, UndirectedG>>(path);
+            const GraphVertex *oslo = loaded.findByName("Oslo");
+            const GraphVertex *bergen = loaded.findByName("Bergen");
+            const GraphVertex *tromso = loaded.findByName("Tromso");
+            if (!oslo || !bergen || !tromso || !loaded.hasEdge(*bergen, *oslo) || !loaded.hasEdge(*tromso, *bergen) ||
+                loaded.hasEdge(*oslo, *tromso))
+                return reportTest("test_saveLoadGraphVertex", "Loaded graph lost vertex names or edges");
+            reportTest("test_saveLoadGraphVertex", "");
+        }
+
+        void test_rejectCorruptFiles()
+        {
+            using View = GraphFileView<int, int>;
+            GraphMatrix<int, int, DirectedG> graph;
+            for (int i = 0; i < 65; ++i)
+                graph.addVertex(i);
+            graph.addEdge(0, 64, 1);
+            graph.addEdge(64, 0, 2);
+
+            struct Patch
+            {
+                const char *what;
+                size_t offset;
+                uint64_t value;
+            };
+            const Patch patches[] = {
+                {"vertex count", offsetof(GraphFileHeader, vertexCount), 1000},
+                {"edge count", offsetof(GraphFileHeader, edgeCount), 3},
+                {"row width", offsetof(GraphFileHeader, wordsPerRow), 1},
+                {"unaligned offset", offsetof(GraphFileHeader, presenceOffset), 65},
+                {"overlapping sections", offsetof(GraphFileHeader, indexMapOffset), 0},
+                {"offset past the end", offsetof(GraphFileHeader, valuesOffset), uint64_t{1} << 40},
+                {"overflowing blob size", offsetof(GraphFileHeader, vertexBlobSize), ~uint64_t{0}},
+                {"direction bitmap", offsetof(GraphFileHeader, directionOffset), 64},
+            };
+            for (const Patch &patch : patches)
+            {
+                saveGraph(graph, path);
+                patchHeader(patch.offset, patch.value);
+                if (!rejects<View>())
+                    return reportTest("test_rejectCorruptFiles", std::format("Corrupt {} was accepted", patch.what));
+            }
+
+            // tables inside the sections.
+            saveGraph(graph, path);
+            GraphFileHeader header = readHeader();
+            patchHeader(header.indexMapOffset + 8, 65);
+            if (!rejects<View>())
+                return reportTest("test_rejectCorruptFiles", "Out of range index map entry was accepted");
+            saveGraph(graph, path);
+            patchHeader(header.rowOffsetsOffset + 8, 2);
+            if (!rejects<View>())
+                return reportTest("test_rejectCorruptFiles", "Descending row offsets were accepted");
+            saveGraph(graph, path);
+            patchHeader(header.vertexTableOffset + 8 * 65, 0);
+            if (!rejects<View>())
+                return reportTest("test_rejectCorruptFiles", "Vertex offsets not spanning the blob were accepted");
+
+            saveGraph(graph, path);
+            std::filesystem::resize_file(path, header.fileSize - 1);
+            if (!rejects<View>())
+                return reportTest("test_rejectCorruptFiles", "Truncated file was accepted");
+            reportTest("test_rejectCorruptFiles", "");
+        }
+
+        void init_tests()
+        {
+            test_saveViewLoad();
+            test_saveLoadMixed();
+            test_saveLoadGraphVertex();
+            test_rejectCorruptFiles();
+            std::filesystem::remove(path);
+        }
+    };
+}
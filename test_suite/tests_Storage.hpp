@@ -0,0 +1,140 @@
+#pragma once
+#include <format>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../include/GraphMatrix.hpp"
+#include "../include/GraphStorage.hpp"
+#include "graph_types.hpp"
+
+namespace Appledore
+{
+    // tests for the copy-on-write storage policy.
+    class C_TestStorage
+    {
+    public:
+        // 70000 elements need two tree levels of 1024 element blocks.
+        static constexpr size_t largeSize = 70000;
+
+        void test_cowChunkedVector()
+        {
+            CowChunkedVector<int> vector(largeSize);
+            for (size_t i = 0; i < largeSize; i += 7)
+                vector[i] = static_cast<int>(i);
+            CowChunkedVector<int> copy = vector;
+            copy[7] = -1;
+            copy[largeSize - 1] = -2;
+            if (std::as_const(vector)[7] != 7 || std::as_const(vector)[largeSize - 1] != 0 || std::as_const(copy)[14] != 14)
+                return reportTest("test_cowChunkedVector", "Writing a copy changed the original");
+
+            // shrinking resets the dropped elements, regrowing exposes T{} instead of them.
+            vector.resize(10);
+            vector.shrink_to_fit();
+            size_t shrunkCapacity = vector.memoryUsage().capacity;
+            vector.resize(largeSize);
+            for (size_t i = 10; i < largeSize; i += 7)
+                if (std::as_const(vector)[i] != 0)
+                    return reportTest("test_cowChunkedVector", std::format("Stale value at {} after regrowing", i));
+            if (std::as_const(vector)[7] != 7 || shrunkCapacity >= copy.memoryUsage().capacity)
+                return reportTest("test_cowChunkedVector", "shrink_to_fit lost values or kept the dropped blocks");
+            if (std::as_const(copy)[14] != 14 || std::as_const(copy)[69993] != 69993 || std::as_const(copy)[7] != -1)
+                return reportTest("test_cowChunkedVector", "Shrinking the original changed the copy");
+
+            vector[largeSize - 1] = 5;
+            if (std::as_const(vector)[largeSize - 1] != 5 || std::as_const(copy)[largeSize - 1] != -2)
+                return reportTest("test_cowChunkedVector", "Writing after regrowing is not isolated from the copy");
+            reportTest("test_cowChunkedVector", "");
+        }
+
+        // A snapshot keeps its edges and vertices through writes and removeVertex on the
+        // graph, and the graph through writes on the snapshot.
+        template <typename Direction>
+        std::string snapshotFailure()
+        {
+            GraphMatrix<int, int, Direction, CowStorage> graph;
+            for (int i = 0; i < 70; ++i)
+                graph.addVertex(i);
+            for (int i = 0; i < 70; ++i)
+                graph.addEdge(i, (i + 1) % 70, i);
+
+            auto before = graph.snapshot();
+            graph.addEdge(0, 40, 100);
+            graph.updateEdge(5, 6, 500);
+            auto afterWrites = graph.snapshot();
+            graph.removeVertex(0);
+            graph.removeVertex(65);
+
+            if (before.hasEdge(0, 40) || before.getEdge(5, 6) != 5 || before.getVertices().size() != 70 || !before.hasEdge(69, 0))
+                return "snapshot changed after writes";
+            if (!afterWrites.hasEdge(0, 40) || afterWrites.getEdge(5, 6) != 500 || afterWrites.getEdge(64, 65) != 64 ||
+                afterWrites.getVertices().size() != 70)
+                return "snapshot changed after removeVertex";
+            if (graph.getVertices().size() != 68 || graph.getEdge(5, 6) != 500 || graph.getEdge(66, 67) != 66 ||
+                graph.hasEdge(64, 66) || graph.getEdge(40, 41) != 40)
+                return "graph is wrong after removeVertex";
+
+            before.addEdge(10, 30, 1030);
+            if (graph.hasEdge(10, 30) || afterWrites.hasEdge(10, 30))
+                return "writing a snapshot changed the graph";
+            return "";
+        }
+
+        void test_snapshotIsolation()
+        {
+            if (std::string failure = snapshotFailure<DirectedG>(); !failure.empty())
+                return reportTest("test_snapshotIsolation", "directed: " + failure);
+            if (std::string failure = snapshotFailure<UndirectedG>(); !failure.empty())
+                return reportTest("test_snapshotIsolation", "undirected: " + failure);
+            reportTest("test_snapshotIsolation", "");
+        }
+
+        // a Cow graph shrunk below a block and grown again matches a dense one.
+        void test_shrinkRegrow()
+        {
+            GraphMatrix<int, int, DirectedG, CowStorage> graph;
+            GraphMatrix<int, int, DirectedG> dense;
+            for (int i = 0; i < 300; ++i)
+            {
+                graph.addVertex(i);
+                dense.addVertex(i);
+            }
+            for (int i = 0; i < 300; ++i)
+            {
+                graph.addEdge(i, (i * 13) % 300, i);
+                dense.addEdge(i, (i * 13) % 300, i);
+            }
+            auto snapshot = graph.snapshot();
+            std::vector<int> victims;
+            for (int i = 20; i < 300; ++i)
+                victims.push_back(i);
+            graph.removeVertices(victims);
+            dense.removeVertices(victims);
+            graph.shrinkToFit();
+            for (int i = 300; i < 340; ++i)
+            {
+                graph.addVertex(i);
+                dense.addVertex(i);
+                graph.addEdge(i, i % 20, i);
+                dense.addEdge(i, i % 20, i);
+            }
+            std::vector<int> vertices = dense.getVertices();
+            if (graph.getVertices() != vertices)
+                return reportTest("test_shrinkRegrow", "Vertex lists differ after regrowing");
+            for (int src : vertices)
+                for (int dest : vertices)
+                    if (graph.hasEdge(src, dest) != dense.hasEdge(src, dest) ||
+                        (dense.hasEdge(src, dest) && graph.getEdge(src, dest) != dense.getEdge(src, dest)))
+                        return reportTest("test_shrinkRegrow", std::format("Edge {} -> {} differs from the dense graph", src, dest));
+            if (snapshot.getVertices().size() != 300 || snapshot.getEdge(299, (299 * 13) % 300) != 299)
+                return reportTest("test_shrinkRegrow", "Snapshot changed after shrinking the graph");
+            reportTest("test_shrinkRegrow", "");
+        }
+
+        void init_tests()
+        {
+            test_cowChunkedVector();
+            test_snapshotIsolation();
+            test_shrinkRegrow();
+        }
+    };
+}